@@ -0,0 +1,135 @@
+// Pipelined execBatch and COPY against the same inserts sent one round trip at a time
+//
+// Usage: batch_bench [--runs <n>] [--sizes <n,n,...>]
+//
+// Every variant inserts the same rows into a temporary table inside one transaction: the
+// serial one with an execCommand per row (prepared statements, one round trip each), the
+// pipelined one with a single execBatch and the copy one with copyIn (COPY FROM STDIN).
+// Needs a reachable database (DB_* variables); run it against a remote server as well,
+// since the gap grows with network latency.
+
+#include "common/config/config.h"
+#include "common/database/postgresql_database.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using rdws::database::PostgreSQLDatabase;
+
+namespace {
+
+constexpr auto insertCommand = "INSERT INTO batch_bench (id, name, amount) VALUES ($1, $2, $3)";
+
+struct Batch {
+    std::vector<std::string> commands;
+    std::vector<std::vector<std::string>> parameterSets;
+};
+
+Batch makeBatch(const size_t rows) {
+    Batch batch;
+    for (size_t i = 0; i < rows; ++i) {
+        batch.commands.emplace_back(insertCommand);
+        batch.parameterSets.push_back(
+            {std::to_string(i), "customer " + std::to_string(i), std::to_string(i * 1.5)});
+    }
+    return batch;
+}
+
+bool runSerial(PostgreSQLDatabase& db, const Batch& batch) {
+    db.beginTransaction();
+    for (size_t i = 0; i < batch.commands.size(); ++i) {
+        if (!db.execCommand(batch.commands[i], batch.parameterSets[i])) {
+            db.rollbackTransaction();
+            return false;
+        }
+    }
+    db.commitTransaction();
+    return true;
+}
+
+bool runPipelined(PostgreSQLDatabase& db, const Batch& batch) {
+    return db.execBatch(batch.commands, batch.parameterSets);
+}
+
+bool runCopy(PostgreSQLDatabase& db, const Batch& batch) {
+    return db.copyIn("batch_bench", {"id", "name", "amount"}, batch.parameterSets);
+}
+
+template <typename Variant>
+void benchmark(PostgreSQLDatabase& db, const char* name, const size_t rows, const size_t runs,
+               const Variant& variant) {
+    const Batch batch = makeBatch(rows);
+    std::vector<double> millis;
+
+    for (size_t i = 0; i < runs; ++i) {
+        db.execCommand("TRUNCATE batch_bench");
+        const auto started = std::chrono::steady_clock::now();
+        if (!variant(db, batch)) {
+            std::cerr << name << ": batch failed: " << db.getLastError() << std::endl;
+            return;
+        }
+        millis.push_back(
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started)
+                .count());
+    }
+
+    std::sort(millis.begin(), millis.end());
+    const double p50 = millis[millis.size() / 2];
+    const double p99 = millis[static_cast<size_t>(0.99 * static_cast<double>(millis.size() - 1))];
+    std::printf("%-10s %6zu rows   p50 %9.3f ms  p99 %9.3f ms   %10.0f rows/s\n", name, rows, p50,
+                p99, static_cast<double>(rows) / (p50 / 1000.0));
+}
+
+const char* optionValue(const int argc, char* argv[], const char* flag) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], flag) == 0) {
+            return argv[i + 1];
+        }
+    }
+    return nullptr;
+}
+
+std::vector<size_t> parseSizes(const std::string& value) {
+    std::vector<size_t> sizes;
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        sizes.push_back(std::stoul(item));
+    }
+    return sizes;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* runsValue = optionValue(argc, argv, "--runs");
+    const char* sizesValue = optionValue(argc, argv, "--sizes");
+    const size_t runs = runsValue != nullptr ? std::max<size_t>(std::stoul(runsValue), 1) : 20;
+    const auto sizes = parseSizes(sizesValue != nullptr ? sizesValue : "1,10,1000");
+
+    try {
+        PostgreSQLDatabase db{rdws::Config()};
+        // Session-local, so the benchmark never touches the service tables
+        if (!db.execCommand("CREATE TEMP TABLE batch_bench "
+                            "(id integer, name text, amount numeric(10, 2))")) {
+            std::cerr << "Cannot create the benchmark table: " << db.getLastError() << std::endl;
+            return 1;
+        }
+
+        for (const size_t rows : sizes) {
+            benchmark(db, "serial", rows, runs, runSerial);
+            benchmark(db, "pipelined", rows, runs, runPipelined);
+            benchmark(db, "copy", rows, runs, runCopy);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,213 @@
+// Compares the epoll and io_uring StreamServer backends on the same HTTP request mix
+//
+// Usage: http_backend_bench [--connections <n>] [--requests <n>] [--backend epoll|io_uring|both]
+//
+// Every client thread keeps one keep-alive connection and sends its requests one at a
+// time, so the numbers reflect per-request latency rather than pipelining. The handler
+// does no work, leaving the socket path as the only cost. Run under `strace -c -f` to
+// compare syscall counts.
+
+#include "server/http_server.h"
+#include "server/request_executor.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using rdws::server::HttpServer;
+using rdws::server::IoBackend;
+using rdws::server::StreamServer;
+
+namespace {
+
+// Small JSON bodies, sized like the users/orders responses
+class FixedResponseHandler : public rdws::server::RequestHandler {
+  public:
+    rdws::server::HandlerResponse handle(rdws::types::LambdaEvent& event,
+                                         const rdws::types::LambdaContext&) override {
+        if (event.isPost()) {
+            return {R"({"success":true,"message":"Order created","data":{"id":1}})", 0, 201};
+        }
+        if (event.getPath() == "/users") {
+            return {std::string(2048, 'u'), 0, 200};
+        }
+        return {R"({"success":true,"data":{"id":1,"name":"Ana","email":"ana@example.com"}})",
+                0, 200};
+    }
+};
+
+const std::vector<std::string>& requestMix() {
+    static const std::string order =
+        R"({"user_id":1,"product_name":"Keyboard","quantity":2,"total_price":199.90})";
+    static const std::vector<std::string> mix = {
+        "GET /users/1 HTTP/1.1\r\nHost: bench\r\n\r\n",
+        "GET /users HTTP/1.1\r\nHost: bench\r\n\r\n",
+        "POST /orders HTTP/1.1\r\nHost: bench\r\nContent-Type: application/json\r\n"
+        "Content-Length: " +
+            std::to_string(order.size()) + "\r\n\r\n" + order,
+    };
+    return mix;
+}
+
+// Read one response; false when the connection failed
+bool readResponse(const int fd, std::string& buffer) {
+    char chunk[16 * 1024];
+    while (true) {
+        if (const auto headerEnd = buffer.find("\r\n\r\n"); headerEnd != std::string::npos) {
+            size_t contentLength = 0;
+            if (const auto field = buffer.find("Content-Length: ");
+                field != std::string::npos && field < headerEnd) {
+                contentLength = std::stoul(buffer.substr(field + 16));
+            }
+            if (buffer.size() >= headerEnd + 4 + contentLength) {
+                buffer.erase(0, headerEnd + 4 + contentLength);
+                return true;
+            }
+        }
+        const ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (received <= 0) {
+            return false;
+        }
+        buffer.append(chunk, static_cast<size_t>(received));
+    }
+}
+
+int connectTo(const uint16_t port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    const int enable = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    return fd;
+}
+
+uint16_t boundPort(const int listeningSocket) {
+    sockaddr_in address{};
+    socklen_t length = sizeof(address);
+    getsockname(listeningSocket, reinterpret_cast<sockaddr*>(&address), &length);
+    return ntohs(address.sin_port);
+}
+
+void runClient(const uint16_t port, const size_t requests, std::vector<double>& latencies) {
+    const int fd = connectTo(port);
+    if (fd < 0) {
+        return;
+    }
+
+    const auto& mix = requestMix();
+    std::string buffer;
+    latencies.reserve(requests);
+    for (size_t i = 0; i < requests; ++i) {
+        const std::string& request = mix[i % mix.size()];
+        const auto started = std::chrono::steady_clock::now();
+        if (::send(fd, request.data(), request.size(), MSG_NOSIGNAL) !=
+                static_cast<ssize_t>(request.size()) ||
+            !readResponse(fd, buffer)) {
+            break;
+        }
+        latencies.push_back(std::chrono::duration<double, std::micro>(
+                                std::chrono::steady_clock::now() - started)
+                                .count());
+    }
+    ::close(fd);
+}
+
+void benchmark(const IoBackend backend, const size_t connections, const size_t requests) {
+    const char* name = backend == IoBackend::IoUring ? "io_uring" : "epoll";
+
+    rdws::server::InlineExecutor executor(std::make_unique<FixedResponseHandler>());
+    const int listeningSocket = StreamServer::listenTcp("127.0.0.1", 0);
+    const uint16_t port = boundPort(listeningSocket);
+    HttpServer server(listeningSocket, executor, "http_backend_bench", backend);
+    std::thread loop([&server] { server.run(); });
+
+    std::vector<std::vector<double>> perClient(connections);
+    const auto started = std::chrono::steady_clock::now();
+    {
+        std::vector<std::thread> clients;
+        for (size_t i = 0; i < connections; ++i) {
+            clients.emplace_back(runClient, port, requests, std::ref(perClient[i]));
+        }
+        for (auto& client : clients) {
+            client.join();
+        }
+    }
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    server.stop();
+    loop.join();
+
+    std::vector<double> latencies;
+    for (const auto& client : perClient) {
+        latencies.insert(latencies.end(), client.begin(), client.end());
+    }
+    if (latencies.empty()) {
+        std::cerr << name << ": no request completed" << std::endl;
+        return;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&latencies](const double p) {
+        return latencies[static_cast<size_t>(p * static_cast<double>(latencies.size() - 1))];
+    };
+
+    std::printf("%-9s %9zu requests %8.2f s %11.0f req/s   p50 %7.1f us   p99 %7.1f us\n", name,
+                latencies.size(), seconds, static_cast<double>(latencies.size()) / seconds,
+                percentile(0.50), percentile(0.99));
+}
+
+const char* optionValue(const int argc, char* argv[], const char* flag) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], flag) == 0) {
+            return argv[i + 1];
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* connectionsValue = optionValue(argc, argv, "--connections");
+    const char* requestsValue = optionValue(argc, argv, "--requests");
+    const char* backendValue = optionValue(argc, argv, "--backend");
+
+    const size_t connections = connectionsValue != nullptr ? std::stoul(connectionsValue) : 32;
+    const size_t requests = requestsValue != nullptr ? std::stoul(requestsValue) : 5000;
+    const std::string backend = backendValue != nullptr ? backendValue : "both";
+
+    try {
+        if (backend == "epoll" || backend == "both") {
+            benchmark(IoBackend::Epoll, connections, requests);
+        }
+        if (backend == "io_uring" || backend == "both") {
+            if (!StreamServer::ioUringAvailable()) {
+                std::cerr << "io_uring: not available (build with -DRDWS_ENABLE_IO_URING=ON)"
+                          << std::endl;
+                return backend == "both" ? 0 : 1;
+            }
+            benchmark(IoBackend::IoUring, connections, requests);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
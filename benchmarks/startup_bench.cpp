@@ -0,0 +1,215 @@
+// Exec-to-first-byte latency of the service binaries in exec-per-request mode
+//
+// Usage: startup_bench [--runs <n>] [--users <path>] [--orders <path>] [--profile]
+//
+// Spawns each binary the way the gateway does (event and context JSON as arguments, the
+// parent's environment inherited) and times from just before posix_spawn to the first byte
+// on its stdout, and to its exit. The requests need a reachable database (DB_* variables).
+// --profile sets RDWS_STARTUP_PROFILE=1 and prints the last run's phase breakdown.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <iostream>
+#include <spawn.h>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+extern char** environ;
+
+namespace {
+
+struct Target {
+    const char* name;
+    std::string path;
+    std::string event;
+};
+
+struct Run {
+    double firstByteMs = 0;
+    double exitMs = 0;
+    bool succeeded = false;
+    std::string profile;
+};
+
+constexpr auto contextJson =
+    R"({"requestId":"startup-bench","functionName":"startup-bench","functionVersion":"1.0",)"
+    R"("timeout":30000,"memoryLimitMB":128})";
+
+std::string countEvent(const std::string& resource) {
+    return R"({"httpMethod":"GET","path":"/)" + resource + R"(/count","resource":"/)" + resource +
+           R"(/{id}","headers":{},"queryStringParameters":{},"pathParameters":{"id":"count"},)"
+           R"("body":"","isBase64Encoded":false})";
+}
+
+long long monotonicNanos() {
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<long long>(now.tv_sec) * 1'000'000'000LL + now.tv_nsec;
+}
+
+double millisSince(const std::chrono::steady_clock::time_point started) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started)
+        .count();
+}
+
+// Last "Startup profile:" line written to stderr
+std::string profileLine(const std::string& log) {
+    const auto marker = log.rfind("Startup profile: ");
+    if (marker == std::string::npos) {
+        return "";
+    }
+    const auto end = log.find('\n', marker);
+    return log.substr(marker, end == std::string::npos ? std::string::npos : end - marker);
+}
+
+Run spawnOnce(const Target& target, const bool profile) {
+    Run run;
+    int output[2];
+    int errors[2];
+    if (pipe2(output, O_CLOEXEC) != 0 || pipe2(errors, O_CLOEXEC) != 0) {
+        return run;
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, output[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, errors[1], STDERR_FILENO);
+
+    std::vector<std::string> environment;
+    for (char** variable = environ; *variable != nullptr; ++variable) {
+        environment.emplace_back(*variable);
+    }
+    if (profile) {
+        environment.emplace_back("RDWS_STARTUP_PROFILE=1");
+    }
+    const auto started = std::chrono::steady_clock::now();
+    environment.push_back("RDWS_EXEC_START_NS=" + std::to_string(monotonicNanos()));
+    std::vector<char*> envp;
+    for (auto& variable : environment) {
+        envp.push_back(variable.data());
+    }
+    envp.push_back(nullptr);
+
+    std::string event = target.event;
+    std::string context = contextJson;
+    std::string path = target.path;
+    char* argv[] = {path.data(), event.data(), context.data(), nullptr};
+
+    pid_t child = 0;
+    const int spawned = posix_spawn(&child, path.c_str(), &actions, nullptr, argv, envp.data());
+    posix_spawn_file_actions_destroy(&actions);
+    ::close(output[1]);
+    ::close(errors[1]);
+    if (spawned != 0) {
+        std::cerr << target.name << ": cannot spawn " << path << ": " << std::strerror(spawned)
+                  << std::endl;
+        ::close(output[0]);
+        ::close(errors[0]);
+        return run;
+    }
+
+    char chunk[4096];
+    bool sawFirstByte = false;
+    ssize_t received = 0;
+    while ((received = ::read(output[0], chunk, sizeof(chunk))) > 0) {
+        if (!sawFirstByte) {
+            run.firstByteMs = millisSince(started);
+            sawFirstByte = true;
+        }
+    }
+    std::string log;
+    while ((received = ::read(errors[0], chunk, sizeof(chunk))) > 0) {
+        log.append(chunk, static_cast<size_t>(received));
+    }
+    ::close(output[0]);
+    ::close(errors[0]);
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    run.exitMs = millisSince(started);
+    run.succeeded = sawFirstByte && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    run.profile = profileLine(log);
+    return run;
+}
+
+void benchmark(const Target& target, const size_t runs, const bool profile) {
+    std::vector<double> firstByte;
+    std::vector<double> exited;
+    size_t failures = 0;
+    std::string lastProfile;
+
+    for (size_t i = 0; i < runs; ++i) {
+        const Run run = spawnOnce(target, profile);
+        if (!run.succeeded) {
+            ++failures;
+            continue;
+        }
+        firstByte.push_back(run.firstByteMs);
+        exited.push_back(run.exitMs);
+        lastProfile = run.profile;
+    }
+
+    if (firstByte.empty()) {
+        std::cerr << target.name << ": no run succeeded (is the database reachable?)"
+                  << std::endl;
+        return;
+    }
+    const auto percentile = [](std::vector<double>& values, const double p) {
+        std::sort(values.begin(), values.end());
+        return values[static_cast<size_t>(p * static_cast<double>(values.size() - 1))];
+    };
+
+    std::printf("%-15s %5zu runs %3zu failed   first byte p50 %7.2f ms  p99 %7.2f ms   "
+                "exit p50 %7.2f ms\n",
+                target.name, firstByte.size(), failures, percentile(firstByte, 0.50),
+                percentile(firstByte, 0.99), percentile(exited, 0.50));
+    if (profile && !lastProfile.empty()) {
+        std::printf("%-15s %s\n", "", lastProfile.c_str());
+    }
+}
+
+const char* optionValue(const int argc, char* argv[], const char* flag) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], flag) == 0) {
+            return argv[i + 1];
+        }
+    }
+    return nullptr;
+}
+
+bool hasFlag(const int argc, char* argv[], const char* flag) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], flag) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* runsValue = optionValue(argc, argv, "--runs");
+    const char* usersValue = optionValue(argc, argv, "--users");
+    const char* ordersValue = optionValue(argc, argv, "--orders");
+
+    const size_t runs = runsValue != nullptr ? std::stoul(runsValue) : 50;
+    const bool profile = hasFlag(argc, argv, "--profile");
+
+    const std::vector<Target> targets = {
+        {"users_service", usersValue != nullptr ? usersValue : RDWS_USERS_SERVICE_PATH,
+         countEvent("users")},
+        {"orders_service", ordersValue != nullptr ? ordersValue : RDWS_ORDERS_SERVICE_PATH,
+         countEvent("orders")},
+    };
+    for (const auto& target : targets) {
+        benchmark(target, runs, profile);
+    }
+    return 0;
+}
@@ -17,6 +17,7 @@ import { promisify } from 'util';
 import cors from 'cors';
 import helmet from 'helmet';
 import morgan from 'morgan';
+import { ServiceSocketClient } from './service-socket-client';
 
 // Import modular routes and types
 import {
@@ -66,8 +67,67 @@ const config: Config = {
   buildPath: process.env.BUILD_PATH || './build',
   environment: process.env.NODE_ENV || 'development',
   timeout: parseInt(process.env.SERVICE_TIMEOUT || '5000'),
+  // 'socket' talks to services started with --socket <socketDir>/<service>.sock
+  transport: process.env.SERVICE_TRANSPORT === 'socket' ? 'socket' : 'exec',
+  socketDir: process.env.SERVICE_SOCKET_DIR || '/tmp/rdws',
+  // Single socket for every service, e.g. the combined rdws_server
+  socketPath: process.env.SERVICE_SOCKET_PATH,
 };
 
+// Kept between the service's deadline and the gateway's timeout for process start and transport
+const DEADLINE_MARGIN_MS = 250;
+
+/**
+ * Budget handed to a service as its context timeoutMs: the gateway's own timeout less a margin,
+ * so the service gives up and cancels its statements before the gateway stops waiting
+ */
+function serviceTimeoutMs(timeout: number): number {
+  return timeout - Math.min(DEADLINE_MARGIN_MS, Math.floor(timeout / 10));
+}
+
+// One multiplexed connection per socket path when using the socket transport
+const socketClients = new Map<string, ServiceSocketClient>();
+
+function getSocketClient(serviceName: string): ServiceSocketClient {
+  const socketPath = config.socketPath || `${config.socketDir}/${serviceName}.sock`;
+  let client = socketClients.get(socketPath);
+  if (!client) {
+    client = new ServiceSocketClient(socketPath);
+    socketClients.set(socketPath, client);
+  }
+  return client;
+}
+
+/**
+ * Run the service executable once with the Event/Context JSON as arguments
+ */
+async function execMicroservice(
+  serviceName: string,
+  lambdaEvent: object,
+  lambdaContext: object,
+  requestId: string
+): Promise<string> {
+  // Serialize to JSON
+  const eventJson = JSON.stringify(lambdaEvent);
+  const contextJson = JSON.stringify(lambdaContext);
+
+  const servicePath = `${config.buildPath}/src/services/${serviceName}/${serviceName}_service`;
+  const command = `"${servicePath}" '${eventJson}' '${contextJson}'`;
+
+  // Execute with inherited environment variables
+  const { stdout, stderr } = await execAsync(command, {
+    timeout: config.timeout,
+    encoding: 'utf8',
+    // env: process.env <- This is the default, environment is automatically inherited
+  });
+
+  if (stderr) {
+    console.warn(`[${requestId}] ${serviceName} stderr:`, stderr);
+  }
+
+  return stdout;
+}
+
 // Initialize Express app
 const app: Application = express();
 
@@ -100,32 +160,29 @@ async function callMicroservice(
   try {
     // Create AWS Lambda-like Event and Context objects
     const lambdaEvent = createLambdaEvent(req, requestId, pathParameters);
-    const lambdaContext = createLambdaContext(requestId, serviceName);
-
-    // Serialize to JSON
-    const eventJson = JSON.stringify(lambdaEvent);
-    const contextJson = JSON.stringify(lambdaContext);
-
-    const servicePath = `${config.buildPath}/src/services/${serviceName}/${serviceName}_service`;
-    const command = `"${servicePath}" '${eventJson}' '${contextJson}'`;
+    const lambdaContext = createLambdaContext(
+      requestId,
+      serviceName,
+      '1.0',
+      serviceTimeoutMs(config.timeout)
+    );
 
-    console.log(`[${requestId}] Calling: ${serviceName} with Event/Context JSON`);
+    console.log(`[${requestId}] Calling: ${serviceName} with Event/Context JSON (${config.transport})`);
     console.log(`[${requestId}] Event: ${req.method} ${req.path}`);
     console.log(`[${requestId}] Context: ${lambdaContext.functionName} v${lambdaContext.functionVersion}`);
     console.log(
       `[${requestId}] Environment inherited: DB_HOST=${process.env.DB_HOST}, DB_NAME=${process.env.DB_NAME}`
     );
 
-    // Execute with inherited environment variables
-    const { stdout, stderr } = await execAsync(command, {
-      timeout: config.timeout,
-      encoding: 'utf8',
-      // env: process.env <- This is the default, environment is automatically inherited
-    });
-
-    if (stderr) {
-      console.warn(`[${requestId}] ${serviceName} stderr:`, stderr);
-    }
+    const stdout =
+      config.transport === 'socket'
+        ? (
+            await getSocketClient(serviceName).call(
+              { event: lambdaEvent, context: lambdaContext },
+              config.timeout
+            )
+          ).body
+        : await execMicroservice(serviceName, lambdaEvent, lambdaContext, requestId);
 
     const duration = Date.now() - startTime;
     console.log(`[${requestId}] ${serviceName} completed in ${duration}ms`);
@@ -151,8 +208,17 @@ async function callMicroservice(
       throw new Error(`Service ${serviceName} timed out after ${config.timeout}ms`);
     }
 
+    if (error.message.includes('timed out')) {
+      throw new Error(`Service ${serviceName} timed out after ${config.timeout}ms`);
+    }
+
     if (error.code === 'ENOENT') {
-      throw new Error(`Service ${serviceName} executable not found`);
+      const target = config.transport === 'socket' ? 'socket' : 'executable';
+      throw new Error(`Service ${serviceName} ${target} not found`);
+    }
+
+    if (error.code === 'ECONNREFUSED') {
+      throw new Error(`Service ${serviceName} is not accepting connections`);
     }
 
     if (error.message.includes('JSON')) {
@@ -225,6 +291,7 @@ app.get('/health', async (req: Request, res: Response) => {
       environment: config.environment,
       buildPath: config.buildPath,
       timeout: config.timeout,
+      transport: config.transport,
     },
     services: {},
   };
@@ -234,15 +301,15 @@ app.get('/health', async (req: Request, res: Response) => {
     new Set(microserviceRouters.map(router => router.routeConfig.serviceName))
   );
 
-  // Test each service
+  // Ask each service for its own /health: database circuit breakers included
   for (const service of uniqueServices) {
     try {
       const startTime = Date.now();
       // Create a mock request for health check
       const mockReq = {
         method: 'GET',
-        path: `/${service}`,
-        route: { path: `/${service}` },
+        path: '/health',
+        route: { path: '/health' },
         body: null,
         headers: {},
         query: {},
@@ -251,11 +318,16 @@ app.get('/health', async (req: Request, res: Response) => {
         get: () => 'HealthCheck/1.0',
       } as any;
 
-      await callMicroservice(service, mockReq);
+      const result = await callMicroservice(service, mockReq);
+      const available = result.data?.status === 'ok';
       healthData.services[service] = {
-        status: 'healthy',
+        status: available ? 'healthy' : 'unhealthy',
         responseTime: Date.now() - startTime,
+        databases: result.data?.databases,
       };
+      if (!available) {
+        healthData.status = 'degraded';
+      }
     } catch (error) {
       healthData.services[service] = {
         status: 'unhealthy',
@@ -348,6 +420,10 @@ function startServer() {
     console.log(`Environment: ${config.environment}`);
     console.log(`Build path: ${config.buildPath}`);
     console.log(`Service timeout: ${config.timeout}ms`);
+    console.log(
+      `Service transport: ${config.transport}` +
+        (config.transport === 'socket' ? ` (${config.socketPath || config.socketDir})` : '')
+    );
     console.log('');
     console.log('Available endpoints:');
     console.log(`   GET  http://localhost:${config.port}/health`);
@@ -370,6 +446,7 @@ function startServer() {
   // Graceful shutdown
   process.on('SIGTERM', () => {
     console.log('SIGTERM received, shutting down gracefully...');
+    socketClients.forEach(client => client.close());
     server.close(() => {
       console.log('Server closed');
       process.exit(0);
@@ -378,6 +455,7 @@ function startServer() {
 
   process.on('SIGINT', () => {
     console.log('SIGINT received, shutting down gracefully...');
+    socketClients.forEach(client => client.close());
     server.close(() => {
       console.log('Server closed');
       process.exit(0);
@@ -393,4 +471,4 @@ if (require.main === module) {
 }
 
 // Export for testing
-export { app, startServer, callMicroservice };
+export { app, startServer, callMicroservice, serviceTimeoutMs };
@@ -0,0 +1,146 @@
+/**
+ * Unix Domain Socket RPC client for C++ microservices
+ *
+ * Talks to a service started with `<service> --socket <path>`. Every frame is a
+ * 12-byte big-endian header (payload length, request ID, status) followed by the
+ * JSON payload. Requests are multiplexed on one connection and matched to their
+ * responses by request ID, so many calls can be in flight at once.
+ */
+
+import { Socket, createConnection } from 'net';
+
+const HEADER_SIZE = 12;
+const MAX_PAYLOAD_LENGTH = 16 * 1024 * 1024;
+const MAX_REQUEST_ID = 0xffffffff;
+
+export interface SocketCallResult {
+  statusCode: number;
+  body: string;
+}
+
+interface PendingCall {
+  resolve: (result: SocketCallResult) => void;
+  reject: (error: Error) => void;
+  timer: NodeJS.Timeout;
+}
+
+export class ServiceSocketClient {
+  private socket: Socket | null = null;
+  private connecting: Promise<Socket> | null = null;
+  private buffer: Buffer = Buffer.alloc(0);
+  private nextRequestId = 1;
+  private readonly pending = new Map<number, PendingCall>();
+
+  constructor(private readonly socketPath: string) {}
+
+  /**
+   * Send one {event, context} payload and wait for its response
+   */
+  async call(payload: object, timeoutMs: number): Promise<SocketCallResult> {
+    const socket = await this.connect();
+    const requestId = this.allocateRequestId();
+    const body = Buffer.from(JSON.stringify(payload), 'utf8');
+
+    if (body.length > MAX_PAYLOAD_LENGTH) {
+      throw new Error(`Request payload too large (${body.length} bytes)`);
+    }
+
+    const header = Buffer.alloc(HEADER_SIZE);
+    header.writeUInt32BE(body.length, 0);
+    header.writeUInt32BE(requestId, 4);
+    header.writeUInt32BE(0, 8);
+
+    return new Promise<SocketCallResult>((resolve, reject) => {
+      const timer = setTimeout(() => {
+        this.pending.delete(requestId);
+        reject(new Error(`Request ${requestId} timed out after ${timeoutMs}ms`));
+      }, timeoutMs);
+
+      this.pending.set(requestId, { resolve, reject, timer });
+      socket.write(Buffer.concat([header, body]));
+    });
+  }
+
+  /**
+   * Close the connection and fail every in-flight call
+   */
+  close(): void {
+    this.socket?.destroy();
+    this.failPending(new Error('Connection closed'));
+    this.socket = null;
+  }
+
+  private allocateRequestId(): number {
+    const requestId = this.nextRequestId;
+    this.nextRequestId = requestId >= MAX_REQUEST_ID ? 1 : requestId + 1;
+    return requestId;
+  }
+
+  private connect(): Promise<Socket> {
+    if (this.socket) {
+      return Promise.resolve(this.socket);
+    }
+    if (this.connecting) {
+      return this.connecting;
+    }
+
+    this.connecting = new Promise<Socket>((resolve, reject) => {
+      const socket = createConnection(this.socketPath);
+
+      socket.once('connect', () => {
+        this.socket = socket;
+        this.connecting = null;
+        resolve(socket);
+      });
+
+      socket.on('data', (chunk: Buffer) => this.onData(chunk));
+
+      socket.on('error', (error: Error) => {
+        if (this.connecting) {
+          this.connecting = null;
+          reject(error);
+        }
+        this.failPending(error);
+      });
+
+      socket.on('close', () => {
+        this.socket = null;
+        this.buffer = Buffer.alloc(0);
+        this.failPending(new Error('Connection closed'));
+      });
+    });
+
+    return this.connecting;
+  }
+
+  private onData(chunk: Buffer): void {
+    this.buffer = this.buffer.length === 0 ? chunk : Buffer.concat([this.buffer, chunk]);
+
+    while (this.buffer.length >= HEADER_SIZE) {
+      const payloadLength = this.buffer.readUInt32BE(0);
+      if (this.buffer.length < HEADER_SIZE + payloadLength) {
+        return;
+      }
+
+      const requestId = this.buffer.readUInt32BE(4);
+      const statusCode = this.buffer.readUInt32BE(8);
+      const body = this.buffer.toString('utf8', HEADER_SIZE, HEADER_SIZE + payloadLength);
+      this.buffer = this.buffer.subarray(HEADER_SIZE + payloadLength);
+
+      const call = this.pending.get(requestId);
+      if (call) {
+        this.pending.delete(requestId);
+        clearTimeout(call.timer);
+        call.resolve({ statusCode, body });
+      }
+    }
+  }
+
+  private failPending(error: Error): void {
+    this.pending.forEach(call => {
+      clearTimeout(call.timer);
+      call.reject(error);
+    });
+    this.pending.clear();
+  }
+}
@@ -7,7 +7,7 @@
  */
 
 import request from 'supertest';
-import { app } from '../api-gateway';
+import { app, serviceTimeoutMs } from '../api-gateway';
 import * as childProcess from 'child_process';
 
 // Mock the child_process module to intercept microservice calls
@@ -21,6 +21,24 @@ interface ApiResponse {
 }
 
 // Mock data for different microservices
+const mockHealthResponse = {
+  success: true,
+  statusCode: 200,
+  data: {
+    status: 'ok',
+    databases: [
+      {
+        target: 'localhost:5432/rdws',
+        circuit: 'closed',
+        consecutiveFailures: 0,
+        rejected: 0,
+        retryInMs: 0,
+        lastError: '',
+      },
+    ],
+  },
+};
+
 const mockUsersResponse = {
   users: [
     { id: 1, name: 'John Doe', email: 'john@example.com' },
@@ -89,7 +107,9 @@ describe('API Gateway', () => {
           const path = lambdaEvent.path;
 
           // Route based on service and path
-          if (serviceName === 'users') {
+          if (httpMethod === 'GET' && path === '/health') {
+            mockData = mockHealthResponse;
+          } else if (serviceName === 'users') {
             if (httpMethod === 'GET' && (path === '/' || path === '/users')) {
               mockData = mockUsersResponse;
             } else if (httpMethod === 'GET' && (path === '/1' || path === '/users/1')) {
@@ -178,6 +198,31 @@ describe('API Gateway', () => {
       expect(response.body.services.users).toHaveProperty('error');
       expect(response.body.services.users.error).toContain('Service unavailable');
     });
+
+    test('GET /health passes through an open database circuit', async () => {
+      mockExec.mockImplementation((command: string, options: any, callback?: any) => {
+        if (typeof options === 'function') {
+          callback = options;
+        }
+        const database = { ...mockHealthResponse.data.databases[0], circuit: 'open', rejected: 3 };
+        const stdout = JSON.stringify({
+          ...mockHealthResponse,
+          statusCode: 503,
+          data: { status: 'unavailable', databases: [database] },
+        });
+        setTimeout(() => callback(null, { stdout, stderr: '' }), 10);
+        return {} as any;
+      });
+
+      const response: ApiResponse = await request(app)
+        .get('/health')
+        .expect(503)
+        .expect('Content-Type', /json/);
+
+      expect(response.body).toHaveProperty('status', 'degraded');
+      expect(response.body.services.orders).toHaveProperty('status', 'unhealthy');
+      expect(response.body.services.orders.databases[0]).toHaveProperty('circuit', 'open');
+    });
   });
 
   describe('API Documentation', () => {
@@ -528,6 +573,42 @@ describe('API Gateway', () => {
     });
   });
 
+  describe('Service deadline', () => {
+    test('keeps a margin below the gateway timeout', () => {
+      expect(serviceTimeoutMs(5000)).toBe(4750);
+      // Short timeouts keep nine tenths of the budget
+      expect(serviceTimeoutMs(1000)).toBe(900);
+    });
+
+    test('socket transport forwards the same deadline', async () => {
+      const call = jest.fn().mockResolvedValue({
+        statusCode: 200,
+        body: JSON.stringify(mockUsersResponse),
+      });
+      const previousTransport = process.env.SERVICE_TRANSPORT;
+      let socketApp: any;
+      jest.isolateModules(() => {
+        process.env.SERVICE_TRANSPORT = 'socket';
+        jest.doMock('../service-socket-client', () => ({
+          ServiceSocketClient: jest.fn().mockImplementation(() => ({ call, close: jest.fn() })),
+        }));
+        socketApp = require('../api-gateway').app;
+      });
+      if (previousTransport === undefined) {
+        delete process.env.SERVICE_TRANSPORT;
+      } else {
+        process.env.SERVICE_TRANSPORT = previousTransport;
+      }
+
+      await request(socketApp).get('/users').expect(200);
+
+      expect(mockExec).not.toHaveBeenCalled();
+      const [payload, timeout] = call.mock.calls[0];
+      expect(payload.context.timeoutMs).toBe(serviceTimeoutMs(timeout));
+      expect(payload.context.timeoutMs).toBeLessThan(timeout);
+    });
+  });
+
   describe('Microservice Mock Behavior', () => {
     test('Mock verifies exec call parameters', async () => {
       // This should return 404 because ID 123 is not in our mock data (Service not found)
@@ -563,6 +644,22 @@ describe('API Gateway', () => {
       }
     });
 
+    test('Mock receives the gateway timeout less a margin as the context deadline', async () => {
+      await request(app).get('/users').expect(200);
+
+      const calls = mockExec.mock.calls;
+      const [command, options] = calls[calls.length - 1] as [string, any];
+      const jsonMatches = command.match(/'(\{.*?\})'/g);
+      expect(jsonMatches).toBeTruthy();
+
+      if (jsonMatches) {
+        const lambdaContext = JSON.parse(jsonMatches[1].slice(1, -1));
+        // The service must give up before exec kills it at options.timeout
+        expect(lambdaContext.timeoutMs).toBe(serviceTimeoutMs(options.timeout));
+        expect(lambdaContext.timeoutMs).toBeLessThan(options.timeout);
+      }
+    });
+
     test('Mock can simulate different response times', async () => {
       // Mock slow response by adding delay
       mockExec.mockImplementation((command: string, options: any, callback?: any) => {
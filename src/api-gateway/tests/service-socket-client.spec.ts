@@ -0,0 +1,115 @@
+/**
+ * Service Socket Client Tests
+ *
+ * Runs the client against an in-process Unix socket server that speaks the
+ * same length-prefixed framing as the C++ RpcServer.
+ */
+
+import { createServer, Server, Socket } from 'net';
+import { tmpdir } from 'os';
+import { join } from 'path';
+import { ServiceSocketClient } from '../service-socket-client';
+
+const HEADER_SIZE = 12;
+
+function frame(requestId: number, status: number, payload: string): Buffer {
+  const body = Buffer.from(payload, 'utf8');
+  const header = Buffer.alloc(HEADER_SIZE);
+  header.writeUInt32BE(body.length, 0);
+  header.writeUInt32BE(requestId, 4);
+  header.writeUInt32BE(status, 8);
+  return Buffer.concat([header, body]);
+}
+
+// Collects request frames and lets each test decide when and how to answer
+function startServer(
+  socketPath: string,
+  onRequest: (socket: Socket, requestId: number, payload: any) => void
+): Promise<Server> {
+  const server = createServer(socket => {
+    let buffer = Buffer.alloc(0);
+    socket.on('data', chunk => {
+      buffer = Buffer.concat([buffer, chunk]);
+      while (buffer.length >= HEADER_SIZE) {
+        const length = buffer.readUInt32BE(0);
+        if (buffer.length < HEADER_SIZE + length) {
+          return;
+        }
+        const requestId = buffer.readUInt32BE(4);
+        const payload = JSON.parse(buffer.toString('utf8', HEADER_SIZE, HEADER_SIZE + length));
+        buffer = buffer.subarray(HEADER_SIZE + length);
+        onRequest(socket, requestId, payload);
+      }
+    });
+  });
+
+  return new Promise(resolve => server.listen(socketPath, () => resolve(server)));
+}
+
+describe('ServiceSocketClient', () => {
+  let socketPath: string;
+  let server: Server | null = null;
+  let client: ServiceSocketClient | null = null;
+
+  beforeEach(() => {
+    socketPath = join(tmpdir(), `rdws-client-${process.pid}-${Date.now()}.sock`);
+  });
+
+  afterEach(async () => {
+    client?.close();
+    client = null;
+    if (server) {
+      await new Promise(resolve => server!.close(resolve));
+      server = null;
+    }
+  });
+
+  it('matches out-of-order responses to their requests', async () => {
+    const received: Array<{ socket: Socket; requestId: number; path: string }> = [];
+    server = await startServer(socketPath, (socket, requestId, payload) => {
+      received.push({ socket, requestId, path: payload.event.path });
+      if (received.length === 2) {
+        // Answer in reverse order
+        [...received].reverse().forEach(r => {
+          r.socket.write(frame(r.requestId, 200, JSON.stringify({ path: r.path })));
+        });
+      }
+    });
+
+    client = new ServiceSocketClient(socketPath);
+    const [users, orders] = await Promise.all([
+      client.call({ event: { path: '/users' }, context: {} }, 1000),
+      client.call({ event: { path: '/orders' }, context: {} }, 1000),
+    ]);
+
+    expect(JSON.parse(users.body).path).toBe('/users');
+    expect(JSON.parse(orders.body).path).toBe('/orders');
+    expect(users.statusCode).toBe(200);
+  });
+
+  it('passes the status code through', async () => {
+    server = await startServer(socketPath, (socket, requestId) => {
+      socket.write(frame(requestId, 404, '{"success":false}'));
+    });
+
+    client = new ServiceSocketClient(socketPath);
+    const result = await client.call({ event: {}, context: {} }, 1000);
+
+    expect(result.statusCode).toBe(404);
+    expect(result.body).toBe('{"success":false}');
+  });
+
+  it('rejects calls that are not answered in time', async () => {
+    server = await startServer(socketPath, () => undefined);
+
+    client = new ServiceSocketClient(socketPath);
+    await expect(client.call({ event: {}, context: {} }, 50)).rejects.toThrow('timed out');
+  });
+
+  it('rejects when the socket does not exist', async () => {
+    client = new ServiceSocketClient(socketPath);
+    await expect(client.call({ event: {}, context: {} }, 1000)).rejects.toMatchObject({
+      code: 'ENOENT',
+    });
+  });
+});
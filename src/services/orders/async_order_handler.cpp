@@ -0,0 +1,73 @@
+#include "async_order_handler.h"
+
+#include "controllers/order_controller.h"
+#include "order_routes.h"
+
+#include <utility>
+
+using rdws::async::Task;
+using rdws::controllers::OrderController;
+using rdws::server::HandlerResponse;
+
+namespace rdws::services::orders {
+
+AsyncOrderRequestHandler::AsyncOrderRequestHandler(
+    std::shared_ptr<rdws::async::AsyncPostgreSQLDatabase> db)
+    : orderService(std::move(db)) {}
+
+Task<HandlerResponse> AsyncOrderRequestHandler::handle(rdws::types::LambdaEvent& event,
+                                                       const rdws::types::LambdaContext& context) {
+    const auto route = routeOrderRequest(event, context);
+
+    switch (route.action) {
+    case OrderRoute::Action::List: {
+        // Written to JSON as the rows arrive, like the synchronous listing
+        rdws::utils::JsonListWriter orders;
+        const auto result = co_await orderService.forEachOrder(
+            [&orders](const rdws::types::OrderView& order) { orders.add(order); });
+        co_return HandlerResponse{OrderController::formatOrdersListing(result, orders),
+                                  result.isSuccess() ? 0 : 1, result.getStatusCode()};
+    }
+    case OrderRoute::Action::Page: {
+        const auto result = co_await orderService.getOrdersPage(route.limit, route.offset);
+        co_return HandlerResponse{
+            OrderController::formatOrdersPageResponse(result, route.limit, route.offset),
+            result.isSuccess() ? 0 : 1, result.getStatusCode()};
+    }
+    case OrderRoute::Action::Count: {
+        const auto result = co_await orderService.getOrderCount();
+        co_return HandlerResponse{OrderController::formatCountResponse(result),
+                                  result.isSuccess() ? 0 : 1, result.getStatusCode()};
+    }
+    case OrderRoute::Action::Get: {
+        const auto result = co_await orderService.getOrderById(route.id);
+        co_return HandlerResponse{OrderController::formatOrderResponse(result),
+                                  result.isSuccess() ? 0 : 1, result.getStatusCode()};
+    }
+    case OrderRoute::Action::ByUser: {
+        const auto result = co_await orderService.getOrdersByUserId(route.id);
+        co_return HandlerResponse{OrderController::formatOrdersResponse(result),
+                                  result.isSuccess() ? 0 : 1, result.getStatusCode()};
+    }
+    case OrderRoute::Action::Create: {
+        const auto result = co_await orderService.createOrder(event.getBody());
+        co_return HandlerResponse{OrderController::formatOrderResponse(result),
+                                  result.isSuccess() ? 0 : 1, result.getStatusCode()};
+    }
+    case OrderRoute::Action::Update: {
+        const auto result = co_await orderService.updateOrder(route.id, event.getBody());
+        co_return HandlerResponse{OrderController::formatOrderResponse(result),
+                                  result.isSuccess() ? 0 : 1, result.getStatusCode()};
+    }
+    case OrderRoute::Action::Delete: {
+        const auto result = co_await orderService.deleteOrder(route.id);
+        co_return HandlerResponse{OrderController::formatOperationResponse(result),
+                                  result.isSuccess() ? 0 : 1, operationStatusCode(result)};
+    }
+    case OrderRoute::Action::Rejected:
+        break;
+    }
+    co_return route.rejection;
+}
+
+} // namespace rdws::services::orders
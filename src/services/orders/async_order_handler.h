@@ -0,0 +1,28 @@
+#pragma once
+
+#include "async/async_executor.h"
+#include "async_order_service.h"
+
+#include <memory>
+
+namespace rdws::services::orders {
+
+/**
+ * Coroutine request handler for order routes
+ * Same routes and responses as OrderRequestHandler, backed by AsyncOrderService
+ */
+class AsyncOrderRequestHandler : public rdws::async::AsyncRequestHandler {
+  private:
+    AsyncOrderService orderService;
+
+  public:
+    /**
+     * @param db Connections used by the underlying AsyncOrderService
+     */
+    explicit AsyncOrderRequestHandler(std::shared_ptr<rdws::async::AsyncPostgreSQLDatabase> db);
+
+    rdws::async::Task<rdws::server::HandlerResponse>
+    handle(rdws::types::LambdaEvent& event, const rdws::types::LambdaContext& context) override;
+};
+
+} // namespace rdws::services::orders
@@ -0,0 +1,209 @@
+#include "async_order_service.h"
+
+#include "order_service.h"
+
+#include <iostream>
+#include <utility>
+#include <vector>
+
+using rdws::async::Task;
+using rdws::types::Order;
+using rdws::types::ServiceResult;
+
+namespace rdws::services::orders {
+
+namespace {
+
+// Parameters are built before co_await: GCC 12 rejects braced lists inside the await operand
+std::vector<std::string> idParameter(const int id) {
+    return {std::to_string(id)};
+}
+
+std::vector<Order> mapOrders(rdws::database::IResultSet& result) {
+    std::vector<Order> orders;
+    OrderRepository::OrderMapper mapper;
+    while (result.next()) {
+        orders.push_back(mapper.read(result));
+    }
+    return orders;
+}
+
+} // namespace
+
+AsyncOrderService::AsyncOrderService(
+    std::shared_ptr<rdws::async::AsyncPostgreSQLDatabase> database)
+    : db(std::move(database)) {}
+
+Task<rdws::types::CountResult> AsyncOrderService::forEachOrder(
+    std::function<void(const rdws::types::OrderView&)> onOrder) const {
+    try {
+        size_t count = 0;
+        rdws::database::RowMapper<rdws::types::OrderView> mapper;
+        co_await db->stream(OrderRepository::findAllQuery, {},
+                            [&onOrder, &count, &mapper](rdws::database::IResultSet& row) {
+                                onOrder(mapper.read(row));
+                                ++count;
+                            });
+        co_return rdws::types::CountResult::success(count);
+    } catch (const std::exception& e) {
+        std::cerr << "Error in forEachOrder: " << e.what() << std::endl;
+        co_return rdws::types::CountResult::error("Failed to retrieve orders: " +
+                                                  std::string(e.what()));
+    }
+}
+
+Task<rdws::types::OrderResult> AsyncOrderService::getOrderById(const int orderId) const {
+    try {
+        if (orderId <= 0) {
+            co_return ServiceResult<Order>::error("Invalid order ID");
+        }
+
+        const auto result =
+            co_await db->query(OrderRepository::findByIdQuery, idParameter(orderId));
+        if (!result->next()) {
+            co_return ServiceResult<Order>::error("Order not found");
+        }
+        co_return ServiceResult<Order>::success(OrderRepository::OrderMapper().read(*result));
+    } catch (const std::exception& e) {
+        std::cerr << "Error in getOrderById: " << e.what() << std::endl;
+        co_return ServiceResult<Order>::error("Failed to retrieve order: " +
+                                              std::string(e.what()));
+    }
+}
+
+Task<rdws::types::OrdersResult> AsyncOrderService::getOrdersByUserId(const int userId) const {
+    try {
+        if (userId <= 0) {
+            co_return ServiceResult<std::vector<Order>>::error("Invalid user ID");
+        }
+
+        const auto result =
+            co_await db->query(OrderRepository::findByUserIdQuery, idParameter(userId));
+        co_return ServiceResult<std::vector<Order>>::success(mapOrders(*result));
+    } catch (const std::exception& e) {
+        std::cerr << "Error in getOrdersByUserId: " << e.what() << std::endl;
+        co_return ServiceResult<std::vector<Order>>::error(
+            "Failed to retrieve orders for user: " + std::string(e.what()));
+    }
+}
+
+Task<rdws::types::OrderPageResult> AsyncOrderService::getOrdersPage(const int limit,
+                                                                   const int offset) const {
+    try {
+        if (limit <= 0 || limit > OrderService::maxPageSize || offset < 0) {
+            co_return rdws::types::OrderPageResult::error("Invalid page bounds", 400);
+        }
+
+        std::vector<std::string> parameters{std::to_string(limit), std::to_string(offset)};
+        auto pageQuery = db->query(OrderRepository::findPageQuery, std::move(parameters));
+        auto countQuery = db->query(OrderRepository::countQuery);
+        // The page and the count are independent, so they run on two connections at once
+        co_await db->whenAll(pageQuery, countQuery);
+        const auto rows = co_await pageQuery;
+        const auto total = co_await countQuery;
+
+        rdws::types::OrderPage page;
+        page.orders = mapOrders(*rows);
+        if (total->next()) {
+            page.total = static_cast<size_t>(total->getInt("total"));
+        }
+        co_return rdws::types::OrderPageResult::success(std::move(page));
+    } catch (const std::exception& e) {
+        std::cerr << "Error in getOrdersPage: " << e.what() << std::endl;
+        co_return rdws::types::OrderPageResult::error("Failed to retrieve orders: " +
+                                                      std::string(e.what()));
+    }
+}
+
+Task<rdws::types::OrderResult> AsyncOrderService::createOrder(const std::string jsonData) const {
+    try {
+        const auto parsed = OrderService::parseNewOrder(jsonData);
+        if (parsed.isError()) {
+            co_return parsed;
+        }
+
+        const Order& order = parsed.getData();
+        std::vector<std::string> parameters{std::to_string(order.userId), order.product,
+                                            std::to_string(order.amount), order.status};
+        const auto result =
+            co_await db->query(OrderRepository::insertQuery, std::move(parameters));
+        if (!result->next()) {
+            co_return ServiceResult<Order>::error("Failed to create order in database");
+        }
+        co_return ServiceResult<Order>::success(OrderRepository::OrderMapper().read(*result));
+    } catch (const std::exception& e) {
+        std::cerr << "Error in createOrder: " << e.what() << std::endl;
+        co_return ServiceResult<Order>::error("Failed to create order: " + std::string(e.what()));
+    }
+}
+
+Task<rdws::types::OrderResult> AsyncOrderService::updateOrder(const int orderId,
+                                                              const std::string jsonData) const {
+    try {
+        if (orderId <= 0) {
+            co_return ServiceResult<Order>::error("Invalid order ID");
+        }
+
+        const auto update = OrderService::parseOrderUpdate(jsonData);
+        if (update.isError()) {
+            co_return ServiceResult<Order>::error(update.getErrorMessage(),
+                                                  update.getStatusCode());
+        }
+
+        const auto existing =
+            co_await db->query(OrderRepository::findByIdQuery, idParameter(orderId));
+        if (!existing->next()) {
+            co_return ServiceResult<Order>::error("Order not found");
+        }
+
+        Order updatedOrder = OrderRepository::OrderMapper().read(*existing);
+        update.getData().applyTo(updatedOrder);
+
+        std::vector<std::string> parameters{
+            std::to_string(updatedOrder.userId), updatedOrder.product,
+            std::to_string(updatedOrder.amount), updatedOrder.status,
+            std::to_string(updatedOrder.id)};
+        const auto result =
+            co_await db->query(OrderRepository::updateQuery, std::move(parameters));
+        if (!result->next()) {
+            co_return ServiceResult<Order>::error("Failed to update order in database");
+        }
+        co_return ServiceResult<Order>::success(OrderRepository::OrderMapper().read(*result));
+    } catch (const std::exception& e) {
+        std::cerr << "Error in updateOrder: " << e.what() << std::endl;
+        co_return ServiceResult<Order>::error("Failed to update order: " + std::string(e.what()));
+    }
+}
+
+Task<rdws::types::OperationResult> AsyncOrderService::deleteOrder(const int orderId) const {
+    try {
+        if (orderId <= 0) {
+            co_return ServiceResult<rdws::types::OperationStatus>::error("Invalid order ID");
+        }
+
+        if (!co_await db->command(OrderRepository::deleteQuery, idParameter(orderId))) {
+            co_return ServiceResult<rdws::types::OperationStatus>::error(
+                "Failed to delete order");
+        }
+        co_return ServiceResult<rdws::types::OperationStatus>::success(
+            rdws::types::OperationStatus::createSuccess("Order deleted successfully"));
+    } catch (const std::exception& e) {
+        std::cerr << "Error in deleteOrder: " << e.what() << std::endl;
+        co_return ServiceResult<rdws::types::OperationStatus>::error("Failed to delete order: " +
+                                                                     std::string(e.what()));
+    }
+}
+
+Task<rdws::types::CountResult> AsyncOrderService::getOrderCount() const {
+    try {
+        const auto result = co_await db->query(OrderRepository::countQuery);
+        const int count = result->next() ? result->getInt("total") : 0;
+        co_return ServiceResult<size_t>::success(static_cast<size_t>(count));
+    } catch (const std::exception& e) {
+        std::cerr << "Error in getOrderCount: " << e.what() << std::endl;
+        co_return ServiceResult<size_t>::error("Failed to get order count: " +
+                                               std::string(e.what()));
+    }
+}
+
+} // namespace rdws::services::orders
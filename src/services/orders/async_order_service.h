@@ -0,0 +1,43 @@
+#pragma once
+
+#include "async/async_database.h"
+#include "async/task.h"
+#include "types/order.h"
+#include "types/service_result.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace rdws::services::orders {
+
+/**
+ * Coroutine variant of OrderService on non-blocking database connections
+ * Results match OrderService; methods suspend while their queries are in flight.
+ */
+class AsyncOrderService {
+  private:
+    std::shared_ptr<rdws::async::AsyncPostgreSQLDatabase> db;
+
+  public:
+    /**
+     * @param database Connections shared by every request on the loop thread
+     */
+    explicit AsyncOrderService(std::shared_ptr<rdws::async::AsyncPostgreSQLDatabase> database);
+
+    /**
+     * OrderService::forEachOrder: every order as views into the rows as they arrive
+     */
+    rdws::async::Task<rdws::types::CountResult>
+    forEachOrder(std::function<void(const rdws::types::OrderView&)> onOrder) const;
+    rdws::async::Task<rdws::types::OrderResult> getOrderById(int orderId) const;
+    rdws::async::Task<rdws::types::OrderPageResult> getOrdersPage(int limit, int offset) const;
+    rdws::async::Task<rdws::types::OrdersResult> getOrdersByUserId(int userId) const;
+    rdws::async::Task<rdws::types::OrderResult> createOrder(std::string jsonData) const;
+    rdws::async::Task<rdws::types::OrderResult> updateOrder(int orderId,
+                                                            std::string jsonData) const;
+    rdws::async::Task<rdws::types::OperationResult> deleteOrder(int orderId) const;
+    rdws::async::Task<rdws::types::CountResult> getOrderCount() const;
+};
+
+} // namespace rdws::services::orders
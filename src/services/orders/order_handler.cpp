@@ -0,0 +1,74 @@
+#include "order_handler.h"
+
+#include "controllers/order_controller.h"
+#include "order_routes.h"
+
+#include <utility>
+
+using rdws::controllers::OrderController;
+using rdws::server::HandlerResponse;
+
+namespace rdws::services::orders {
+
+OrderRequestHandler::OrderRequestHandler(std::shared_ptr<rdws::database::IDatabase> db)
+    : orderService(std::move(db)) {}
+
+void OrderRequestHandler::warmUp() {
+    orderService.warmUp();
+}
+
+HandlerResponse OrderRequestHandler::handle(rdws::types::LambdaEvent& event,
+                                            const rdws::types::LambdaContext& context) {
+    const auto route = routeOrderRequest(event, context);
+
+    switch (route.action) {
+    case OrderRoute::Action::List: {
+        // Written to JSON straight from the streamed rows
+        rdws::utils::JsonListWriter orders;
+        const auto result = orderService.forEachOrder(
+            [&orders](const rdws::types::OrderView& order) { orders.add(order); });
+        return {OrderController::formatOrdersListing(result, orders),
+                result.isSuccess() ? 0 : 1, result.getStatusCode()};
+    }
+    case OrderRoute::Action::Page: {
+        const auto result = orderService.getOrdersPage(route.limit, route.offset);
+        return {OrderController::formatOrdersPageResponse(result, route.limit, route.offset),
+                result.isSuccess() ? 0 : 1, result.getStatusCode()};
+    }
+    case OrderRoute::Action::Count: {
+        const auto result = orderService.getOrderCount();
+        return {OrderController::formatCountResponse(result), result.isSuccess() ? 0 : 1,
+                result.getStatusCode()};
+    }
+    case OrderRoute::Action::Get: {
+        const auto result = orderService.getOrderById(route.id);
+        return {OrderController::formatOrderResponse(result), result.isSuccess() ? 0 : 1,
+                result.getStatusCode()};
+    }
+    case OrderRoute::Action::ByUser: {
+        const auto result = orderService.getOrdersByUserId(route.id);
+        return {OrderController::formatOrdersResponse(result), result.isSuccess() ? 0 : 1,
+                result.getStatusCode()};
+    }
+    case OrderRoute::Action::Create: {
+        const auto result = orderService.createOrder(event.getBody());
+        return {OrderController::formatOrderResponse(result), result.isSuccess() ? 0 : 1,
+                result.getStatusCode()};
+    }
+    case OrderRoute::Action::Update: {
+        const auto result = orderService.updateOrder(route.id, event.getBody());
+        return {OrderController::formatOrderResponse(result), result.isSuccess() ? 0 : 1,
+                result.getStatusCode()};
+    }
+    case OrderRoute::Action::Delete: {
+        const auto result = orderService.deleteOrder(route.id);
+        return {OrderController::formatOperationResponse(result), result.isSuccess() ? 0 : 1,
+                operationStatusCode(result)};
+    }
+    case OrderRoute::Action::Rejected:
+        break;
+    }
+    return route.rejection;
+}
+
+} // namespace rdws::services::orders
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "common/database/idatabase.h"
+#include "order_service.h"
+#include "server/request_handler.h"
+
+#include <memory>
+
+namespace rdws::services::orders {
+
+/**
+ * Request handler for order routes
+ * Maps /orders and /users/{userId}/orders requests to OrderService calls
+ */
+class OrderRequestHandler : public rdws::server::RequestHandler {
+  private:
+    OrderService orderService;
+
+  public:
+    /**
+     * Constructor with dependency injection
+     * @param db Database interface used by the underlying OrderService
+     */
+    explicit OrderRequestHandler(std::shared_ptr<rdws::database::IDatabase> db);
+
+    /**
+     * Route a request to the matching OrderService operation
+     * @param event Request event
+     * @param context Runtime context of the request
+     * @return Formatted JSON response and exit code
+     */
+    rdws::server::HandlerResponse handle(rdws::types::LambdaEvent& event,
+                                         const rdws::types::LambdaContext& context) override;
+
+    /**
+     * Warm up the underlying OrderService
+     */
+    void warmUp() override;
+};
+
+} // namespace rdws::services::orders
@@ -0,0 +1,135 @@
+#include "order_routes.h"
+
+#include "controllers/order_controller.h"
+
+#include <string>
+#include <utility>
+
+using rdws::controllers::OrderController;
+using rdws::server::HandlerResponse;
+
+namespace rdws::services::orders {
+
+namespace {
+
+// std::stoi without the exception, which the async handler must not carry across co_await
+bool parseId(const std::string& value, int& id) {
+    try {
+        id = std::stoi(value);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+OrderRoute accept(const OrderRoute::Action action, const int id = 0) {
+    OrderRoute route;
+    route.action = action;
+    route.id = id;
+    return route;
+}
+
+OrderRoute reject(HandlerResponse response) {
+    OrderRoute route;
+    route.rejection = std::move(response);
+    return route;
+}
+
+} // namespace
+
+OrderRoute routeOrderRequest(rdws::types::LambdaEvent& event,
+                             const rdws::types::LambdaContext& context) {
+    using Action = OrderRoute::Action;
+
+    // Extract path parameters for routes like /orders/{id} or /users/{userId}/orders
+    if (event.pathMatches("/orders/{id}") || event.pathMatches("/orders/{action}")) {
+        event.extractPathParameters("/orders/{id}");
+    } else if (event.pathMatches("/users/{userId}/orders")) {
+        event.extractPathParameters("/users/{userId}/orders");
+    }
+
+    context.log("Processing " + event.getHttpMethod() + " request to " + event.getPath(), "INFO");
+
+    const bool collection = event.pathMatches("/orders") || event.pathMatches("/");
+    const bool member = event.pathMatches("/orders/{id}");
+
+    if (event.isGet() && collection) {
+        // One page with the total count when ?limit= is given
+        if (const std::string limitParam = event.getQueryParameter("limit");
+            !limitParam.empty()) {
+            const std::string offsetParam = event.getQueryParameter("offset");
+            auto route = accept(Action::Page);
+            if (!parseId(limitParam, route.limit) ||
+                (!offsetParam.empty() && !parseId(offsetParam, route.offset))) {
+                context.log("Invalid page bounds: " + limitParam + ", " + offsetParam, "ERROR");
+                return reject({OrderController::formatError("Invalid page bounds", 400), 1, 400});
+            }
+            context.log("Fetching a page of orders", "INFO");
+            return route;
+        }
+
+        context.log("Fetching all orders", "INFO");
+        return accept(Action::List);
+    }
+    if (event.isGet() && event.pathMatches("/users/{userId}/orders")) {
+        const std::string userIdParam = event.getPathParameter("userId");
+        int userId = 0;
+        if (!parseId(userIdParam, userId)) {
+            context.log("Invalid user ID: " + userIdParam, "ERROR");
+            return reject({OrderController::formatError("Invalid user ID", 400), 1, 400});
+        }
+        context.log("Fetching orders for user ID: " + std::to_string(userId), "INFO");
+        return accept(Action::ByUser, userId);
+    }
+    if (event.isPost() && collection) {
+        if (event.getBody().empty()) {
+            context.log("No JSON data provided for order creation", "ERROR");
+            return reject({OrderController::formatNoDataProvidedError("order creation"), 1, 400});
+        }
+        context.log("Creating new order", "INFO");
+        return accept(Action::Create);
+    }
+
+    if (member && (event.isGet() || event.isPut() || event.isDelete())) {
+        const std::string idParam = event.getPathParameter("id");
+
+        if (event.isGet() && idParam == "count") {
+            context.log("Getting order count", "INFO");
+            return accept(Action::Count);
+        }
+
+        int orderId = 0;
+        if (!parseId(idParam, orderId)) {
+            context.log("Invalid order ID: " + idParam, "ERROR");
+            return reject({OrderController::formatError("Invalid order ID", 400), 1, 400});
+        }
+
+        if (event.isGet()) {
+            context.log("Fetching order with ID: " + std::to_string(orderId), "INFO");
+            return accept(Action::Get, orderId);
+        }
+        if (event.isPut()) {
+            if (event.getBody().empty()) {
+                context.log("No JSON data provided for order update", "ERROR");
+                return reject(
+                    {OrderController::formatNoDataProvidedError("order update"), 1, 400});
+            }
+            context.log("Updating order with ID: " + std::to_string(orderId), "INFO");
+            return accept(Action::Update, orderId);
+        }
+        context.log("Deleting order with ID: " + std::to_string(orderId), "INFO");
+        return accept(Action::Delete, orderId);
+    }
+
+    // Method not supported
+    context.log("Method not allowed: " + event.getHttpMethod() + " " + event.getPath(), "WARN");
+    return reject({OrderController::formatMethodNotAllowedError(event.getHttpMethod(),
+                                                                event.getPath()),
+                   1, 405});
+}
+
+int operationStatusCode(const rdws::types::OperationResult& result) {
+    return result.isSuccess() ? result.getData().statusCode : result.getStatusCode();
+}
+
+} // namespace rdws::services::orders
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "server/request_handler.h"
+#include "types/lambda_context.h"
+#include "types/lambda_event.h"
+#include "types/service_result.h"
+
+namespace rdws::services::orders {
+
+/**
+ * The OrderService call an /orders or /users/{userId}/orders request asks for
+ */
+struct OrderRoute {
+    enum class Action { List, Page, Count, Get, ByUser, Create, Update, Delete, Rejected };
+
+    Action action = Action::Rejected;
+    int id = 0;      // Order ID for Get, Update and Delete; user ID for ByUser
+    int limit = 0;   // Page
+    int offset = 0;  // Page
+    rdws::server::HandlerResponse rejection;  // Rejected: bad ID, no body or unknown route
+};
+
+/**
+ * Resolve the route of a request, extracting its path parameters and logging it
+ *
+ * Shared by OrderRequestHandler and AsyncOrderRequestHandler, so both answer the same
+ * requests and reject the others with the same responses. Never throws for bad input.
+ * @param event Request event; its path parameters are filled in
+ * @param context Runtime context the request is logged to
+ */
+OrderRoute routeOrderRequest(rdws::types::LambdaEvent& event,
+                             const rdws::types::LambdaContext& context);
+
+/**
+ * HTTP status carried by an operation result (delete reports errors inside the status)
+ */
+int operationStatusCode(const rdws::types::OperationResult& result);
+
+} // namespace rdws::services::orders
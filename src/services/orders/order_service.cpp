@@ -23,6 +23,22 @@ rdws::types::OrdersResult OrderService::getAllOrders() {
     }
 }
 
+rdws::types::CountResult OrderService::forEachOrder(
+    const std::function<void(const rdws::types::OrderView&)>& onOrder) {
+    try {
+        size_t count = 0;
+        orderRepository.findAllViews([&onOrder, &count](const rdws::types::OrderView& order) {
+            onOrder(order);
+            ++count;
+        });
+        return rdws::types::CountResult::success(count);
+    } catch (const std::exception& e) {
+        std::cerr << "Error in forEachOrder: " << e.what() << std::endl;
+        return rdws::types::CountResult::error("Failed to retrieve orders: " +
+                                               std::string(e.what()));
+    }
+}
+
 rdws::types::OrderResult OrderService::getOrderById(int orderId) {
     try {
         if (orderId <= 0) {
@@ -43,6 +59,20 @@ rdws::types::OrderResult OrderService::getOrderById(int orderId) {
     }
 }
 
+rdws::types::OrderPageResult OrderService::getOrdersPage(const int limit, const int offset) {
+    try {
+        if (limit <= 0 || limit > maxPageSize || offset < 0) {
+            return rdws::types::OrderPageResult::error("Invalid page bounds", 400);
+        }
+
+        return rdws::types::OrderPageResult::success(orderRepository.findPage(limit, offset));
+    } catch (const std::exception& e) {
+        std::cerr << "Error in getOrdersPage: " << e.what() << std::endl;
+        return rdws::types::OrderPageResult::error("Failed to retrieve orders: " +
+                                                   std::string(e.what()));
+    }
+}
+
 rdws::types::OrdersResult OrderService::getOrdersByUserId(int userId) {
     try {
         if (userId <= 0) {
@@ -70,47 +100,20 @@ rdws::types::CountResult OrderService::getOrderCount() {
     }
 }
 
+void OrderService::warmUp() {
+    orderRepository.prepareStatements();
+    orderRepository.ping();
+}
+
 rdws::types::OrderResult OrderService::createOrder(const std::string& jsonData) {
     try {
-        if (jsonData.empty()) {
-            return rdws::types::ServiceResult<rdws::types::Order>::error(
-                "Empty JSON data provided");
+        auto parsed = parseNewOrder(jsonData);
+        if (parsed.isError()) {
+            return parsed;
         }
 
-        // Parse JSON
-        rapidjson::Document doc;
-        doc.Parse(jsonData.c_str());
-
-        if (doc.HasParseError()) {
-            return rdws::types::ServiceResult<rdws::types::Order>::error(
-                "Invalid JSON format: " +
-                std::string(rapidjson::GetParseError_En(doc.GetParseError())));
-        }
-
-        // Validate required fields
-        if (!doc.HasMember("userId") || !doc["userId"].IsInt()) {
-            return rdws::types::ServiceResult<rdws::types::Order>::error(
-                "Missing or invalid userId field");
-        }
-        if (!doc.HasMember("product") || !doc["product"].IsString()) {
-            return rdws::types::ServiceResult<rdws::types::Order>::error(
-                "Missing or invalid product field");
-        }
-        if (!doc.HasMember("amount") || !doc["amount"].IsNumber()) {
-            return rdws::types::ServiceResult<rdws::types::Order>::error(
-                "Missing or invalid amount field");
-        }
-        if (!doc.HasMember("status") || !doc["status"].IsString()) {
-            return rdws::types::ServiceResult<rdws::types::Order>::error(
-                "Missing or invalid status field");
-        }
-
-        // Create Order object
-        rdws::types::Order newOrder(doc["userId"].GetInt(), doc["product"].GetString(),
-                                    doc["amount"].GetDouble(), doc["status"].GetString());
-
         // Save to database
-        auto createdOrder = orderRepository.create(newOrder);
+        auto createdOrder = orderRepository.create(parsed.getData());
 
         if (createdOrder.has_value()) {
             return rdws::types::ServiceResult<rdws::types::Order>::success(createdOrder.value());
@@ -131,19 +134,10 @@ rdws::types::OrderResult OrderService::updateOrder(int orderId, const std::strin
             return rdws::types::ServiceResult<rdws::types::Order>::error("Invalid order ID");
         }
 
-        if (jsonData.empty()) {
-            return rdws::types::ServiceResult<rdws::types::Order>::error(
-                "Empty JSON data provided");
-        }
-
-        // Parse JSON
-        rapidjson::Document doc;
-        doc.Parse(jsonData.c_str());
-
-        if (doc.HasParseError()) {
-            return rdws::types::ServiceResult<rdws::types::Order>::error(
-                "Invalid JSON format: " +
-                std::string(rapidjson::GetParseError_En(doc.GetParseError())));
+        const auto update = parseOrderUpdate(jsonData);
+        if (update.isError()) {
+            return rdws::types::ServiceResult<rdws::types::Order>::error(update.getErrorMessage(),
+                                                                         update.getStatusCode());
         }
 
         // Get existing order first
@@ -155,16 +149,7 @@ rdws::types::OrderResult OrderService::updateOrder(int orderId, const std::strin
 
         // Update fields if provided
         rdws::types::Order updatedOrder = existingOrder.value();
-
-        if (doc.HasMember("product") && doc["product"].IsString()) {
-            updatedOrder.product = doc["product"].GetString();
-        }
-        if (doc.HasMember("amount") && doc["amount"].IsNumber()) {
-            updatedOrder.amount = doc["amount"].GetDouble();
-        }
-        if (doc.HasMember("status") && doc["status"].IsString()) {
-            updatedOrder.status = doc["status"].GetString();
-        }
+        update.getData().applyTo(updatedOrder);
 
         // Save updated order
         auto result = orderRepository.update(updatedOrder);
@@ -218,4 +203,82 @@ rdws::types::CountResult OrderService::getOrderCountByUserId(int userId) {
     }
 }
 
+rdws::types::OrderResult OrderService::parseNewOrder(const std::string& jsonData) {
+    if (jsonData.empty()) {
+        return rdws::types::ServiceResult<rdws::types::Order>::error("Empty JSON data provided");
+    }
+
+    // Parse JSON
+    rapidjson::Document doc;
+    doc.Parse(jsonData.c_str());
+
+    if (doc.HasParseError()) {
+        return rdws::types::ServiceResult<rdws::types::Order>::error(
+            "Invalid JSON format: " +
+            std::string(rapidjson::GetParseError_En(doc.GetParseError())));
+    }
+
+    // Validate required fields
+    if (!doc.HasMember("userId") || !doc["userId"].IsInt()) {
+        return rdws::types::ServiceResult<rdws::types::Order>::error(
+            "Missing or invalid userId field");
+    }
+    if (!doc.HasMember("product") || !doc["product"].IsString()) {
+        return rdws::types::ServiceResult<rdws::types::Order>::error(
+            "Missing or invalid product field");
+    }
+    if (!doc.HasMember("amount") || !doc["amount"].IsNumber()) {
+        return rdws::types::ServiceResult<rdws::types::Order>::error(
+            "Missing or invalid amount field");
+    }
+    if (!doc.HasMember("status") || !doc["status"].IsString()) {
+        return rdws::types::ServiceResult<rdws::types::Order>::error(
+            "Missing or invalid status field");
+    }
+
+    return rdws::types::ServiceResult<rdws::types::Order>::success(
+        rdws::types::Order(doc["userId"].GetInt(), doc["product"].GetString(),
+                           doc["amount"].GetDouble(), doc["status"].GetString()));
+}
+
+rdws::types::ServiceResult<OrderUpdate> OrderService::parseOrderUpdate(const std::string& jsonData) {
+    if (jsonData.empty()) {
+        return rdws::types::ServiceResult<OrderUpdate>::error("Empty JSON data provided");
+    }
+
+    // Parse JSON
+    rapidjson::Document doc;
+    doc.Parse(jsonData.c_str());
+
+    if (doc.HasParseError()) {
+        return rdws::types::ServiceResult<OrderUpdate>::error(
+            "Invalid JSON format: " +
+            std::string(rapidjson::GetParseError_En(doc.GetParseError())));
+    }
+
+    OrderUpdate update;
+    if (doc.HasMember("product") && doc["product"].IsString()) {
+        update.product = doc["product"].GetString();
+    }
+    if (doc.HasMember("amount") && doc["amount"].IsNumber()) {
+        update.amount = doc["amount"].GetDouble();
+    }
+    if (doc.HasMember("status") && doc["status"].IsString()) {
+        update.status = doc["status"].GetString();
+    }
+    return rdws::types::ServiceResult<OrderUpdate>::success(std::move(update));
+}
+
+void OrderUpdate::applyTo(rdws::types::Order& order) const {
+    if (product) {
+        order.product = *product;
+    }
+    if (amount) {
+        order.amount = *amount;
+    }
+    if (status) {
+        order.status = *status;
+    }
+}
+
 } // namespace rdws::services::orders
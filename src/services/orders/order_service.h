@@ -5,10 +5,24 @@
 #include "types/order.h"
 #include "types/service_result.h"
 
+#include <functional>
 #include <memory>
+#include <optional>
+#include <string>
 
 namespace rdws::services::orders {
 
+/**
+ * Fields of an update request; unset fields keep their stored value
+ */
+struct OrderUpdate {
+    std::optional<std::string> product;
+    std::optional<double> amount;
+    std::optional<std::string> status;
+
+    void applyTo(rdws::types::Order& order) const;
+};
+
 /**
  * Service class for managing order operations
  * Provides business logic layer for order management with dependency injection
@@ -18,6 +32,8 @@ class OrderService {
     OrderRepository orderRepository;
 
   public:
+    static constexpr int maxPageSize = 1000;
+
     /**
      * Constructor with dependency injection
      * @param db Database interface for order operations
@@ -30,6 +46,15 @@ class OrderService {
      */
     rdws::types::OrdersResult getAllOrders();
 
+    /**
+     * Hand every order to onOrder as views into the streamed rows, for a listing written
+     * without copying them
+     * @param onOrder Called once per order, in the same order as getAllOrders()
+     * @return ServiceResult containing the number of orders
+     */
+    rdws::types::CountResult forEachOrder(
+        const std::function<void(const rdws::types::OrderView&)>& onOrder);
+
     /**
      * Get a specific order by ID
      * @param orderId ID of the order to retrieve
@@ -37,6 +62,14 @@ class OrderService {
      */
     rdws::types::OrderResult getOrderById(int orderId);
 
+    /**
+     * Get one page of all orders, newest first, with the total number of orders
+     * @param limit Maximum number of orders in the page (1 to maxPageSize)
+     * @param offset Number of orders to skip
+     * @return ServiceResult containing the page, error if the bounds are invalid
+     */
+    rdws::types::OrderPageResult getOrdersPage(int limit, int offset);
+
     /**
      * Get all orders for a specific user
      * @param userId ID of the user whose orders to retrieve
@@ -78,6 +111,25 @@ class OrderService {
      * @return ServiceResult containing number of orders for the specified user
      */
     rdws::types::CountResult getOrderCountByUserId(int userId);
+
+    /**
+     * Prepare the repository statements on the connection ahead of the first request
+     */
+    void warmUp();
+
+    /**
+     * Validate create-request JSON (shared with AsyncOrderService)
+     * @param jsonData JSON string containing order data
+     * @return ServiceResult containing the unsaved order, error if the data is invalid
+     */
+    static rdws::types::OrderResult parseNewOrder(const std::string& jsonData);
+
+    /**
+     * Parse update-request JSON (shared with AsyncOrderService)
+     * @param jsonData JSON string containing updated order data
+     * @return ServiceResult containing the fields to change, error if the JSON is invalid
+     */
+    static rdws::types::ServiceResult<OrderUpdate> parseOrderUpdate(const std::string& jsonData);
 };
 
 } // namespace rdws::services::orders
@@ -0,0 +1,30 @@
+#include "order_handler.h"
+#include "server/metrics_registry.h"
+#include "server/route_dispatcher.h"
+#include "server/service_runner.h"
+#include "user_handler.h"
+
+#include <memory>
+#include <utility>
+
+int main(int argc, char* argv[]) {
+    // One registry for the whole process, including every worker thread
+    auto metrics = std::make_shared<rdws::server::MetricsRegistry>();
+
+    rdws::server::ServiceRunner runner(
+        "rdws_server", [metrics](std::shared_ptr<rdws::database::IDatabase> db) {
+            // Both services share the connection handed to this dispatcher
+            auto users = std::make_shared<rdws::users::UserRequestHandler>(db);
+            auto orders = std::make_shared<rdws::services::orders::OrderRequestHandler>(db);
+
+            auto dispatcher = std::make_unique<rdws::server::RouteDispatcher>(metrics);
+            dispatcher->addRoute("/users/{userId}/orders", orders);
+            dispatcher->addRoute("/users", users);
+            dispatcher->addRoute("/users/{id}", users);
+            dispatcher->addRoute("/orders", orders);
+            dispatcher->addRoute("/orders/{id}", std::move(orders));
+            return dispatcher;
+        });
+
+    return runner.run(argc, argv);
+}
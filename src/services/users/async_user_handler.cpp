@@ -0,0 +1,62 @@
+#include "async_user_handler.h"
+
+#include "controllers/user_controller.h"
+#include "user_routes.h"
+
+#include <utility>
+
+using rdws::async::Task;
+using rdws::controllers::UserController;
+using rdws::server::HandlerResponse;
+
+namespace rdws::users {
+
+AsyncUserRequestHandler::AsyncUserRequestHandler(
+    std::shared_ptr<rdws::async::AsyncPostgreSQLDatabase> db)
+    : userService(std::move(db)) {}
+
+Task<HandlerResponse> AsyncUserRequestHandler::handle(rdws::types::LambdaEvent& event,
+                                                      const rdws::types::LambdaContext& context) {
+    const auto route = routeUserRequest(event, context);
+
+    switch (route.action) {
+    case UserRoute::Action::List: {
+        // Written to JSON as the rows arrive, like the synchronous listing
+        rdws::utils::JsonListWriter users;
+        const auto result = co_await userService.forEachUser(
+            [&users](const rdws::types::UserView& user) { users.add(user); });
+        co_return HandlerResponse{UserController::formatUsersListing(result, users), 0,
+                                  result.getStatusCode()};
+    }
+    case UserRoute::Action::Count: {
+        const auto result = co_await userService.getUsersCount();
+        co_return HandlerResponse{UserController::formatCountResponse(result), 0,
+                                  result.getStatusCode()};
+    }
+    case UserRoute::Action::Get: {
+        const auto result = co_await userService.getUserById(route.userId);
+        co_return HandlerResponse{UserController::formatUserResponse(result), 0,
+                                  result.getStatusCode()};
+    }
+    case UserRoute::Action::Create: {
+        const auto result = co_await userService.createUser(event.getBody());
+        co_return HandlerResponse{UserController::formatUserResponse(result), 0,
+                                  result.getStatusCode()};
+    }
+    case UserRoute::Action::Update: {
+        const auto result = co_await userService.updateUser(route.userId, event.getBody());
+        co_return HandlerResponse{UserController::formatUserResponse(result), 0,
+                                  result.getStatusCode()};
+    }
+    case UserRoute::Action::Delete: {
+        const auto result = co_await userService.deleteUser(route.userId);
+        co_return HandlerResponse{UserController::formatOperationResponse(result), 0,
+                                  operationStatusCode(result)};
+    }
+    case UserRoute::Action::Rejected:
+        break;
+    }
+    co_return route.rejection;
+}
+
+} // namespace rdws::users
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "async/async_executor.h"
+#include "async_user_service.h"
+
+#include <memory>
+
+namespace rdws::users {
+
+/**
+ * AsyncUserRequestHandler - UserRequestHandler for the coroutine executor
+ * Same routes and responses, backed by AsyncUserService
+ */
+class AsyncUserRequestHandler : public rdws::async::AsyncRequestHandler {
+  private:
+    AsyncUserService userService;
+
+  public:
+    explicit AsyncUserRequestHandler(std::shared_ptr<rdws::async::AsyncPostgreSQLDatabase> db);
+
+    rdws::async::Task<rdws::server::HandlerResponse>
+    handle(rdws::types::LambdaEvent& event, const rdws::types::LambdaContext& context) override;
+};
+
+} // namespace rdws::users
@@ -0,0 +1,151 @@
+#include "async_user_service.h"
+
+#include "repository/user_repository.h"
+
+#include <json/json.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+using rdws::async::Task;
+using rdws::repository::UserRepository;
+
+namespace rdws::users {
+
+namespace {
+
+// Parameters are built before co_await: GCC 12 rejects braced lists inside the await operand
+std::vector<std::string> idParameter(const int id) {
+    return {std::to_string(id)};
+}
+
+} // namespace
+
+AsyncUserService::AsyncUserService(
+    std::shared_ptr<rdws::async::AsyncPostgreSQLDatabase> database)
+    : db(std::move(database)),
+      createValidator(rdws::validation::UserValidators::createUserValidator),
+      updateValidator(rdws::validation::UserValidators::updateUserValidator) {}
+
+Task<rdws::types::CountResult> AsyncUserService::forEachUser(
+    std::function<void(const rdws::types::UserView&)> onUser) const {
+    try {
+        size_t count = 0;
+        rdws::database::RowMapper<rdws::types::UserView> mapper;
+        co_await db->stream(UserRepository::findAllQuery, {},
+                            [&onUser, &count, &mapper](rdws::database::IResultSet& row) {
+                                onUser(mapper.read(row));
+                                ++count;
+                            });
+        co_return rdws::types::CountResult::success(count);
+    } catch (const std::exception& e) {
+        co_return rdws::types::CountResult::error("Database error: " + std::string(e.what()),
+                                                  500);
+    }
+}
+
+Task<rdws::types::UserResult> AsyncUserService::getUserById(const int id) const {
+    try {
+        const auto result = co_await db->query(UserRepository::findByIdQuery, idParameter(id));
+        if (!result->next()) {
+            co_return rdws::types::UserResult::error("User not found", 404);
+        }
+        co_return rdws::types::UserResult::success(UserRepository::UserMapper().read(*result));
+    } catch (const std::exception& e) {
+        co_return rdws::types::UserResult::error("Database error: " + std::string(e.what()), 500);
+    }
+}
+
+Task<rdws::types::CountResult> AsyncUserService::getUsersCount() const {
+    try {
+        const auto result = co_await db->query(UserRepository::countQuery);
+        const size_t count = result->next() ? static_cast<size_t>(result->getInt("total")) : 0;
+        co_return rdws::types::CountResult::success(count);
+    } catch (const std::exception& e) {
+        co_return rdws::types::CountResult::error("Database error: " + std::string(e.what()),
+                                                  500);
+    }
+}
+
+Task<rdws::types::UserResult> AsyncUserService::createUser(const std::string jsonData) const {
+    try {
+        if (auto errors = createValidator.validate(jsonData); !errors.empty()) {
+            co_return rdws::types::UserResult::error("Validation failed: " + errors[0].message,
+                                                     400);
+        }
+
+        Json::Value json;
+        if (Json::Reader reader; !reader.parse(jsonData, json)) {
+            co_return rdws::types::UserResult::error("Invalid JSON format", 400);
+        }
+
+        // RETURNING gives back the stored row without a second round-trip
+        std::vector<std::string> parameters{json["name"].asString(), json["email"].asString()};
+        const auto result =
+            co_await db->query(UserRepository::createReturningQuery, std::move(parameters));
+        if (!result->next()) {
+            co_return rdws::types::UserResult::error("Failed to create user", 500);
+        }
+        co_return rdws::types::UserResult::success(UserRepository::UserMapper().read(*result));
+    } catch (const std::exception& e) {
+        co_return rdws::types::UserResult::error("Database error: " + std::string(e.what()), 500);
+    }
+}
+
+Task<rdws::types::UserResult> AsyncUserService::updateUser(const int id,
+                                                           const std::string jsonData) const {
+    try {
+        Json::Value json;
+        if (Json::Reader reader; !reader.parse(jsonData, json)) {
+            co_return rdws::types::UserResult::error("Invalid JSON format", 400);
+        }
+        json["id"] = id;
+
+        if (auto errors = updateValidator.validate(json); !errors.empty()) {
+            co_return rdws::types::UserResult::error("Validation failed: " + errors[0].message,
+                                                     400);
+        }
+
+        const auto existing = co_await db->query(UserRepository::findByIdQuery, idParameter(id));
+        if (!existing->next()) {
+            co_return rdws::types::UserResult::error("User not found", 404);
+        }
+
+        rdws::types::User updatedUser = UserRepository::UserMapper().read(*existing);
+        if (json.isMember("name")) {
+            updatedUser.name = json["name"].asString();
+        }
+        if (json.isMember("email")) {
+            updatedUser.email = json["email"].asString();
+        }
+
+        std::vector<std::string> parameters{updatedUser.name, updatedUser.email,
+                                            std::to_string(id)};
+        if (!co_await db->command(UserRepository::updateQuery, std::move(parameters))) {
+            co_return rdws::types::UserResult::error("User not found or update failed", 404);
+        }
+        co_return rdws::types::UserResult::success(updatedUser);
+    } catch (const std::exception& e) {
+        co_return rdws::types::UserResult::error("Database error: " + std::string(e.what()), 500);
+    }
+}
+
+Task<rdws::types::OperationResult> AsyncUserService::deleteUser(const int id) const {
+    try {
+        const auto existing = co_await db->query(UserRepository::existsQuery, idParameter(id));
+        if (!existing->next()) {
+            co_return rdws::types::OperationResult::success(
+                rdws::types::OperationStatus::createError("User not found", 404));
+        }
+
+        const bool deleted = co_await db->command(UserRepository::deleteQuery, idParameter(id));
+        co_return rdws::types::OperationResult::success(
+            deleted ? rdws::types::OperationStatus::createSuccess("User deleted successfully")
+                    : rdws::types::OperationStatus::createError("Failed to delete user", 500));
+    } catch (const std::exception& e) {
+        co_return rdws::types::OperationResult::error("Database error: " + std::string(e.what()),
+                                                      500);
+    }
+}
+
+} // namespace rdws::users
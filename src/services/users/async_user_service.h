@@ -0,0 +1,40 @@
+#pragma once
+
+#include "async/async_database.h"
+#include "async/task.h"
+#include "types/service_result.h"
+#include "types/user.h"
+#include "validation/schema_validator.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace rdws::users {
+
+/**
+ * AsyncUserService - UserService on non-blocking database connections
+ * Same results as UserService; every method is a coroutine that suspends while its
+ * queries are in flight.
+ */
+class AsyncUserService {
+  private:
+    std::shared_ptr<rdws::async::AsyncPostgreSQLDatabase> db;
+
+    rdws::validation::LazySchemaValidator createValidator;
+    rdws::validation::LazySchemaValidator updateValidator;
+
+  public:
+    explicit AsyncUserService(std::shared_ptr<rdws::async::AsyncPostgreSQLDatabase> database);
+
+    // UserService::forEachUser: every user as views into the rows as they arrive
+    rdws::async::Task<rdws::types::CountResult>
+    forEachUser(std::function<void(const rdws::types::UserView&)> onUser) const;
+    rdws::async::Task<rdws::types::UserResult> getUserById(int id) const;
+    rdws::async::Task<rdws::types::CountResult> getUsersCount() const;
+    rdws::async::Task<rdws::types::UserResult> createUser(std::string jsonData) const;
+    rdws::async::Task<rdws::types::UserResult> updateUser(int id, std::string jsonData) const;
+    rdws::async::Task<rdws::types::OperationResult> deleteUser(int id) const;
+};
+
+} // namespace rdws::users
@@ -0,0 +1,58 @@
+#include "user_handler.h"
+
+#include "controllers/user_controller.h"
+#include "user_routes.h"
+
+#include <utility>
+
+using rdws::controllers::UserController;
+using rdws::server::HandlerResponse;
+
+namespace rdws::users {
+
+UserRequestHandler::UserRequestHandler(std::shared_ptr<rdws::database::IDatabase> db)
+    : userService(std::move(db)) {}
+
+void UserRequestHandler::warmUp() {
+    userService.warmUp();
+}
+
+HandlerResponse UserRequestHandler::handle(rdws::types::LambdaEvent& event,
+                                           const rdws::types::LambdaContext& context) {
+    const auto route = routeUserRequest(event, context);
+
+    switch (route.action) {
+    case UserRoute::Action::List: {
+        // Written to JSON straight from the streamed rows
+        rdws::utils::JsonListWriter users;
+        const auto result = userService.forEachUser(
+            [&users](const rdws::types::UserView& user) { users.add(user); });
+        return {UserController::formatUsersListing(result, users), 0, result.getStatusCode()};
+    }
+    case UserRoute::Action::Count: {
+        const auto result = userService.getUsersCount();
+        return {UserController::formatCountResponse(result), 0, result.getStatusCode()};
+    }
+    case UserRoute::Action::Get: {
+        const auto result = userService.getUserById(route.userId);
+        return {UserController::formatUserResponse(result), 0, result.getStatusCode()};
+    }
+    case UserRoute::Action::Create: {
+        const auto result = userService.createUser(event.getBody());
+        return {UserController::formatUserResponse(result), 0, result.getStatusCode()};
+    }
+    case UserRoute::Action::Update: {
+        const auto result = userService.updateUser(route.userId, event.getBody());
+        return {UserController::formatUserResponse(result), 0, result.getStatusCode()};
+    }
+    case UserRoute::Action::Delete: {
+        const auto result = userService.deleteUser(route.userId);
+        return {UserController::formatOperationResponse(result), 0, operationStatusCode(result)};
+    }
+    case UserRoute::Action::Rejected:
+        break;
+    }
+    return route.rejection;
+}
+
+} // namespace rdws::users
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "common/database/idatabase.h"
+#include "server/request_handler.h"
+#include "user_service.h"
+
+#include <memory>
+
+namespace rdws::users {
+
+/**
+ * UserRequestHandler - Maps /users routes to UserService calls
+ * Holds the service (and its database handle) so it can serve many requests
+ */
+class UserRequestHandler : public rdws::server::RequestHandler {
+  private:
+    UserService userService;
+
+  public:
+    explicit UserRequestHandler(std::shared_ptr<rdws::database::IDatabase> db);
+
+    rdws::server::HandlerResponse handle(rdws::types::LambdaEvent& event,
+                                         const rdws::types::LambdaContext& context) override;
+
+    void warmUp() override;
+};
+
+} // namespace rdws::users
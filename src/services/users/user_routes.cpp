@@ -0,0 +1,113 @@
+#include "user_routes.h"
+
+#include "controllers/user_controller.h"
+
+#include <string>
+#include <utility>
+
+using rdws::controllers::UserController;
+using rdws::server::HandlerResponse;
+
+namespace rdws::users {
+
+namespace {
+
+// std::stoi without the exception, which the async handler must not carry across co_await
+bool parseId(const std::string& value, int& id) {
+    try {
+        id = std::stoi(value);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+UserRoute accept(const UserRoute::Action action, const int userId = 0) {
+    UserRoute route;
+    route.action = action;
+    route.userId = userId;
+    return route;
+}
+
+UserRoute reject(HandlerResponse response) {
+    UserRoute route;
+    route.rejection = std::move(response);
+    return route;
+}
+
+} // namespace
+
+UserRoute routeUserRequest(rdws::types::LambdaEvent& event,
+                           const rdws::types::LambdaContext& context) {
+    using Action = UserRoute::Action;
+
+    // Extract path parameters for routes like /users/{id}
+    if (event.pathMatches("/users/{id}") || event.pathMatches("/users/{action}")) {
+        event.extractPathParameters("/users/{id}");
+    }
+
+    context.log("Processing " + event.getHttpMethod() + " request to " + event.getPath(), "INFO");
+
+    const bool collection = event.pathMatches("/users") || event.pathMatches("/");
+    const bool member = event.pathMatches("/users/{id}");
+
+    if (event.isGet() && collection) {
+        context.log("Fetching all users", "INFO");
+        return accept(Action::List);
+    }
+    if (event.isPost() && collection) {
+        if (event.getBody().empty()) {
+            context.log("No JSON data provided for user creation", "ERROR");
+            return reject({UserController::formatNoDataProvidedError("user creation"), 1, 400});
+        }
+        context.log("Creating new user", "INFO");
+        return accept(Action::Create);
+    }
+
+    if (member && (event.isGet() || event.isPut() || event.isDelete())) {
+        const std::string idParam = event.getPathParameter("id");
+
+        if (event.isGet() && idParam == "count") {
+            context.log("Getting user count", "INFO");
+            return accept(Action::Count);
+        }
+
+        int userId = 0;
+        if (!parseId(idParam, userId)) {
+            context.log("Invalid user ID: " + idParam, "ERROR");
+            // GET has always answered with the raw path
+            if (event.isGet()) {
+                return reject(
+                    {R"({"error":"Invalid user ID","path":")" + event.getPath() + "\"}", 1, 400});
+            }
+            return reject({UserController::formatError("Invalid user ID", 400), 1, 400});
+        }
+
+        if (event.isGet()) {
+            context.log("Fetching user with ID: " + std::to_string(userId), "INFO");
+            return accept(Action::Get, userId);
+        }
+        if (event.isPut()) {
+            if (event.getBody().empty()) {
+                context.log("No JSON data provided for user update", "ERROR");
+                return reject({UserController::formatNoDataProvidedError("user update"), 1, 400});
+            }
+            context.log("Updating user with ID: " + std::to_string(userId), "INFO");
+            return accept(Action::Update, userId);
+        }
+        context.log("Deleting user with ID: " + std::to_string(userId), "INFO");
+        return accept(Action::Delete, userId);
+    }
+
+    // Method not supported
+    context.log("Method not allowed: " + event.getHttpMethod() + " " + event.getPath(), "WARN");
+    return reject({UserController::formatMethodNotAllowedError(event.getHttpMethod(),
+                                                               event.getPath()),
+                   1, 405});
+}
+
+int operationStatusCode(const rdws::types::OperationResult& result) {
+    return result.isSuccess() ? result.getData().statusCode : result.getStatusCode();
+}
+
+} // namespace rdws::users
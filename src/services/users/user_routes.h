@@ -0,0 +1,35 @@
+#pragma once
+
+#include "server/request_handler.h"
+#include "types/lambda_context.h"
+#include "types/lambda_event.h"
+#include "types/service_result.h"
+
+namespace rdws::users {
+
+/**
+ * UserRoute - The UserService call a /users request asks for
+ */
+struct UserRoute {
+    enum class Action { List, Count, Get, Create, Update, Delete, Rejected };
+
+    Action action = Action::Rejected;
+    int userId = 0;                           // Get, Update and Delete
+    rdws::server::HandlerResponse rejection;  // Rejected: bad ID, no body or unknown route
+};
+
+/**
+ * Resolve the route of a request, extracting its path parameters and logging it
+ *
+ * Shared by UserRequestHandler and AsyncUserRequestHandler, so both answer the same
+ * requests and reject the others with the same responses. Never throws for bad input.
+ */
+UserRoute routeUserRequest(rdws::types::LambdaEvent& event,
+                           const rdws::types::LambdaContext& context);
+
+/**
+ * HTTP status carried by an operation result (delete reports errors inside the status)
+ */
+int operationStatusCode(const rdws::types::OperationResult& result);
+
+} // namespace rdws::users
@@ -1,12 +1,14 @@
 #include "user_service.h"
 
-#include "validation/schema_validator.h"
-
 #include <json/json.h>
+#include <utility>
 
 namespace rdws::users {
 
-UserService::UserService(std::shared_ptr<rdws::database::IDatabase> db) : userRepository(db) {}
+UserService::UserService(std::shared_ptr<rdws::database::IDatabase> db)
+    : userRepository(std::move(db)),
+      createValidator(rdws::validation::UserValidators::createUserValidator),
+      updateValidator(rdws::validation::UserValidators::updateUserValidator) {}
 
 rdws::types::UsersResult UserService::getAllUsers() const {
     try {
@@ -18,6 +20,21 @@ rdws::types::UsersResult UserService::getAllUsers() const {
     }
 }
 
+rdws::types::CountResult UserService::forEachUser(
+    const std::function<void(const rdws::types::UserView&)>& onUser) const {
+    try {
+        size_t count = 0;
+        userRepository.findAllViews([&onUser, &count](const rdws::types::UserView& user) {
+            onUser(user);
+            ++count;
+        });
+        return rdws::types::CountResult::success(count);
+    } catch (const std::exception& e) {
+        const std::string errorMsg = "Database error: " + std::string(e.what());
+        return rdws::types::CountResult::error(errorMsg, 500);
+    }
+}
+
 rdws::types::UserResult UserService::getUserById(const int id) const {
     try {
         if (auto user = userRepository.findById(id); user.has_value()) {
@@ -41,11 +58,16 @@ rdws::types::CountResult UserService::getUsersCount() const {
     }
 }
 
+void UserService::warmUp() const {
+    [[maybe_unused]] const auto& create = createValidator.get();
+    [[maybe_unused]] const auto& update = updateValidator.get();
+    userRepository.prepareStatements();
+    userRepository.ping();
+}
+
 rdws::types::UserResult UserService::createUser(const std::string& jsonData) const {
     try {
-        auto validator = rdws::validation::UserValidators::createUserValidator();
-
-        if (auto errors = validator.validate(jsonData); !errors.empty()) {
+        if (auto errors = createValidator.validate(jsonData); !errors.empty()) {
             // Return validation error with first error message
             std::string errorMsg = "Validation failed: " + errors[0].message;
             return rdws::types::UserResult::error(errorMsg, 400);
@@ -85,9 +107,7 @@ rdws::types::UserResult UserService::updateUser(int id, const std::string& jsonD
         }
         json["id"] = id;
 
-        auto validator = rdws::validation::UserValidators::updateUserValidator();
-
-        if (auto errors = validator.validate(json); !errors.empty()) {
+        if (auto errors = updateValidator.validate(json); !errors.empty()) {
             std::string errorMsg = "Validation failed: " + errors[0].message;
             return rdws::types::UserResult::error(errorMsg, 400);
         }
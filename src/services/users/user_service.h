@@ -3,7 +3,9 @@
 #include "common/database/idatabase.h"
 #include "repository/user_repository.h"
 #include "types/service_result.h"
+#include "validation/schema_validator.h"
 
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -17,16 +19,27 @@ class UserService {
   private:
     rdws::repository::UserRepository userRepository;
 
+    // Parsed on first use and then reused by every request of this instance
+    rdws::validation::LazySchemaValidator createValidator;
+    rdws::validation::LazySchemaValidator updateValidator;
+
   public:
     explicit UserService(std::shared_ptr<rdws::database::IDatabase> db);
 
     // Business logic methods returning structured data
     rdws::types::UsersResult getAllUsers() const;
+    // Every user as views into the streamed rows, for a listing written without copies;
+    // the result holds the number of users
+    rdws::types::CountResult
+    forEachUser(const std::function<void(const rdws::types::UserView&)>& onUser) const;
     rdws::types::UserResult getUserById(int id) const;
     rdws::types::CountResult getUsersCount() const;
     rdws::types::UserResult createUser(const std::string& jsonData) const;
     rdws::types::UserResult updateUser(int id, const std::string& jsonData) const;
     rdws::types::OperationResult deleteUser(int id) const;
+
+    // Parse the schemas and prepare the repository statements ahead of the first request
+    void warmUp() const;
 };
 
 } // namespace rdws::users
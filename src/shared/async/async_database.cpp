@@ -0,0 +1,620 @@
+#include "async_database.h"
+
+#include "../common/database/pq_result_set.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <utility>
+
+using rdws::database::DeadlineExceeded;
+using rdws::database::PqResultSet;
+using rdws::database::QueryWatchdog;
+
+namespace rdws::async {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int maxEvents = 64;
+constexpr auto statementPrefix = "rdws_async_";
+
+// libpq messages end with a newline
+std::string connectionError(const PGconn* handle) {
+    std::string message = PQerrorMessage(handle);
+    while (!message.empty() && (message.back() == '\n' || message.back() == ' ')) {
+        message.pop_back();
+    }
+    return message.empty() ? "unknown libpq error" : message;
+}
+
+std::runtime_error systemError(const std::string& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+// Text bytes of a row, or of a whole result scaled up from evenly spaced sample rows
+uint64_t resultBytes(const PGresult* result) {
+    constexpr int sampleRows = 16;
+    const int rows = PQntuples(result);
+    if (rows == 0) {
+        return 0;
+    }
+    const int step = std::max(rows / sampleRows, 1);
+    uint64_t bytes = 0;
+    uint64_t sampled = 0;
+    for (int row = 0; row < rows; row += step, ++sampled) {
+        for (int column = 0; column < PQnfields(result); ++column) {
+            bytes += static_cast<uint64_t>(PQgetlength(result, row, column));
+        }
+    }
+    return bytes * static_cast<uint64_t>(rows) / sampled;
+}
+
+// Rows a query returned, or the rows a command touched
+uint64_t resultRows(PGresult* result) {
+    if (PQresultStatus(result) == PGRES_TUPLES_OK) {
+        return static_cast<uint64_t>(PQntuples(result));
+    }
+    return std::strtoull(PQcmdTuples(result), nullptr, 10);
+}
+
+} // namespace
+
+// QueryAwaitable
+
+AsyncPostgreSQLDatabase::QueryAwaitable::QueryAwaitable(AsyncPostgreSQLDatabase& db,
+                                                        Request pending)
+    : database(db), request(std::move(pending)) {}
+
+AsyncPostgreSQLDatabase::QueryAwaitable::~QueryAwaitable() {
+    if (request.result != nullptr) {
+        PQclear(request.result);
+    }
+}
+
+bool AsyncPostgreSQLDatabase::QueryAwaitable::await_suspend(std::coroutine_handle<> awaiting) {
+    request.waiter = awaiting;
+    // Not suspending when the query could not even be sent; await_resume reports the error
+    return database.submit(request);
+}
+
+std::unique_ptr<rdws::database::IResultSet>
+AsyncPostgreSQLDatabase::QueryAwaitable::await_resume() {
+    database.recordStatement(request);
+    if (request.deadlineExceeded) {
+        request.deadline->exceeded = true;
+        DeadlineExceeded exceeded;
+        database.lastError = exceeded.what();
+        throw exceeded;
+    }
+    if (!request.error.empty()) {
+        database.lastError = request.error;
+        throw std::runtime_error("Query execution failed: " + request.error);
+    }
+    return std::make_unique<PqResultSet>(std::exchange(request.result, nullptr));
+}
+
+// BatchAwaitable
+
+AsyncPostgreSQLDatabase::BatchAwaitable::BatchAwaitable(AsyncPostgreSQLDatabase& db,
+                                                        std::vector<QueryAwaitable*> sent)
+    : database(db), queries(std::move(sent)) {}
+
+bool AsyncPostgreSQLDatabase::BatchAwaitable::await_suspend(std::coroutine_handle<> awaiting) {
+    batch.waiter = awaiting;
+    for (QueryAwaitable* query : queries) {
+        query->request.batch = &batch;
+        // A query that could not even be sent is complete already; its await_resume reports it
+        if (database.submit(query->request)) {
+            ++batch.remaining;
+        } else {
+            query->request.done = true;
+        }
+    }
+    return batch.remaining > 0;
+}
+
+// AsyncPostgreSQLDatabase
+
+AsyncPostgreSQLDatabase::AsyncPostgreSQLDatabase(const rdws::Config& dbConfig,
+                                                 const size_t connectionCount)
+    : config(dbConfig), breaker(rdws::database::ConnectionBreaker::forDatabase(config)),
+      statements(maxPreparedStatements, config.getSlowQueryThreshold()) {
+    try {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd < 0) {
+            throw systemError("epoll_create1 failed");
+        }
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wakeFd < 0) {
+            throw systemError("eventfd failed");
+        }
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event) < 0) {
+            throw systemError("epoll_ctl failed");
+        }
+
+        const std::string connectionString = config.getConnectionString();
+        for (size_t i = 0; i < connectionCount; ++i) {
+            auto connection = std::make_unique<Connection>();
+            connection->handle = PQconnectdb(connectionString.c_str());
+            if (PQstatus(connection->handle) != CONNECTION_OK ||
+                PQsetnonblocking(connection->handle, 1) != 0) {
+                const auto error = connectionError(connection->handle);
+                PQfinish(connection->handle);
+                throw std::runtime_error("Failed to connect to database: " + error);
+            }
+            connected(*connection);
+            connections.push_back(std::move(connection));
+        }
+    } catch (...) {
+        closeAll();
+        throw;
+    }
+}
+
+AsyncPostgreSQLDatabase::~AsyncPostgreSQLDatabase() {
+    closeAll();
+}
+
+AsyncPostgreSQLDatabase::QueryAwaitable
+AsyncPostgreSQLDatabase::query(std::string sql, std::vector<std::string> parameters) {
+    return {*this, makeRequest(std::move(sql), std::move(parameters))};
+}
+
+AsyncPostgreSQLDatabase::QueryAwaitable
+AsyncPostgreSQLDatabase::stream(std::string sql, std::vector<std::string> parameters,
+                                std::function<void(rdws::database::IResultSet&)> onRow) {
+    Request request = makeRequest(std::move(sql), std::move(parameters));
+    request.onRow = std::move(onRow);
+    return {*this, std::move(request)};
+}
+
+Task<bool> AsyncPostgreSQLDatabase::command(std::string sql, std::vector<std::string> parameters) {
+    try {
+        co_await query(std::move(sql), std::move(parameters));
+        co_return true;
+    } catch (const DeadlineExceeded&) {
+        throw;
+    } catch (const std::exception& e) {
+        lastError = e.what();
+        co_return false;
+    }
+}
+
+void AsyncPostgreSQLDatabase::run() {
+    running = true;
+    epoll_event events[maxEvents];
+
+    while (running) {
+        const int count = epoll_wait(epollFd, events, maxEvents, 1000);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw systemError("epoll_wait failed");
+        }
+
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.ptr == nullptr) {
+                uint64_t value = 0;
+                [[maybe_unused]] const auto drained = ::read(wakeFd, &value, sizeof(value));
+                if (stopRequested.load()) {
+                    running = false;
+                }
+                continue;
+            }
+
+            auto& connection = *static_cast<Connection*>(events[i].data.ptr);
+            if (connection.resetting) {
+                continueReset(connection);
+                continue;
+            }
+            if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+                onReadable(connection);
+            }
+            if ((events[i].events & EPOLLOUT) && connection.flushing) {
+                onWritable(connection);
+            }
+        }
+
+        runPostedTasks();
+    }
+}
+
+void AsyncPostgreSQLDatabase::stop() {
+    stopRequested.store(true);
+    const uint64_t one = 1;
+    [[maybe_unused]] const auto written = ::write(wakeFd, &one, sizeof(one));
+}
+
+void AsyncPostgreSQLDatabase::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(postedMutex);
+        posted.push_back(std::move(task));
+    }
+    const uint64_t one = 1;
+    [[maybe_unused]] const auto written = ::write(wakeFd, &one, sizeof(one));
+}
+
+AsyncPostgreSQLDatabase::Request
+AsyncPostgreSQLDatabase::makeRequest(std::string sql, std::vector<std::string> parameters) {
+    Request request;
+    request.sql = std::move(sql);
+    request.parameters = std::move(parameters);
+    request.deadline = currentDeadline;
+    request.start = Clock::now();
+    return request;
+}
+
+bool AsyncPostgreSQLDatabase::submit(Request& request) {
+    for (const auto& connection : connections) {
+        if (connection->active == nullptr && !connection->settling && !connection->resetting) {
+            return start(*connection, request);
+        }
+    }
+    waiting.push_back(&request);
+    return true;
+}
+
+bool AsyncPostgreSQLDatabase::start(Connection& connection, Request& request) {
+    // Waiting for a connection may have used up the rest of the budget
+    if (request.deadline != nullptr && Clock::now() >= request.deadline->at) {
+        request.deadlineExceeded = true;
+        return false;
+    }
+
+    if (!send(connection, request)) {
+        if (PQstatus(connection.handle) != CONNECTION_BAD) {
+            request.error = connectionError(connection.handle);
+            return false;
+        }
+        // A connection dropped by the server is re-established first; meanwhile the query
+        // waits at the head of the queue, as for a busy connection
+        const std::string reason = reconnect(connection);
+        if (!reason.empty()) {
+            request.error = reason;
+            return false;
+        }
+        waiting.push_front(&request);
+        return true;
+    }
+
+    connection.active = &request;
+    if (!flush(connection)) {
+        connection.active = nullptr;
+        request.error = connectionError(connection.handle);
+        reconnect(connection);
+        return false;
+    }
+
+    if (request.deadline != nullptr) {
+        // The key is copied, as a reconnect replaces it
+        request.watch = std::make_unique<QueryWatchdog::Guard>(
+            request.deadline->at, [key = connection.cancelKey] { key.cancel(); });
+    }
+    return true;
+}
+
+bool AsyncPostgreSQLDatabase::send(Connection& connection, Request& request) {
+    request.preparing = false;
+    const auto found = connection.prepared.find(request.sql);
+    if (found != connection.prepared.end()) {
+        return sendQuery(connection, request, &found->second);
+    }
+    // Past the cache size, SQL runs unnamed rather than evicting anything
+    if (connection.prepared.size() >= maxPreparedStatements) {
+        return sendQuery(connection, request, nullptr);
+    }
+
+    request.statementName = statementPrefix + std::to_string(connection.prepared.size() + 1);
+    request.preparing = true;
+    return PQsendPrepare(connection.handle, request.statementName.c_str(), request.sql.c_str(),
+                         static_cast<int>(request.parameters.size()), nullptr) == 1;
+}
+
+bool AsyncPostgreSQLDatabase::sendQuery(Connection& connection, Request& request,
+                                        const std::string* statementName) {
+    std::vector<const char*> values;
+    values.reserve(request.parameters.size());
+    for (const auto& parameter : request.parameters) {
+        values.push_back(parameter.c_str());
+    }
+
+    const int count = static_cast<int>(values.size());
+    const int sent =
+        statementName != nullptr
+            ? PQsendQueryPrepared(connection.handle, statementName->c_str(), count,
+                                  values.data(), nullptr, nullptr, 0)
+            : PQsendQueryParams(connection.handle, request.sql.c_str(), count, nullptr,
+                                values.data(), nullptr, nullptr, 0);
+    if (sent != 1) {
+        return false;
+    }
+    if (request.onRow) {
+        PQsetSingleRowMode(connection.handle);
+    }
+    return true;
+}
+
+bool AsyncPostgreSQLDatabase::flush(Connection& connection) {
+    const int flushed = PQflush(connection.handle);
+    if (flushed < 0) {
+        return false;
+    }
+    connection.flushing = flushed == 1;
+    watch(connection, EPOLL_CTL_MOD);
+    return true;
+}
+
+void AsyncPostgreSQLDatabase::onReadable(Connection& connection) {
+    if (PQconsumeInput(connection.handle) == 0) {
+        const auto error = connectionError(connection.handle);
+        reconnect(connection);
+        finish(connection, error);
+        return;
+    }
+    if (connection.flushing) {
+        onWritable(connection);
+    }
+
+    while (PQisBusy(connection.handle) == 0) {
+        PGresult* result = PQgetResult(connection.handle);
+        Request* request = connection.active;
+        if (result == nullptr && request != nullptr && request->preparing &&
+            request->error.empty()) {
+            // Prepared: run the query on the same connection, its result comes next
+            request->preparing = false;
+            PQclear(std::exchange(request->result, nullptr));
+            const auto& name =
+                connection.prepared.emplace(request->sql, request->statementName).first->second;
+            if (!sendQuery(connection, *request, &name) || !flush(connection)) {
+                const auto error = connectionError(connection.handle);
+                reconnect(connection);
+                finish(connection, error);
+                return;
+            }
+            continue;
+        }
+        if (result == nullptr) {
+            finish(connection, "");
+            return;
+        }
+        // Idle connections only see notices; a query keeps its first result
+        if (request == nullptr) {
+            PQclear(result);
+            continue;
+        }
+        const auto status = PQresultStatus(result);
+        if (status == PGRES_SINGLE_TUPLE) {
+            onRowArrived(*request, result);
+            continue;
+        }
+        if (status != PGRES_TUPLES_OK && status != PGRES_COMMAND_OK && request->error.empty()) {
+            request->error = PQresultErrorMessage(result);
+            while (!request->error.empty() && request->error.back() == '\n') {
+                request->error.pop_back();
+            }
+        }
+        if (request->result == nullptr) {
+            request->result = result;
+        } else {
+            PQclear(result);
+        }
+    }
+}
+
+void AsyncPostgreSQLDatabase::onRowArrived(Request& request, PGresult* row) {
+    PqResultSet rows(row);
+    // After a failed callback the rest of the rows are only drained
+    if (!request.error.empty()) {
+        return;
+    }
+    ++request.streamedRows;
+    request.streamedBytes += resultBytes(row);
+    try {
+        rows.next();
+        request.onRow(rows);
+    } catch (const std::exception& e) {
+        request.error = e.what();
+    }
+}
+
+void AsyncPostgreSQLDatabase::onWritable(Connection& connection) {
+    if (!flush(connection)) {
+        const auto error = connectionError(connection.handle);
+        reconnect(connection);
+        finish(connection, error);
+    }
+}
+
+void AsyncPostgreSQLDatabase::finish(Connection& connection, const std::string& error) {
+    connection.flushing = false;
+    Request* request = std::exchange(connection.active, nullptr);
+    if (request != nullptr && !error.empty() && request->error.empty()) {
+        request->error = error;
+    }
+    if (request != nullptr && request->watch) {
+        request->deadlineExceeded = !request->error.empty() && request->watch->fired();
+        // A cancel still in progress could reach the next statement, so the connection sits
+        // out until the watchdog reports it done; the loop itself never waits for it
+        Connection* const target = &connection;
+        const bool released = request->watch->release([this, target] {
+            post([this, target] {
+                target->settling.reset();
+                handOn(*target);
+            });
+        });
+        if (!released) {
+            connection.settling = std::move(request->watch);
+        }
+        request->watch.reset();
+    }
+
+    handOn(connection);
+    if (request != nullptr) {
+        resume(*request);
+    }
+}
+
+void AsyncPostgreSQLDatabase::handOn(Connection& connection) {
+    // Hand the connection to the oldest waiting query before resuming anyone
+    while (connection.active == nullptr && !connection.settling && !connection.resetting &&
+           !waiting.empty()) {
+        Request* next = waiting.front();
+        waiting.pop_front();
+        if (!start(connection, *next)) {
+            resume(*next);
+        }
+    }
+    watch(connection, EPOLL_CTL_MOD);
+}
+
+void AsyncPostgreSQLDatabase::resume(Request& request) {
+    request.done = true;
+    // The coroutine sends its next queries under its own request's deadline
+    RequestDeadline* const previous = std::exchange(currentDeadline, request.deadline);
+    if (request.batch == nullptr) {
+        request.waiter.resume();
+    } else if (--request.batch->remaining == 0) {
+        request.batch->waiter.resume();
+    }
+    currentDeadline = previous;
+}
+
+void AsyncPostgreSQLDatabase::recordStatement(const Request& request) {
+    const bool failed = request.deadlineExceeded || !request.error.empty();
+    uint64_t rows = request.streamedRows;
+    uint64_t bytes = request.streamedBytes;
+    if (!request.onRow && request.result != nullptr) {
+        rows = resultRows(request.result);
+        bytes = resultBytes(request.result);
+    }
+    statements.record(
+        request.sql, request.parameters.size(),
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - request.start),
+        failed, rows, bytes);
+}
+
+std::string AsyncPostgreSQLDatabase::reconnect(Connection& connection) {
+    if (connection.socket >= 0) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, connection.socket, nullptr);
+        connection.socket = -1;
+    }
+    connection.flushing = false;
+    if (!breaker->allowAttempt()) {
+        // Stays down; the next query on it tries again once the breaker lets it
+        const auto status = breaker->status();
+        return "Database unreachable, next attempt in " + std::to_string(status.retryIn.count()) +
+               " ms (" + status.lastError + ")";
+    }
+    if (PQresetStart(connection.handle) == 0) {
+        const auto error = connectionError(connection.handle);
+        breaker->recordFailure(error);
+        return error;
+    }
+
+    // libpq starts the reset as if PQresetPoll had asked to write
+    connection.resetting = true;
+    connection.flushing = true;
+    watchResetSocket(connection);
+    return "";
+}
+
+void AsyncPostgreSQLDatabase::continueReset(Connection& connection) {
+    const auto polled = PQresetPoll(connection.handle);
+    if (polled == PGRES_POLLING_READING || polled == PGRES_POLLING_WRITING) {
+        connection.flushing = polled == PGRES_POLLING_WRITING;
+        watchResetSocket(connection);
+        return;
+    }
+
+    connection.resetting = false;
+    connection.flushing = false;
+    // A socket libpq closed has already left epoll
+    if (const int socket = PQsocket(connection.handle); socket >= 0) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, socket, nullptr);
+    }
+    connection.socket = -1;
+    if (polled == PGRES_POLLING_OK) {
+        breaker->recordSuccess();
+        PQsetnonblocking(connection.handle, 1);
+        connected(connection);
+    } else {
+        breaker->recordFailure(connectionError(connection.handle));
+    }
+    // The queries that waited for the reset run now, or fail at once if it failed
+    handOn(connection);
+}
+
+void AsyncPostgreSQLDatabase::watchResetSocket(Connection& connection) {
+    // libpq may open a new socket at any step of the reset
+    const int socket = PQsocket(connection.handle);
+    if (socket != connection.socket) {
+        connection.socket = socket;
+        watch(connection, EPOLL_CTL_ADD);
+    } else {
+        watch(connection, EPOLL_CTL_MOD);
+    }
+}
+
+void AsyncPostgreSQLDatabase::connected(Connection& connection) {
+    // Prepared statements belong to the server session that was replaced
+    connection.prepared.clear();
+    connection.cancelKey = rdws::database::CancelKey(connection.handle, breaker);
+    connection.socket = PQsocket(connection.handle);
+    if (connection.socket >= 0) {
+        watch(connection, EPOLL_CTL_ADD);
+    }
+}
+
+void AsyncPostgreSQLDatabase::watch(Connection& connection, const int operation) const {
+    if (connection.socket < 0) {
+        return;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN | (connection.flushing ? EPOLLOUT : 0u);
+    event.data.ptr = &connection;
+    if (epoll_ctl(epollFd, operation, connection.socket, &event) < 0 && errno == ENOENT) {
+        // The descriptor was closed and its number reused for this connection's new socket
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, connection.socket, &event);
+    }
+}
+
+void AsyncPostgreSQLDatabase::runPostedTasks() {
+    std::vector<std::function<void()>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(postedMutex);
+        tasks.swap(posted);
+    }
+    for (auto& task : tasks) {
+        // A task starts without a deadline; the requests it starts bind their own
+        currentDeadline = nullptr;
+        task();
+    }
+    currentDeadline = nullptr;
+}
+
+void AsyncPostgreSQLDatabase::closeAll() {
+    for (const auto& connection : connections) {
+        PQfinish(connection->handle);
+    }
+    connections.clear();
+    for (const int fd : {wakeFd, epollFd}) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+    wakeFd = -1;
+    epollFd = -1;
+}
+
+} // namespace rdws::async
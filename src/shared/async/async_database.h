@@ -0,0 +1,272 @@
+#pragma once
+
+#include "../common/config/config.h"
+#include "../common/database/cancel_key.h"
+#include "../common/database/connection_breaker.h"
+#include "../common/database/deadline.h"
+#include "../common/database/idatabase.h"
+#include "../common/database/statement_stats.h"
+#include "task.h"
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <libpq-fe.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace rdws::async {
+
+/**
+ * RequestDeadline - Deadline of one request served on the loop thread
+ *
+ * Coroutine counterpart of DeadlineScope: requests interleave on the loop thread, so the
+ * deadline travels with each query rather than with the thread.
+ */
+struct RequestDeadline {
+    std::chrono::steady_clock::time_point at;
+    bool exceeded = false;  // A query gave up because the deadline had passed
+};
+
+/**
+ * AsyncPostgreSQLDatabase - Non-blocking libpq connections driven by one epoll loop
+ *
+ * Queries are sent with PQsendQueryParams and the awaiting coroutine is resumed on the
+ * loop thread once the result has arrived, so one thread keeps as many round-trips in
+ * flight as there are connections. Further queries wait in FIFO order for a free
+ * connection. query() and command() must be called on the loop thread (i.e. from
+ * coroutines started by a task passed to post()).
+ *
+ * It keeps the layers of PostgreSQLDatabase: statements are prepared on each connection
+ * the first time they run there, every statement is added to StatementMetrics, and a
+ * query past its request's deadline is canceled through the QueryWatchdog. Listings are
+ * streamed in single-row mode, a row at a time, instead of being read whole.
+ */
+class AsyncPostgreSQLDatabase {
+  public:
+    /**
+     * Queries awaited together through whenAll(); the waiter resumes once all completed
+     */
+    struct Batch {
+        std::coroutine_handle<> waiter;
+        size_t remaining = 0;
+    };
+
+    /**
+     * A query waiting for or holding a connection
+     */
+    struct Request {
+        std::string sql;
+        std::vector<std::string> parameters;
+        std::function<void(rdws::database::IResultSet&)> onRow;  // Set for streamed queries
+        std::coroutine_handle<> waiter;
+        Batch* batch = nullptr;  // Instead of waiter, when sent by whenAll()
+        bool done = false;
+        PGresult* result = nullptr;
+        std::string error;
+
+        RequestDeadline* deadline = nullptr;
+        std::unique_ptr<rdws::database::QueryWatchdog::Guard> watch;
+        bool deadlineExceeded = false;
+
+        std::string statementName;  // Being prepared; the query is sent once that completes
+        bool preparing = false;
+        std::chrono::steady_clock::time_point start;
+        uint64_t streamedRows = 0;
+        uint64_t streamedBytes = 0;
+    };
+
+    class BatchAwaitable;
+
+    /**
+     * Awaitable returned by query(); resumes with the rows or throws std::runtime_error,
+     * or DeadlineExceeded once the request's deadline has passed
+     */
+    class QueryAwaitable {
+      private:
+        friend class BatchAwaitable;
+
+        AsyncPostgreSQLDatabase& database;
+        Request request;
+
+      public:
+        QueryAwaitable(AsyncPostgreSQLDatabase& db, Request pending);
+        ~QueryAwaitable();
+
+        QueryAwaitable(const QueryAwaitable&) = delete;
+        QueryAwaitable& operator=(const QueryAwaitable&) = delete;
+
+        // Already completed when it was sent through whenAll()
+        [[nodiscard]] bool await_ready() const noexcept {
+            return request.done;
+        }
+        bool await_suspend(std::coroutine_handle<> awaiting);
+        std::unique_ptr<rdws::database::IResultSet> await_resume();
+    };
+
+    /**
+     * Awaitable returned by whenAll(); resumes once every query of the batch completed
+     */
+    class BatchAwaitable {
+      private:
+        AsyncPostgreSQLDatabase& database;
+        std::vector<QueryAwaitable*> queries;
+        Batch batch;
+
+      public:
+        BatchAwaitable(AsyncPostgreSQLDatabase& db, std::vector<QueryAwaitable*> sent);
+
+        BatchAwaitable(const BatchAwaitable&) = delete;
+        BatchAwaitable& operator=(const BatchAwaitable&) = delete;
+
+        [[nodiscard]] bool await_ready() const noexcept {
+            return queries.empty();
+        }
+        bool await_suspend(std::coroutine_handle<> awaiting);
+        void await_resume() const noexcept {}
+    };
+
+    // Statements kept prepared on each connection, like PostgreSQLDatabase
+    static constexpr size_t maxPreparedStatements = 256;
+
+  private:
+    struct Connection {
+        PGconn* handle = nullptr;
+        int socket = -1;
+        rdws::database::CancelKey cancelKey;  // Taken on connect, used from the watchdog
+        Request* active = nullptr;
+        // Waiting for EPOLLOUT: query not fully written yet, or the reset needs to write
+        bool flushing = false;
+        bool resetting = false;  // Reconnect in progress, driven by PQresetPoll
+        // Guard of the last statement while its cancel is still in progress; the connection
+        // runs nothing else until then
+        std::unique_ptr<rdws::database::QueryWatchdog::Guard> settling;
+        std::unordered_map<std::string, std::string> prepared;  // SQL -> statement name
+    };
+
+    rdws::Config config;
+    // Shared with every connection of the process to the same server
+    std::shared_ptr<rdws::database::ConnectionBreaker> breaker;
+    std::vector<std::unique_ptr<Connection>> connections;
+    std::deque<Request*> waiting;
+    std::string lastError;
+    rdws::database::StatementRecorder statements;
+    RequestDeadline* currentDeadline = nullptr;
+
+    int epollFd = -1;
+    int wakeFd = -1;
+    bool running = false;
+    std::atomic<bool> stopRequested{false};
+    std::mutex postedMutex;
+    std::vector<std::function<void()>> posted;
+
+  public:
+    /**
+     * Open the connections (blocking) and switch them to non-blocking mode
+     * @param dbConfig Connection settings
+     * @param connectionCount Maximum number of queries in flight
+     * @throws std::runtime_error when a connection cannot be established
+     */
+    AsyncPostgreSQLDatabase(const rdws::Config& dbConfig, size_t connectionCount);
+    ~AsyncPostgreSQLDatabase();
+
+    AsyncPostgreSQLDatabase(const AsyncPostgreSQLDatabase&) = delete;
+    AsyncPostgreSQLDatabase& operator=(const AsyncPostgreSQLDatabase&) = delete;
+
+    /**
+     * Run a parameterized query; co_await the result
+     */
+    QueryAwaitable query(std::string sql, std::vector<std::string> parameters = {});
+
+    /**
+     * Run a query and hand each row to onRow as it arrives; co_await completion
+     * The row is only valid during the call, which runs on the loop thread. Rows are not
+     * buffered, so memory stays at one row whatever the size of the result.
+     */
+    QueryAwaitable stream(std::string sql, std::vector<std::string> parameters,
+                          std::function<void(rdws::database::IResultSet&)> onRow);
+
+    /**
+     * Send queries at once and co_await until all of them completed
+     * Independent statements then run on separate connections at the same time instead of
+     * one after the other. Each result is read afterwards by co_awaiting its query, which
+     * no longer suspends and throws as it would have on its own.
+     */
+    template <typename... Queries> BatchAwaitable whenAll(Queries&... queries) {
+        return {*this, {&queries...}};
+    }
+
+    /**
+     * Run a command (INSERT, UPDATE, DELETE)
+     * @return false on failure, with the reason in getLastError()
+     */
+    Task<bool> command(std::string sql, std::vector<std::string> parameters = {});
+
+    /**
+     * Bind the queries the running coroutine sends from now on to deadline (none: nullptr)
+     * The loop restores the binding of a query's coroutine whenever it resumes it, so one
+     * call when a request starts covers all of the request's queries.
+     */
+    void bindDeadline(RequestDeadline* deadline) {
+        currentDeadline = deadline;
+    }
+
+    /**
+     * Drive the connections until stop() is called
+     */
+    void run();
+
+    /**
+     * Ask the loop to exit; thread-safe
+     */
+    void stop();
+
+    /**
+     * Run a task on the loop thread; thread-safe
+     */
+    void post(std::function<void()> task);
+
+    [[nodiscard]] size_t getConnectionCount() const {
+        return connections.size();
+    }
+
+    [[nodiscard]] std::string getLastError() const {
+        return lastError;
+    }
+
+  private:
+    Request makeRequest(std::string sql, std::vector<std::string> parameters);
+    bool submit(Request& request);
+    bool start(Connection& connection, Request& request);
+    // Send the query, or the prepare of its statement the first time it runs on connection
+    bool send(Connection& connection, Request& request);
+    bool sendQuery(Connection& connection, Request& request, const std::string* statementName);
+    bool flush(Connection& connection);
+    void onReadable(Connection& connection);
+    void onRowArrived(Request& request, PGresult* row);
+    void resume(Request& request);
+    void recordStatement(const Request& request);
+    void onWritable(Connection& connection);
+    void finish(Connection& connection, const std::string& error);
+    // Start the oldest waiting queries on connection once it is free
+    void handOn(Connection& connection);
+    // Start resetting a dropped connection without blocking the loop; it takes no query until
+    // continueReset completes. Skipped while the ConnectionBreaker is open.
+    // @return empty once the reset is under way, otherwise why it was not started
+    std::string reconnect(Connection& connection);
+    void continueReset(Connection& connection);
+    void watchResetSocket(Connection& connection);
+    void connected(Connection& connection);
+    void watch(Connection& connection, int operation) const;
+    void runPostedTasks();
+    void closeAll();
+};
+
+} // namespace rdws::async
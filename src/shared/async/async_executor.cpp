@@ -0,0 +1,83 @@
+#include "async_executor.h"
+
+#include "../controllers/base_controller.h"
+
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+using rdws::controllers::BaseController;
+using rdws::server::HandlerResponse;
+using rdws::server::RequestJob;
+
+namespace rdws::async {
+
+AsyncExecutor::AsyncExecutor(std::shared_ptr<AsyncPostgreSQLDatabase> database,
+                             std::unique_ptr<AsyncRequestHandler> requestHandler)
+    : db(std::move(database)), handler(std::move(requestHandler)) {
+    loop = std::thread([this] {
+        try {
+            db->run();
+        } catch (const std::exception& e) {
+            std::cerr << BaseController::formatServiceError(e.what()) << std::endl;
+        }
+    });
+}
+
+AsyncExecutor::~AsyncExecutor() {
+    AsyncExecutor::shutdown();
+}
+
+void AsyncExecutor::submit(RequestJob job) {
+    if (!loop.joinable()) {
+        throw std::runtime_error("Executor is shut down");
+    }
+    // std::function needs a copyable target
+    auto pending = std::make_shared<RequestJob>(std::move(job));
+    db->post([this, pending] {
+        ++activeRequests;
+        runJob(std::move(*pending));
+    });
+}
+
+void AsyncExecutor::shutdown() {
+    if (!loop.joinable()) {
+        return;
+    }
+    db->post([this] {
+        draining = true;
+        if (activeRequests == 0) {
+            db->stop();
+        }
+    });
+    loop.join();
+}
+
+Detached AsyncExecutor::runJob(RequestJob job) {
+    // What invokeHandler's DeadlineScope is to the other executors; the frame outlives
+    // every query of the request
+    RequestDeadline deadline{std::chrono::steady_clock::now() + job.context.getRemainingTimeMs()};
+    db->bindDeadline(&deadline);
+
+    HandlerResponse response;
+    try {
+        response = co_await handler->handle(job.event, job.context);
+    } catch (const std::exception& e) {
+        if (!deadline.exceeded) {
+            job.context.log(std::string("Unhandled error: ") + e.what(), "ERROR");
+            response = {BaseController::formatServiceError(e.what()), 1, 500};
+        }
+    }
+    if (deadline.exceeded) {
+        response = rdws::server::deadlineExceededResponse(job.context);
+    }
+    job.complete(std::move(response));
+
+    if (--activeRequests == 0 && draining) {
+        db->stop();
+    }
+}
+
+} // namespace rdws::async
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "../server/request_executor.h"
+#include "async_database.h"
+#include "task.h"
+
+#include <memory>
+#include <thread>
+
+namespace rdws::async {
+
+/**
+ * AsyncRequestHandler - Coroutine counterpart of server::RequestHandler
+ */
+class AsyncRequestHandler {
+  public:
+    virtual ~AsyncRequestHandler() = default;
+
+    virtual Task<rdws::server::HandlerResponse>
+    handle(rdws::types::LambdaEvent& event, const rdws::types::LambdaContext& context) = 0;
+};
+
+/**
+ * AsyncExecutor - Runs coroutine handlers on the database loop thread
+ *
+ * Every submitted request becomes a coroutine that is suspended while its queries are
+ * in flight, so a single thread serves as many concurrent requests as the database has
+ * connections. shutdown() waits for running requests before stopping the loop.
+ */
+class AsyncExecutor : public rdws::server::RequestExecutor {
+  private:
+    std::shared_ptr<AsyncPostgreSQLDatabase> db;
+    std::unique_ptr<AsyncRequestHandler> handler;
+    std::thread loop;
+    size_t activeRequests = 0;  // loop thread only
+    bool draining = false;      // loop thread only
+
+  public:
+    /**
+     * Start the database loop thread
+     * @param database Connections used by the handler
+     * @param requestHandler Handler run for every request
+     */
+    AsyncExecutor(std::shared_ptr<AsyncPostgreSQLDatabase> database,
+                  std::unique_ptr<AsyncRequestHandler> requestHandler);
+    ~AsyncExecutor() override;
+
+    void submit(rdws::server::RequestJob job) override;
+    void shutdown() override;
+
+  private:
+    Detached runJob(rdws::server::RequestJob job);
+};
+
+} // namespace rdws::async
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace rdws::async {
+
+namespace detail {
+
+// Resumes the coroutine that awaited a task once the task finishes
+struct FinalAwaiter {
+    [[nodiscard]] bool await_ready() const noexcept {
+        return false;
+    }
+
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> finished) const noexcept {
+        if (const auto continuation = finished.promise().continuation) {
+            return continuation;
+        }
+        return std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+};
+
+} // namespace detail
+
+/**
+ * Task - Lazily started coroutine producing a T
+ *
+ * The body starts running when the task is co_awaited and the awaiting coroutine is
+ * resumed (by symmetric transfer) when it finishes. Exceptions propagate to the awaiter.
+ */
+template <typename T> class [[nodiscard]] Task {
+  public:
+    struct promise_type {
+        std::coroutine_handle<> continuation;
+        std::optional<T> value;
+        std::exception_ptr exception;
+
+        Task get_return_object() {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() const noexcept {
+            return {};
+        }
+        detail::FinalAwaiter final_suspend() const noexcept {
+            return {};
+        }
+        void return_value(T result) {
+            value.emplace(std::move(result));
+        }
+        void unhandled_exception() noexcept {
+            exception = std::current_exception();
+        }
+    };
+
+  private:
+    std::coroutine_handle<promise_type> coroutine;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : coroutine(handle) {}
+
+  public:
+    Task(Task&& other) noexcept : coroutine(std::exchange(other.coroutine, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (coroutine) {
+                coroutine.destroy();
+            }
+            coroutine = std::exchange(other.coroutine, {});
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        if (coroutine) {
+            coroutine.destroy();
+        }
+    }
+
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> coroutine;
+
+            [[nodiscard]] bool await_ready() const noexcept {
+                return false;
+            }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                coroutine.promise().continuation = awaiting;
+                return coroutine;
+            }
+            T await_resume() {
+                auto& promise = coroutine.promise();
+                if (promise.exception) {
+                    std::rethrow_exception(promise.exception);
+                }
+                return std::move(*promise.value);
+            }
+        };
+        return Awaiter{coroutine};
+    }
+};
+
+/**
+ * Detached - Coroutine that starts immediately and frees itself when done
+ * Used at the top of a coroutine chain, where nobody awaits the result.
+ */
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() const noexcept {
+            return {};
+        }
+        std::suspend_never initial_suspend() const noexcept {
+            return {};
+        }
+        std::suspend_never final_suspend() const noexcept {
+            return {};
+        }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept {
+            std::terminate();
+        }
+    };
+};
+
+} // namespace rdws::async
@@ -2,6 +2,8 @@
 
 #include "dotenv.h"
 
+#include <array>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -9,6 +11,19 @@
 
 namespace rdws {
 
+namespace {
+
+// Every variable read by loadEnvironmentVariables
+constexpr std::array<const char*, 6> environmentKeys = {
+    "RDWS_ENVIRONMENT", "DB_PORT", "DB_HOST", "DB_USER", "DB_PASS", "DB_NAME",
+};
+
+// Optional, so left out of environmentKeys: a missing one must not force a .env read
+constexpr std::array<const char*, 4> optionalKeys = {"DB_REPLICA_HOSTS", "DB_REPLICA_MAX_LAG_MS",
+                                                     "DB_SLOW_QUERY_MS", "SERVICE_TIMEOUT"};
+
+} // namespace
+
 Config::Config() {
     loadEnvironmentVariables();
 }
@@ -51,6 +66,43 @@ std::string Config::getConnectionString() const {
     return oss.str();
 }
 
+std::vector<std::string> Config::getReplicaHosts() const {
+    std::vector<std::string> hosts;
+    std::stringstream stream(get("DB_REPLICA_HOSTS").value_or(""));
+    std::string host;
+    while (std::getline(stream, host, ',')) {
+        const auto first = host.find_first_not_of(" \t");
+        if (first != std::string::npos) {
+            hosts.push_back(host.substr(first, host.find_last_not_of(" \t") - first + 1));
+        }
+    }
+    return hosts;
+}
+
+Config Config::forReplica(const std::string& replicaHost) const {
+    Config replica = *this;
+    if (const auto colon = replicaHost.rfind(':'); colon != std::string::npos) {
+        replica.set("DB_HOST", replicaHost.substr(0, colon));
+        replica.set("DB_PORT", replicaHost.substr(colon + 1));
+    } else {
+        replica.set("DB_HOST", replicaHost);
+    }
+    return replica;
+}
+
+std::chrono::milliseconds Config::getReplicaMaxLag() const {
+    return std::chrono::milliseconds(std::stol(get("DB_REPLICA_MAX_LAG_MS").value_or("1000")));
+}
+
+std::chrono::milliseconds Config::getSlowQueryThreshold() const {
+    return std::chrono::milliseconds(std::stol(get("DB_SLOW_QUERY_MS").value_or("0")));
+}
+
+std::chrono::milliseconds Config::getRequestTimeout() const {
+    // Same variable and default as the gateway's timeout
+    return std::chrono::milliseconds(std::stol(get("SERVICE_TIMEOUT").value_or("5000")));
+}
+
 std::string Config::getEnvironment() const {
     return get("RDWS_ENVIRONMENT").value_or("development");
 }
@@ -64,8 +116,11 @@ bool Config::isProduction() const {
 }
 
 void Config::loadEnvironmentVariables() {
-    // Also try generic .env file
-    loadEnvFile("../.env");
+    // Also try generic .env file, unless the parent (e.g. the gateway) already exported
+    // everything: a spawned-per-request process would pay for the file read on every call
+    if (!hasAllEnvVars()) {
+        loadEnvFile("../.env");
+    }
 
     // Load from environment variables
     settings["RDWS_ENVIRONMENT"] = getEnvVar("RDWS_ENVIRONMENT").value_or("test");
@@ -75,6 +130,11 @@ void Config::loadEnvironmentVariables() {
     settings["DB_PASS"] = getEnvVar("DB_PASS").value_or("db_psswd");
     settings["DB_NAME"] =
         getEnvVar("DB_NAME").value_or("db_name"); // Will be set by getDatabaseName()
+    for (const char* key : optionalKeys) {
+        if (const auto value = getEnvVar(key)) {
+            settings[key] = *value;
+        }
+    }
 }
 
 std::optional<std::string> Config::getEnvVar(const std::string& name) {
@@ -82,6 +142,15 @@ std::optional<std::string> Config::getEnvVar(const std::string& name) {
     return value != nullptr ? std::optional<std::string>{value} : std::nullopt;
 }
 
+bool Config::hasAllEnvVars() {
+    for (const char* key : environmentKeys) {
+        if (std::getenv(key) == nullptr) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void Config::loadEnvFile(const std::string& filename) {
     const auto filePath = (std::filesystem::current_path() / filename).string();
     dotenv::init(filePath.c_str());
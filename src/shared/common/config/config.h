@@ -1,8 +1,10 @@
 #pragma once
 
+#include <chrono>
 #include <map>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace rdws {
 
@@ -27,6 +29,17 @@ class Config {
     [[nodiscard]] std::string getDatabasePassword() const;
     [[nodiscard]] std::string getConnectionString() const;
 
+    // Read replicas (DB_REPLICA_HOSTS="host[:port],..."; empty when there are none)
+    [[nodiscard]] std::vector<std::string> getReplicaHosts() const;
+    // Copy of this configuration that connects to the given replica instead of DB_HOST
+    [[nodiscard]] Config forReplica(const std::string& replicaHost) const;
+    // How far behind the primary a replica may be and still serve reads
+    [[nodiscard]] std::chrono::milliseconds getReplicaMaxLag() const;
+    // Statements slower than this are logged (DB_SLOW_QUERY_MS; 0 = off)
+    [[nodiscard]] std::chrono::milliseconds getSlowQueryThreshold() const;
+    // Budget of a request that arrives without the gateway's context (SERVICE_TIMEOUT)
+    [[nodiscard]] std::chrono::milliseconds getRequestTimeout() const;
+
     // Environment detection
     [[nodiscard]] std::string getEnvironment() const;
     [[nodiscard]] bool isDevelopment() const;
@@ -35,6 +48,7 @@ class Config {
   private:
     void loadEnvironmentVariables();
     static void loadEnvFile(const std::string& filename);
+    [[nodiscard]] static bool hasAllEnvVars();
     [[nodiscard]] static std::optional<std::string> getEnvVar(const std::string& name);
 };
 
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace rdws::database {
+
+/**
+ * Encode values as one PostgreSQL array literal, e.g. {"Ana","O\"Neil"}
+ *
+ * Lets a whole batch travel as a single text parameter that the statement casts back
+ * ($1::text[]), so set-based statements need one round trip and one plan per batch.
+ * Every element is quoted; backslashes and double quotes are escaped.
+ */
+inline std::string toArrayLiteral(const std::vector<std::string>& values) {
+    size_t length = 2;
+    for (const auto& value : values) {
+        length += value.size() + 3;
+    }
+
+    std::string literal;
+    literal.reserve(length);
+    literal += '{';
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i > 0) {
+            literal += ',';
+        }
+        literal += '"';
+        for (const char c : values[i]) {
+            if (c == '"' || c == '\\') {
+                literal += '\\';
+            }
+            literal += c;
+        }
+        literal += '"';
+    }
+    literal += '}';
+    return literal;
+}
+
+/**
+ * Encode integers as a PostgreSQL array literal, e.g. {1,2,3}; cast it with $1::int[]
+ */
+inline std::string toArrayLiteral(const std::vector<int>& values) {
+    std::string literal;
+    literal.reserve(2 + values.size() * 8);
+    literal += '{';
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i > 0) {
+            literal += ',';
+        }
+        literal += std::to_string(values[i]);
+    }
+    literal += '}';
+    return literal;
+}
+
+} // namespace rdws::database
@@ -0,0 +1,26 @@
+#include "cancel_key.h"
+
+#include <array>
+#include <string>
+#include <utility>
+
+namespace rdws::database {
+
+CancelKey::CancelKey(PGconn* connection, std::shared_ptr<ConnectionBreaker> serverBreaker)
+    : handle(PQgetCancel(connection), PQfreeCancel), breaker(std::move(serverBreaker)) {}
+
+void CancelKey::cancel() const {
+    if (!handle) {
+        return;
+    }
+    if (breaker && breaker->status().state != ConnectionBreaker::State::Closed) {
+        return;
+    }
+
+    std::array<char, 256> error{};
+    if (PQcancel(handle.get(), error.data(), static_cast<int>(error.size())) == 0 && breaker) {
+        breaker->recordFailure("Cancel request failed: " + std::string(error.data()));
+    }
+}
+
+} // namespace rdws::database
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "connection_breaker.h"
+
+#include <libpq-fe.h>
+#include <memory>
+
+namespace rdws::database {
+
+/**
+ * CancelKey - Cancel request for whatever statement runs on one connection
+ *
+ * Taken with PQgetCancel by the thread that owns the connection, when it connects. cancel()
+ * may then run on any thread while the connection is busy: PQcancel hands the backend's key
+ * to the server over a socket of its own, with no login and no session. Copies share the key,
+ * so a cancel in flight keeps it after the connection is closed or replaced.
+ */
+class CancelKey {
+  private:
+    std::shared_ptr<PGcancel> handle;
+    std::shared_ptr<ConnectionBreaker> breaker;
+
+  public:
+    CancelKey() = default;
+    CancelKey(PGconn* connection, std::shared_ptr<ConnectionBreaker> serverBreaker);
+
+    /**
+     * Ask the server to cancel the connection's running statement
+     * Skipped while the server's breaker is not closed, as the server is not reachable;
+     * the session's statement_timeout stops the statement then. A cancel that cannot reach
+     * the server is a failed attempt for the breaker.
+     */
+    void cancel() const;
+};
+
+} // namespace rdws::database
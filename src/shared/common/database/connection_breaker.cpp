@@ -0,0 +1,115 @@
+#include "connection_breaker.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <utility>
+
+namespace rdws::database {
+
+namespace {
+
+std::mutex breakersMutex;
+std::map<std::string, std::shared_ptr<ConnectionBreaker>> breakers;
+
+} // namespace
+
+ConnectionBreaker::ConnectionBreaker(std::string breakerTarget, const Options breakerOptions)
+    : target(std::move(breakerTarget)), options(breakerOptions) {}
+
+std::shared_ptr<ConnectionBreaker> ConnectionBreaker::forDatabase(const rdws::Config& config) {
+    // Credentials stay out of the target: it is shown on /health
+    const std::string target = config.getDatabaseHost() + ":" + config.getDatabasePort() + "/" +
+                               config.getDatabaseName();
+
+    std::lock_guard<std::mutex> lock(breakersMutex);
+    auto& breaker = breakers[target];
+    if (!breaker) {
+        breaker = std::make_shared<ConnectionBreaker>(target, Options{});
+    }
+    return breaker;
+}
+
+std::vector<ConnectionBreaker::Status> ConnectionBreaker::processStatus() {
+    std::vector<std::shared_ptr<ConnectionBreaker>> all;
+    {
+        std::lock_guard<std::mutex> lock(breakersMutex);
+        for (const auto& [target, breaker] : breakers) {
+            all.push_back(breaker);
+        }
+    }
+
+    std::vector<Status> statuses;
+    statuses.reserve(all.size());
+    for (const auto& breaker : all) {
+        statuses.push_back(breaker->status());
+    }
+    return statuses;
+}
+
+bool ConnectionBreaker::allowAttempt() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (state == State::Closed) {
+        return true;
+    }
+    if (state == State::Open && Clock::now() >= retryAt) {
+        state = State::HalfOpen;  // This caller is the probe
+        return true;
+    }
+    ++rejected;
+    return false;
+}
+
+void ConnectionBreaker::recordSuccess() {
+    std::lock_guard<std::mutex> lock(mutex);
+    state = State::Closed;
+    consecutiveFailures = 0;
+    lastError.clear();
+}
+
+void ConnectionBreaker::recordFailure(const std::string& error) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ++consecutiveFailures;
+    lastError = error;
+    state = State::Open;
+    retryAt = Clock::now() + nextDelay();
+}
+
+ConnectionBreaker::Status ConnectionBreaker::status() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Status current;
+    current.target = target;
+    current.state = state;
+    current.consecutiveFailures = consecutiveFailures;
+    current.rejected = rejected;
+    current.lastError = lastError;
+    if (state == State::Open) {
+        current.retryIn = std::max(std::chrono::milliseconds(0),
+                                   std::chrono::duration_cast<std::chrono::milliseconds>(
+                                       retryAt - Clock::now()));
+    }
+    return current;
+}
+
+const char* ConnectionBreaker::stateName(const State state) {
+    switch (state) {
+        case State::Closed:
+            return "closed";
+        case State::Open:
+            return "open";
+        case State::HalfOpen:
+            return "half-open";
+    }
+    return "unknown";
+}
+
+ConnectionBreaker::Clock::duration ConnectionBreaker::nextDelay() const {
+    const auto doublings = std::min<uint64_t>(consecutiveFailures - 1, 20);
+    const auto delay = std::min(options.maxDelay, options.baseDelay * (int64_t{1} << doublings));
+
+    thread_local std::mt19937_64 random{std::random_device{}()};
+    std::uniform_int_distribution<int64_t> jitter(delay.count() / 2, delay.count());
+    return std::chrono::milliseconds(jitter(random));
+}
+
+} // namespace rdws::database
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "../config/config.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace rdws::database {
+
+/**
+ * ConnectionBreaker - Circuit breaker for connection attempts to one database server
+ *
+ * Shared by every connection of the process to the same server, so an outage costs one
+ * connect timeout per backoff period instead of one per request. A failed attempt opens the
+ * circuit for an exponential, jittered delay; while it is open, attempts fail at once. Once
+ * the delay has passed the circuit is half-open: a single caller probes with a real attempt
+ * while the others keep failing fast, and the probe's outcome closes or reopens it.
+ */
+class ConnectionBreaker {
+  public:
+    enum class State { Closed, Open, HalfOpen };
+
+    struct Options {
+        std::chrono::milliseconds baseDelay{250};
+        std::chrono::milliseconds maxDelay{30000};
+    };
+
+    struct Status {
+        std::string target;
+        State state = State::Closed;
+        uint64_t consecutiveFailures = 0;
+        uint64_t rejected = 0;  // Attempts failed fast while open
+        std::chrono::milliseconds retryIn{0};
+        std::string lastError;
+    };
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    const std::string target;
+    const Options options;
+    mutable std::mutex mutex;
+    State state = State::Closed;
+    uint64_t consecutiveFailures = 0;
+    uint64_t rejected = 0;
+    Clock::time_point retryAt;
+    std::string lastError;
+
+  public:
+    ConnectionBreaker(std::string breakerTarget, Options breakerOptions);
+
+    ConnectionBreaker(const ConnectionBreaker&) = delete;
+    ConnectionBreaker& operator=(const ConnectionBreaker&) = delete;
+
+    /**
+     * Breaker of the process for the server and database of config, created on first use
+     */
+    static std::shared_ptr<ConnectionBreaker> forDatabase(const rdws::Config& config);
+
+    /**
+     * Status of every breaker of the process, for the health endpoint
+     */
+    static std::vector<Status> processStatus();
+
+    /**
+     * Whether the caller may try to connect now; false while open or while another
+     * caller is probing. A true answer must be followed by recordSuccess or recordFailure.
+     */
+    bool allowAttempt();
+
+    void recordSuccess();
+    void recordFailure(const std::string& error);
+
+    [[nodiscard]] Status status() const;
+
+    static const char* stateName(State state);
+
+  private:
+    // Backoff before the next probe: baseDelay doubled per failure, capped at maxDelay,
+    // then drawn from its upper half so the processes of a fleet do not retry in step
+    [[nodiscard]] Clock::duration nextDelay() const;
+};
+
+} // namespace rdws::database
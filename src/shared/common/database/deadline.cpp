@@ -0,0 +1,144 @@
+#include "deadline.h"
+
+#include <exception>
+#include <utility>
+
+namespace rdws::database {
+
+namespace {
+
+thread_local DeadlineScope* currentScope = nullptr;
+
+} // namespace
+
+// DeadlineScope Implementation
+
+DeadlineScope::DeadlineScope(const std::chrono::milliseconds remaining)
+    : deadline(Clock::now() + remaining), parent(currentScope) {
+    currentScope = this;
+}
+
+DeadlineScope::~DeadlineScope() {
+    currentScope = parent;
+}
+
+std::optional<DeadlineScope::Clock::time_point> DeadlineScope::current() {
+    if (currentScope == nullptr) {
+        return std::nullopt;
+    }
+    return currentScope->deadline;
+}
+
+void DeadlineScope::markExceeded() {
+    if (currentScope != nullptr) {
+        currentScope->exceeded = true;
+    }
+}
+
+// QueryWatchdog Implementation
+
+QueryWatchdog::Guard::Guard(const Clock::time_point deadline, std::function<void()> cancel)
+    : watchdog(QueryWatchdog::process()), key(watchdog.watch(deadline, std::move(cancel))) {}
+
+QueryWatchdog::Guard::~Guard() {
+    watchdog.unwatch(key);
+}
+
+bool QueryWatchdog::Guard::fired() const {
+    return !watchdog.isPending(key);
+}
+
+bool QueryWatchdog::Guard::release(std::function<void()> onSettled) {
+    return watchdog.release(key, std::move(onSettled));
+}
+
+QueryWatchdog::QueryWatchdog() : thread([this] { run(); }) {}
+
+QueryWatchdog::~QueryWatchdog() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+QueryWatchdog& QueryWatchdog::process() {
+    static QueryWatchdog watchdog;
+    return watchdog;
+}
+
+QueryWatchdog::Key QueryWatchdog::watch(const Clock::time_point deadline,
+                                        std::function<void()> cancel) {
+    Key key;
+    bool soonest = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        key = {deadline, ++nextId};
+        pending.emplace(key, std::move(cancel));
+        soonest = pending.begin()->first == key;
+    }
+    if (soonest) {
+        wake.notify_one();
+    }
+    return key;
+}
+
+void QueryWatchdog::unwatch(const Key& key) {
+    std::unique_lock<std::mutex> lock(mutex);
+    pending.erase(key);
+    cancelDone.wait(lock, [this, &key] { return cancelling != key; });
+}
+
+bool QueryWatchdog::release(const Key& key, std::function<void()> onSettled) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.erase(key);
+    if (cancelling != key) {
+        return true;
+    }
+    onCancelled = std::move(onSettled);
+    return false;
+}
+
+bool QueryWatchdog::isPending(const Key& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pending.count(key) != 0;
+}
+
+void QueryWatchdog::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        if (pending.empty()) {
+            wake.wait(lock);
+            continue;
+        }
+        if (wake.wait_until(lock, pending.begin()->first.first) != std::cv_status::timeout) {
+            continue;  // New soonest deadline, finished statement or shutdown
+        }
+
+        // One at a time and unlocked: a slow cancel holds up neither watch() nor the guards
+        // of other statements, which can still drop their expired entries meanwhile
+        const auto now = Clock::now();
+        while (!stopping && !pending.empty() && pending.begin()->first.first <= now) {
+            auto entry = pending.extract(pending.begin());
+            cancelling = entry.key();
+            lock.unlock();
+            try {
+                entry.mapped()();
+            } catch (const std::exception&) {
+                // The statement timeout set on the session still stops it server-side
+            }
+            lock.lock();
+            // Still marked as cancelling, so a guard destroyed meanwhile waits for this too
+            if (auto settled = std::exchange(onCancelled, nullptr)) {
+                lock.unlock();
+                settled();
+                lock.lock();
+            }
+            cancelling.reset();
+            cancelDone.notify_all();
+        }
+    }
+}
+
+} // namespace rdws::database
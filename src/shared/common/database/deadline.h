@@ -0,0 +1,128 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace rdws::database {
+
+/**
+ * Thrown by a database call once the request's deadline has passed
+ */
+class DeadlineExceeded : public std::runtime_error {
+  public:
+    DeadlineExceeded() : std::runtime_error("Request deadline exceeded") {}
+};
+
+/**
+ * DeadlineScope - Deadline of the request being handled on this thread
+ *
+ * Opened by the request executor around a handler, so database calls deep inside services
+ * and repositories see the remaining budget without every signature carrying it. Scopes
+ * nest; the innermost one applies.
+ */
+class DeadlineScope {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+  private:
+    Clock::time_point deadline;
+    bool exceeded = false;
+    DeadlineScope* parent;
+
+  public:
+    explicit DeadlineScope(std::chrono::milliseconds remaining);
+    ~DeadlineScope();
+    DeadlineScope(const DeadlineScope&) = delete;
+    DeadlineScope& operator=(const DeadlineScope&) = delete;
+
+    /**
+     * Whether a database call of this scope gave up because the deadline had passed
+     */
+    [[nodiscard]] bool wasExceeded() const {
+        return exceeded;
+    }
+
+    /**
+     * Deadline of the innermost scope of this thread; empty outside any scope
+     */
+    static std::optional<Clock::time_point> current();
+
+    /**
+     * Record that the current scope's deadline cut a database call short
+     */
+    static void markExceeded();
+};
+
+/**
+ * QueryWatchdog - One thread that cancels statements still running at their deadline
+ */
+class QueryWatchdog {
+  public:
+    using Clock = std::chrono::steady_clock;
+    using Key = std::pair<Clock::time_point, uint64_t>;
+
+    /**
+     * Watches one statement for the lifetime of the guard; cancel runs on the watchdog
+     * thread if the deadline passes first, so it must not touch the connection itself.
+     * The destructor waits if this statement's cancel is in progress, so it cannot reach
+     * the connection's next statement.
+     */
+    class Guard {
+      private:
+        QueryWatchdog& watchdog;
+        Key key;
+
+      public:
+        Guard(Clock::time_point deadline, std::function<void()> cancel);
+        ~Guard();
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        [[nodiscard]] bool fired() const;
+
+        /**
+         * Stop watching without waiting, for a thread that must not block
+         * @return true when no cancel is in progress. Otherwise onSettled runs on the
+         *         watchdog thread once the cancel is done; until then the connection must
+         *         run nothing else, and the guard must be kept (its destructor still waits).
+         */
+        bool release(std::function<void()> onSettled);
+    };
+
+  private:
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable cancelDone;
+    std::map<Key, std::function<void()>> pending;  // Soonest deadline first
+    std::optional<Key> cancelling;                  // Runs without the mutex held
+    std::function<void()> onCancelled;              // Of a guard released during the cancel
+    uint64_t nextId = 0;
+    bool stopping = false;
+    std::thread thread;
+
+    QueryWatchdog();
+
+  public:
+    ~QueryWatchdog();
+    QueryWatchdog(const QueryWatchdog&) = delete;
+    QueryWatchdog& operator=(const QueryWatchdog&) = delete;
+
+    static QueryWatchdog& process();
+
+  private:
+    Key watch(Clock::time_point deadline, std::function<void()> cancel);
+    void unwatch(const Key& key);
+    bool release(const Key& key, std::function<void()> onSettled);
+    bool isPending(const Key& key);
+    void run();
+};
+
+} // namespace rdws::database
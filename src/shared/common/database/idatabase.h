@@ -1,8 +1,12 @@
 #pragma once
 
+#include <functional>
+#include <future>
 #include <memory>
 #include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace rdws::database {
@@ -27,36 +31,155 @@ class IResultSet {
     virtual size_t getColumnCount() = 0;
     virtual std::vector<std::string> getColumnNames() = 0;
     virtual size_t getRowCount() = 0;
+
+    // Positional access: resolve a column once with getColumnIndex, then read it by index
+    // without a name lookup per field. The defaults map back to the named accessors.
+    virtual size_t getColumnIndex(const std::string& columnName) {
+        const auto names = getColumnNames();
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (names[i] == columnName) {
+                return i;
+            }
+        }
+        throw std::runtime_error("Unknown column: " + columnName);
+    }
+    virtual std::string getStringAt(size_t column) {
+        return getString(getColumnNames().at(column));
+    }
+    virtual int getIntAt(size_t column) {
+        return getInt(getColumnNames().at(column));
+    }
+    virtual double getDoubleAt(size_t column) {
+        return getDouble(getColumnNames().at(column));
+    }
+    virtual bool getBoolAt(size_t column) {
+        return getBool(getColumnNames().at(column));
+    }
+    virtual bool isNullAt(size_t column) {
+        return isNull(getColumnNames().at(column));
+    }
+
+    // Zero-copy access: the field's text as a view into the result's own storage, valid for
+    // the lifetime of the result set rather than the current row. NULL reads as an empty
+    // view. getStringViewAt has no default: an implementation without such storage, like
+    // a test double, must keep the text itself.
+    virtual std::string_view getStringView(const std::string& columnName) {
+        return getStringViewAt(getColumnIndex(columnName));
+    }
+    virtual std::string_view getStringViewAt(size_t column) = 0;
+
+    // Text of count fields of the current row in one call, as views like getStringViewAt and
+    // std::nullopt for NULL. Lets a RowMapper read a row with one virtual call, not one per
+    // field; the default reads them one at a time.
+    virtual void getRowText(const size_t* columns, const size_t count,
+                            std::optional<std::string_view>* fields) {
+        for (size_t i = 0; i < count; ++i) {
+            fields[i] = isNullAt(columns[i]) ? std::nullopt
+                                             : std::optional(getStringViewAt(columns[i]));
+        }
+    }
 };
 
 class IDatabase {
   public:
+    // Rows fetched per round trip by streamQuery unless the caller asks otherwise
+    static constexpr size_t defaultFetchSize = 1000;
+    // From this many rows on, a copyIn beats a pipelined batch of INSERTs
+    static constexpr size_t copyInThreshold = 100;
+
     virtual ~IDatabase() = default;
 
     // Query execution
     virtual std::unique_ptr<IResultSet>
     execQuery(const std::string& query, const std::vector<std::string>& parameters = {}) = 0;
 
+    // Streaming query: onRow sees one row at a time (the result set is positioned on it) and
+    // only fetchSize rows are held in memory at once. The default runs execQuery and walks
+    // the whole result, so it bounds nothing; PostgreSQLDatabase fetches through a cursor.
+    virtual void streamQuery(const std::string& query, const std::vector<std::string>& parameters,
+                             const std::function<void(IResultSet&)>& onRow,
+                             size_t /*fetchSize*/ = defaultFetchSize) {
+        if (const auto result = execQuery(query, parameters)) {
+            while (result->next()) {
+                onRow(*result);
+            }
+        }
+    }
+
     // Command execution (INSERT, UPDATE, DELETE)
     virtual bool execCommand(const std::string& command,
                              const std::vector<std::string>& parameters = {}) = 0;
 
+    // Asynchronous execution: issue every independent statement of a request first (a count
+    // and a page, a user and their orders), then get() their outcomes; PostgreSQLDatabase
+    // sends the ones issued before the first get() in one round trip. Futures stay readable
+    // across later calls but must not outlive the database. The defaults run the statement
+    // right away and return a ready future.
+    virtual std::future<std::unique_ptr<IResultSet>>
+    execQueryAsync(const std::string& query, const std::vector<std::string>& parameters = {}) {
+        std::promise<std::unique_ptr<IResultSet>> promise;
+        try {
+            promise.set_value(execQuery(query, parameters));
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+        return promise.get_future();
+    }
+    virtual std::future<bool> execCommandAsync(const std::string& command,
+                                               const std::vector<std::string>& parameters = {}) {
+        std::promise<bool> promise;
+        promise.set_value(execCommand(command, parameters));
+        return promise.get_future();
+    }
+
     // Batch operations
     virtual bool execBatch(const std::vector<std::string>& commands,
                            const std::vector<std::vector<std::string>>& parameterSets) = 0;
 
-    // Transaction management
+    // Bulk load: append rows (one text value per column) to table, all or nothing.
+    // PostgreSQLDatabase sends them with COPY FROM STDIN; the default is one INSERT per
+    // row through execBatch.
+    virtual bool copyIn(const std::string& table, const std::vector<std::string>& columns,
+                        const std::vector<std::vector<std::string>>& rows) {
+        std::string insert = "INSERT INTO " + table + " (";
+        std::string values;
+        for (size_t i = 0; i < columns.size(); ++i) {
+            insert += (i == 0 ? "" : ", ") + columns[i];
+            values += (i == 0 ? "$" : ", $") + std::to_string(i + 1);
+        }
+        insert += ") VALUES (" + values + ")";
+        return execBatch(std::vector<std::string>(rows.size(), insert), rows);
+    }
+
+    // Transaction management. Single statements need none: outside a transaction each one
+    // runs on its own, which is the cheapest way to read.
     virtual void beginTransaction() = 0;
     virtual void commitTransaction() = 0;
     virtual void rollbackTransaction() = 0;
 
+    // Read-only snapshot for several reads that must agree with each other (a page and its
+    // total); writes in it fail. Ended by commitTransaction or rollbackTransaction. The
+    // default is an ordinary transaction.
+    virtual void beginReadOnlyTransaction() {
+        beginTransaction();
+    }
+
     // Connection management
     virtual bool isConnected() = 0;
+
+    // Round trip checking that the server still answers, for health checks. The default runs
+    // SELECT 1 through execQuery; PostgreSQLDatabase leaves it out of the statement stats.
+    virtual bool ping() {
+        return execQuery("SELECT 1")->getRowCount() == 1;
+    }
     virtual void connect() = 0;
     virtual void disconnect() = 0;
 
     // Utility
     virtual std::string getLastError() = 0;
+
+    // Prepare statements ahead of their first use (no-op where statements are not cached)
+    virtual void prepareStatements(const std::vector<std::string>& /*statements*/) {}
 };
 
 } // namespace rdws::database
@@ -0,0 +1,708 @@
+#include "postgresql_connection_pool.h"
+#include "deadline.h"
+
+#include <algorithm>
+#include <exception>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace rdws::database {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// The maintenance thread runs often enough to honour the shorter of the two intervals
+constexpr std::chrono::milliseconds minimumMaintenanceInterval{100};
+
+PostgreSQLConnectionPool::Options normalized(PostgreSQLConnectionPool::Options options) {
+    options.maxSize = std::max<size_t>(options.maxSize, 1);
+    options.minSize = std::min(options.minSize, options.maxSize);
+    return options;
+}
+
+uint64_t microsSince(const Clock::time_point start) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+}
+
+} // namespace
+
+// PooledConnection Implementation
+
+PooledConnection::PooledConnection(std::shared_ptr<PostgreSQLConnectionPool> owner,
+                                   std::unique_ptr<IDatabase> connection)
+    : pool(std::move(owner)), database(std::move(connection)), leasedAt(Clock::now()) {}
+
+PooledConnection::~PooledConnection() {
+    bool reusable = true;
+    try {
+        if (inTransaction) {
+            database->rollbackTransaction();
+        }
+        reusable = database->isConnected();
+    } catch (const std::exception&) {
+        reusable = false;
+    }
+    pool->release(std::move(database),
+                  std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - leasedAt),
+                  reusable);
+}
+
+std::unique_ptr<IResultSet> PooledConnection::execQuery(const std::string& query,
+                                                        const std::vector<std::string>& parameters) {
+    return database->execQuery(query, parameters);
+}
+
+void PooledConnection::streamQuery(const std::string& query,
+                                   const std::vector<std::string>& parameters,
+                                   const std::function<void(IResultSet&)>& onRow,
+                                   const size_t fetchSize) {
+    database->streamQuery(query, parameters, onRow, fetchSize);
+}
+
+std::future<std::unique_ptr<IResultSet>>
+PooledConnection::execQueryAsync(const std::string& query,
+                                 const std::vector<std::string>& parameters) {
+    return database->execQueryAsync(query, parameters);
+}
+
+std::future<bool> PooledConnection::execCommandAsync(const std::string& command,
+                                                     const std::vector<std::string>& parameters) {
+    return database->execCommandAsync(command, parameters);
+}
+
+bool PooledConnection::execCommand(const std::string& command,
+                                   const std::vector<std::string>& parameters) {
+    return database->execCommand(command, parameters);
+}
+
+bool PooledConnection::execBatch(const std::vector<std::string>& commands,
+                                 const std::vector<std::vector<std::string>>& parameterSets) {
+    return database->execBatch(commands, parameterSets);
+}
+
+bool PooledConnection::copyIn(const std::string& table, const std::vector<std::string>& columns,
+                              const std::vector<std::vector<std::string>>& rows) {
+    return database->copyIn(table, columns, rows);
+}
+
+void PooledConnection::beginTransaction() {
+    database->beginTransaction();
+    inTransaction = true;
+}
+
+void PooledConnection::beginReadOnlyTransaction() {
+    database->beginReadOnlyTransaction();
+    inTransaction = true;
+}
+
+void PooledConnection::commitTransaction() {
+    database->commitTransaction();
+    inTransaction = false;
+}
+
+void PooledConnection::rollbackTransaction() {
+    database->rollbackTransaction();
+    inTransaction = false;
+}
+
+bool PooledConnection::isConnected() {
+    return database->isConnected();
+}
+
+bool PooledConnection::ping() {
+    return database->ping();
+}
+
+void PooledConnection::connect() {
+    database->connect();
+}
+
+void PooledConnection::disconnect() {
+    database->disconnect();
+    inTransaction = false;
+}
+
+std::string PooledConnection::getLastError() {
+    return database->getLastError();
+}
+
+void PooledConnection::prepareStatements(const std::vector<std::string>& statements) {
+    database->prepareStatements(statements);
+}
+
+// PostgreSQLConnectionPool Implementation
+
+PostgreSQLConnectionPool::PostgreSQLConnectionPool(Options poolOptions,
+                                                   Connector connectionFactory)
+    : options(normalized(poolOptions)), connector(std::move(connectionFactory)) {
+    const auto now = Clock::now();
+    for (size_t i = 0; i < options.minSize && !options.connectInBackground; ++i) {
+        idle.push_back({connector(), now, now});
+        ++openCount;
+        ++counters.opened;
+    }
+    maintenance = std::thread(&PostgreSQLConnectionPool::maintenanceLoop, this);
+}
+
+PostgreSQLConnectionPool::~PostgreSQLConnectionPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    maintenanceWake.notify_all();
+    connectionReturned.notify_all();
+    if (maintenance.joinable()) {
+        maintenance.join();
+    }
+}
+
+std::unique_ptr<PooledConnection> PostgreSQLConnectionPool::acquire() {
+    return lease(true);
+}
+
+std::unique_ptr<PooledConnection> PostgreSQLConnectionPool::tryAcquire() {
+    return lease(false);
+}
+
+void PostgreSQLConnectionPool::setMaintenanceTask(std::function<void()> task,
+                                                  const std::chrono::milliseconds interval) {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        maintenanceTaskDone.wait(lock, [this] { return !maintenanceTaskRunning; });
+        maintenanceTask = std::move(task);
+        maintenanceTaskInterval = std::max(minimumMaintenanceInterval, interval);
+        maintenanceTaskDue = Clock::now() + maintenanceTaskInterval;
+    }
+    maintenanceWake.notify_all();
+}
+
+std::unique_ptr<PooledConnection> PostgreSQLConnectionPool::lease(const bool wait) {
+    const auto startedAt = Clock::now();
+    // A request that runs out of time first stops waiting at its own deadline
+    const auto requestDeadline = DeadlineScope::current();
+    const bool requestBound =
+        requestDeadline && *requestDeadline < startedAt + options.leaseTimeout;
+    const auto deadline = requestBound ? *requestDeadline : startedAt + options.leaseTimeout;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    ++counters.acquisitions;
+    bool waited = false;
+
+    const auto recordWait = [this, startedAt] {
+        const uint64_t waitMicros = microsSince(startedAt);
+        counters.totalWaitMicros += waitMicros;
+        counters.maxWaitMicros = std::max(counters.maxWaitMicros, waitMicros);
+    };
+
+    while (true) {
+        if (stopping) {
+            throw std::runtime_error("Connection pool is shutting down");
+        }
+
+        std::unique_ptr<IDatabase> database;
+        if (!idle.empty()) {
+            // Most recently used first: the rest stay idle long enough to be evicted
+            database = std::move(idle.back().database);
+            idle.pop_back();
+        } else if (openCount >= options.maxSize) {
+            if (!wait) {
+                ++counters.busy;
+                return nullptr;
+            }
+            if (!waited) {
+                waited = true;
+                ++counters.waits;
+            }
+            ++waitingCount;
+            const bool available = connectionReturned.wait_until(lock, deadline, [this] {
+                return stopping || !idle.empty() || openCount < options.maxSize;
+            });
+            --waitingCount;
+            if (!available) {
+                ++counters.timeouts;
+                recordWait();
+                if (requestBound) {
+                    DeadlineScope::markExceeded();
+                    throw DeadlineExceeded();
+                }
+                throw std::runtime_error("Timed out after " +
+                                         std::to_string(options.leaseTimeout.count()) +
+                                         " ms waiting for a database connection");
+            }
+            continue;
+        } else {
+            // Reserve the slot now, open the connection without holding the lock
+            ++openCount;
+        }
+        ++leasedCount;
+        recordWait();
+        lock.unlock();
+
+        // An idle connection closed by the server is replaced in the same slot
+        if (database && !database->isConnected()) {
+            database.reset();
+            std::lock_guard<std::mutex> relock(mutex);
+            ++counters.discarded;
+        }
+        if (!database) {
+            try {
+                database = openConnection();
+            } catch (...) {
+                {
+                    std::lock_guard<std::mutex> relock(mutex);
+                    --openCount;
+                    --leasedCount;
+                }
+                connectionReturned.notify_one();
+                throw;
+            }
+        }
+        return std::make_unique<PooledConnection>(shared_from_this(), std::move(database));
+    }
+}
+
+void PostgreSQLConnectionPool::release(std::unique_ptr<IDatabase> database,
+                                       const std::chrono::microseconds leasedFor,
+                                       const bool reusable) {
+    // A discarded connection is closed after the lock is released
+    std::unique_ptr<IDatabase> closing;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        --leasedCount;
+        leasedMicros += static_cast<uint64_t>(leasedFor.count());
+        if (reusable && !stopping) {
+            const auto now = Clock::now();
+            idle.push_back({std::move(database), now, now});
+        } else {
+            --openCount;
+            ++counters.discarded;
+            closing = std::move(database);
+        }
+    }
+    connectionReturned.notify_one();
+}
+
+void PostgreSQLConnectionPool::prepareStatements(const std::vector<std::string>& statements) {
+    // Idle connections are taken out while their statements are prepared
+    std::vector<IdleConnection> connections;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        preparedStatements.insert(preparedStatements.end(), statements.begin(), statements.end());
+        connections.swap(idle);
+    }
+
+    std::exception_ptr failure;
+    for (auto& connection : connections) {
+        try {
+            connection.database->prepareStatements(statements);
+        } catch (const std::exception&) {
+            if (!failure) {
+                failure = std::current_exception();
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& connection : connections) {
+            idle.insert(idle.begin(), std::move(connection));
+        }
+    }
+    connectionReturned.notify_all();
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+PostgreSQLConnectionPool::Stats PostgreSQLConnectionPool::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats snapshot = counters;
+    snapshot.size = openCount;
+    snapshot.inUse = leasedCount;
+    snapshot.waiting = waitingCount;
+    snapshot.maxSize = options.maxSize;
+
+    const uint64_t elapsedMicros = microsSince(createdAt);
+    if (elapsedMicros > 0) {
+        snapshot.utilization = static_cast<double>(leasedMicros) /
+                               (static_cast<double>(elapsedMicros) * options.maxSize);
+    }
+    return snapshot;
+}
+
+std::string PostgreSQLConnectionPool::describe() const {
+    const Stats current = stats();
+    const uint64_t averageWaitMicros =
+        current.acquisitions > 0 ? current.totalWaitMicros / current.acquisitions : 0;
+
+    std::ostringstream summary;
+    summary << "size=" << current.size << "/" << current.maxSize << " inUse=" << current.inUse
+            << " waiting=" << current.waiting << " acquisitions=" << current.acquisitions
+            << " waits=" << current.waits << " timeouts=" << current.timeouts
+            << " busy=" << current.busy
+            << " avgWaitUs=" << averageWaitMicros << " maxWaitUs=" << current.maxWaitMicros
+            << " opened=" << current.opened << " discarded=" << current.discarded
+            << " utilization=" << current.utilization;
+    return summary.str();
+}
+
+std::unique_ptr<IDatabase> PostgreSQLConnectionPool::openConnection() {
+    auto database = connector();
+    std::vector<std::string> statements;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++counters.opened;
+        statements = preparedStatements;
+    }
+    if (!statements.empty()) {
+        database->prepareStatements(statements);
+    }
+    return database;
+}
+
+void PostgreSQLConnectionPool::maintenanceLoop() {
+    const auto interval = std::max(
+        minimumMaintenanceInterval, std::min(options.idleTimeout, options.healthCheckInterval) / 2);
+
+    // Connections left to open in the background are opened by the first round, right away
+    auto nextRound = options.connectInBackground ? Clock::now() : Clock::now() + interval;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        const auto wakeAt = maintenanceTask ? std::min(nextRound, maintenanceTaskDue) : nextRound;
+        maintenanceWake.wait_until(lock, wakeAt);
+        if (stopping) {
+            break;
+        }
+        if (maintenanceTask && Clock::now() >= maintenanceTaskDue) {
+            runMaintenanceTask(lock);
+            continue;
+        }
+        if (Clock::now() < nextRound) {
+            continue;
+        }
+        nextRound = Clock::now() + interval;
+
+        std::vector<IdleConnection> expired;
+        auto due = collectMaintenance(expired);
+        lock.unlock();
+        expired.clear();
+
+        // Pinged without the lock; meanwhile acquire() simply does not see them
+        std::vector<IdleConnection> healthy;
+        size_t broken = 0;
+        for (auto& connection : due) {
+            if (isHealthy(*connection.database)) {
+                connection.checkedAt = Clock::now();
+                healthy.push_back(std::move(connection));
+            } else {
+                ++broken;
+            }
+        }
+        due.clear();
+
+        lock.lock();
+        // Back at the cold end of the idle list, keeping their idle time for eviction
+        for (auto& connection : healthy) {
+            idle.insert(idle.begin(), std::move(connection));
+        }
+        openCount -= broken;
+        counters.discarded += broken;
+        const size_t missing = openCount < options.minSize ? options.minSize - openCount : 0;
+        openCount += missing;
+        lock.unlock();
+        if (!healthy.empty() || broken > 0) {
+            connectionReturned.notify_all();
+        }
+
+        // Refill to minSize; a failure is retried on the next round
+        for (size_t i = 0; i < missing; ++i) {
+            std::unique_ptr<IDatabase> database;
+            try {
+                database = openConnection();
+            } catch (const std::exception&) {
+            }
+            {
+                std::lock_guard<std::mutex> relock(mutex);
+                if (database) {
+                    const auto now = Clock::now();
+                    idle.push_back({std::move(database), now, now});
+                } else {
+                    --openCount;
+                }
+            }
+            connectionReturned.notify_one();
+        }
+        lock.lock();
+    }
+}
+
+void PostgreSQLConnectionPool::runMaintenanceTask(std::unique_lock<std::mutex>& lock) {
+    const auto task = maintenanceTask;
+    maintenanceTaskRunning = true;
+    lock.unlock();
+    try {
+        task();
+    } catch (const std::exception&) {
+        // The task reports its own failures; the next run is still due
+    }
+    lock.lock();
+    maintenanceTaskRunning = false;
+    maintenanceTaskDue = Clock::now() + maintenanceTaskInterval;
+    maintenanceTaskDone.notify_all();
+}
+
+std::vector<PostgreSQLConnectionPool::IdleConnection>
+PostgreSQLConnectionPool::collectMaintenance(std::vector<IdleConnection>& expired) {
+    const auto now = Clock::now();
+    std::vector<IdleConnection> due;
+    std::vector<IdleConnection> kept;
+    kept.reserve(idle.size());
+
+    for (auto& connection : idle) {
+        const bool aboveMinimum = openCount - expired.size() > options.minSize;
+        if (aboveMinimum && now - connection.idleSince > options.idleTimeout) {
+            expired.push_back(std::move(connection));
+        } else if (now - connection.checkedAt > options.healthCheckInterval) {
+            due.push_back(std::move(connection));
+        } else {
+            kept.push_back(std::move(connection));
+        }
+    }
+    idle = std::move(kept);
+    openCount -= expired.size();
+    counters.discarded += expired.size();
+    return due;
+}
+
+bool PostgreSQLConnectionPool::isHealthy(IDatabase& database) {
+    try {
+        return database.isConnected() && database.ping();
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+// PooledDatabase Implementation
+
+PooledDatabase::PooledDatabase(std::shared_ptr<PostgreSQLConnectionPool> connectionPool)
+    : pool(std::move(connectionPool)) {}
+
+std::unique_ptr<IResultSet> PooledDatabase::execQuery(const std::string& query,
+                                                      const std::vector<std::string>& parameters) {
+    try {
+        if (transaction) {
+            return transaction->execQuery(query, parameters);
+        }
+        return pool->acquire()->execQuery(query, parameters);
+    } catch (const std::exception& e) {
+        lastError = e.what();
+        throw;
+    }
+}
+
+void PooledDatabase::streamQuery(const std::string& query,
+                                 const std::vector<std::string>& parameters,
+                                 const std::function<void(IResultSet&)>& onRow,
+                                 const size_t fetchSize) {
+    try {
+        if (transaction) {
+            transaction->streamQuery(query, parameters, onRow, fetchSize);
+            return;
+        }
+        pool->acquire()->streamQuery(query, parameters, onRow, fetchSize);
+    } catch (const std::exception& e) {
+        lastError = e.what();
+        throw;
+    }
+}
+
+std::future<std::unique_ptr<IResultSet>>
+PooledDatabase::execQueryAsync(const std::string& query,
+                               const std::vector<std::string>& parameters) {
+    if (transaction) {
+        return transaction->execQueryAsync(query, parameters);
+    }
+    try {
+        auto lease = leaseForAsync();
+        auto pending = lease->execQueryAsync(query, parameters);
+        // The future keeps the lease, and with it the connection the query was sent on
+        return std::async(std::launch::deferred,
+                          [lease = std::move(lease), pending = std::move(pending)]() mutable {
+                              return pending.get();
+                          });
+    } catch (const std::exception& e) {
+        lastError = e.what();
+        throw;
+    }
+}
+
+std::future<bool> PooledDatabase::execCommandAsync(const std::string& command,
+                                                   const std::vector<std::string>& parameters) {
+    if (transaction) {
+        return transaction->execCommandAsync(command, parameters);
+    }
+    try {
+        auto lease = leaseForAsync();
+        auto pending = lease->execCommandAsync(command, parameters);
+        return std::async(std::launch::deferred,
+                          [lease = std::move(lease), pending = std::move(pending)]() mutable {
+                              return pending.get();
+                          });
+    } catch (const std::exception& e) {
+        lastError = e.what();
+        std::promise<bool> failed;
+        failed.set_value(false);
+        return failed.get_future();
+    }
+}
+
+bool PooledDatabase::execCommand(const std::string& command,
+                                 const std::vector<std::string>& parameters) {
+    try {
+        if (transaction) {
+            const bool succeeded = transaction->execCommand(command, parameters);
+            if (!succeeded) {
+                lastError = transaction->getLastError();
+            }
+            return succeeded;
+        }
+        const auto lease = pool->acquire();
+        const bool succeeded = lease->execCommand(command, parameters);
+        if (!succeeded) {
+            lastError = lease->getLastError();
+        }
+        return succeeded;
+    } catch (const std::exception& e) {
+        lastError = e.what();
+        return false;
+    }
+}
+
+bool PooledDatabase::execBatch(const std::vector<std::string>& commands,
+                               const std::vector<std::vector<std::string>>& parameterSets) {
+    try {
+        if (transaction) {
+            const bool succeeded = transaction->execBatch(commands, parameterSets);
+            if (!succeeded) {
+                lastError = transaction->getLastError();
+            }
+            return succeeded;
+        }
+        const auto lease = pool->acquire();
+        const bool succeeded = lease->execBatch(commands, parameterSets);
+        if (!succeeded) {
+            lastError = lease->getLastError();
+        }
+        return succeeded;
+    } catch (const std::exception& e) {
+        lastError = e.what();
+        return false;
+    }
+}
+
+bool PooledDatabase::copyIn(const std::string& table, const std::vector<std::string>& columns,
+                            const std::vector<std::vector<std::string>>& rows) {
+    try {
+        if (transaction) {
+            const bool succeeded = transaction->copyIn(table, columns, rows);
+            if (!succeeded) {
+                lastError = transaction->getLastError();
+            }
+            return succeeded;
+        }
+        const auto lease = pool->acquire();
+        const bool succeeded = lease->copyIn(table, columns, rows);
+        if (!succeeded) {
+            lastError = lease->getLastError();
+        }
+        return succeeded;
+    } catch (const std::exception& e) {
+        lastError = e.what();
+        return false;
+    }
+}
+
+void PooledDatabase::beginTransaction() {
+    if (transaction) {
+        throw std::runtime_error("Transaction already in progress");
+    }
+    auto lease = pool->acquire();
+    lease->beginTransaction();
+    transaction = std::move(lease);
+}
+
+void PooledDatabase::beginReadOnlyTransaction() {
+    if (transaction) {
+        throw std::runtime_error("Transaction already in progress");
+    }
+    auto lease = pool->acquire();
+    lease->beginReadOnlyTransaction();
+    transaction = std::move(lease);
+}
+
+void PooledDatabase::commitTransaction() {
+    if (!transaction) {
+        throw std::runtime_error("No transaction in progress");
+    }
+    // The lease goes back to the pool even when the commit throws
+    const auto lease = std::move(transaction);
+    lease->commitTransaction();
+}
+
+void PooledDatabase::rollbackTransaction() {
+    if (!transaction) {
+        throw std::runtime_error("No transaction in progress");
+    }
+    const auto lease = std::move(transaction);
+    lease->rollbackTransaction();
+}
+
+bool PooledDatabase::isConnected() {
+    if (transaction) {
+        return transaction->isConnected();
+    }
+    try {
+        return pool->acquire()->isConnected();
+    } catch (const std::exception& e) {
+        lastError = e.what();
+        return false;
+    }
+}
+
+void PooledDatabase::connect() {
+    // Connections are opened by the pool; this only checks one can be leased
+    try {
+        pool->acquire();
+    } catch (const std::exception& e) {
+        lastError = e.what();
+        throw std::runtime_error("Failed to connect to database: " + std::string(e.what()));
+    }
+}
+
+void PooledDatabase::disconnect() {
+    // An open transaction is rolled back when its lease is returned
+    transaction.reset();
+}
+
+std::string PooledDatabase::getLastError() {
+    return lastError;
+}
+
+std::shared_ptr<PooledConnection> PooledDatabase::leaseForAsync() {
+    if (auto lease = asyncLease.lock()) {
+        return lease;
+    }
+    std::shared_ptr<PooledConnection> lease = pool->acquire();
+    asyncLease = lease;
+    return lease;
+}
+
+void PooledDatabase::prepareStatements(const std::vector<std::string>& statements) {
+    pool->prepareStatements(statements);
+}
+
+} // namespace rdws::database
@@ -0,0 +1,307 @@
+#pragma once
+
+#include "idatabase.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rdws::database {
+
+class PostgreSQLConnectionPool;
+
+/**
+ * PooledConnection - A connection leased from a PostgreSQLConnectionPool
+ *
+ * Forwards every call to the pooled connection and gives it back when destroyed.
+ * A transaction still open at that point is rolled back; a connection that fails
+ * the rollback or has been closed is discarded instead of being reused.
+ */
+class PooledConnection : public IDatabase {
+  private:
+    std::shared_ptr<PostgreSQLConnectionPool> pool;
+    std::unique_ptr<IDatabase> database;
+    std::chrono::steady_clock::time_point leasedAt;
+    bool inTransaction = false;
+
+  public:
+    PooledConnection(std::shared_ptr<PostgreSQLConnectionPool> owner,
+                     std::unique_ptr<IDatabase> connection);
+    ~PooledConnection() override;
+
+    PooledConnection(const PooledConnection&) = delete;
+    PooledConnection& operator=(const PooledConnection&) = delete;
+
+    // Query execution
+    std::unique_ptr<IResultSet> execQuery(const std::string& query,
+                                          const std::vector<std::string>& parameters = {}) override;
+    void streamQuery(const std::string& query, const std::vector<std::string>& parameters,
+                     const std::function<void(IResultSet&)>& onRow,
+                     size_t fetchSize = defaultFetchSize) override;
+    std::future<std::unique_ptr<IResultSet>>
+    execQueryAsync(const std::string& query,
+                   const std::vector<std::string>& parameters = {}) override;
+    std::future<bool> execCommandAsync(const std::string& command,
+                                       const std::vector<std::string>& parameters = {}) override;
+
+    // Command execution
+    bool execCommand(const std::string& command,
+                     const std::vector<std::string>& parameters = {}) override;
+
+    // Batch operations
+    bool execBatch(const std::vector<std::string>& commands,
+                   const std::vector<std::vector<std::string>>& parameterSets) override;
+    bool copyIn(const std::string& table, const std::vector<std::string>& columns,
+                const std::vector<std::vector<std::string>>& rows) override;
+
+    // Transaction management
+    void beginTransaction() override;
+    void beginReadOnlyTransaction() override;
+    void commitTransaction() override;
+    void rollbackTransaction() override;
+
+    // Connection management
+    bool isConnected() override;
+    bool ping() override;
+    void connect() override;
+    void disconnect() override;
+
+    // Utility
+    std::string getLastError() override;
+
+    void prepareStatements(const std::vector<std::string>& statements) override;
+};
+
+/**
+ * PostgreSQLConnectionPool - Thread-safe pool of open database connections
+ *
+ * Opening a connection costs a TCP handshake, authentication and a backend process,
+ * so connections are opened once and leased to one caller at a time. The pool keeps
+ * at least minSize connections open, opens more on demand up to maxSize and makes
+ * acquire() wait for a returned connection beyond that. A maintenance thread closes
+ * connections idle for longer than idleTimeout (down to minSize) and pings those idle
+ * for longer than healthCheckInterval, replacing the ones that no longer answer. It also
+ * runs the task given to setMaintenanceTask(), if any.
+ *
+ * Must be owned by a std::shared_ptr: leases keep the pool alive until they are returned.
+ */
+class PostgreSQLConnectionPool : public std::enable_shared_from_this<PostgreSQLConnectionPool> {
+  public:
+    /**
+     * Opens one new connection; throws std::runtime_error when the database is unavailable
+     */
+    using Connector = std::function<std::unique_ptr<IDatabase>()>;
+
+    struct Options {
+        size_t minSize = 1;
+        size_t maxSize = 8;
+        // How long acquire() waits for a free connection before throwing; a DeadlineScope
+        // ending sooner cuts the wait short with DeadlineExceeded
+        std::chrono::milliseconds leaseTimeout{5000};
+        std::chrono::milliseconds idleTimeout{60000};
+        std::chrono::milliseconds healthCheckInterval{30000};
+        // Open the minSize connections on the maintenance thread instead of the constructor,
+        // so a server that is down at startup fails leases rather than the pool
+        bool connectInBackground = false;
+    };
+
+    struct Stats {
+        size_t size = 0;     // Open connections, leased or idle
+        size_t inUse = 0;    // Currently leased
+        size_t waiting = 0;  // Callers blocked in acquire()
+        size_t maxSize = 0;
+        uint64_t acquisitions = 0;
+        uint64_t waits = 0;     // Acquisitions that found no free connection
+        uint64_t timeouts = 0;  // Acquisitions that gave up after leaseTimeout or deadline
+        uint64_t busy = 0;      // tryAcquire() calls that found every connection leased
+        uint64_t opened = 0;
+        uint64_t discarded = 0;  // Closed as idle, broken or failing a health check
+        uint64_t totalWaitMicros = 0;
+        uint64_t maxWaitMicros = 0;
+        // Share of maxSize leased on average since the pool was created (0..1)
+        double utilization = 0.0;
+    };
+
+  private:
+    struct IdleConnection {
+        std::unique_ptr<IDatabase> database;
+        std::chrono::steady_clock::time_point idleSince;
+        std::chrono::steady_clock::time_point checkedAt;
+    };
+
+    const Options options;
+    const Connector connector;
+    const std::chrono::steady_clock::time_point createdAt = std::chrono::steady_clock::now();
+
+    mutable std::mutex mutex;
+    std::condition_variable connectionReturned;
+    std::condition_variable maintenanceWake;
+    std::vector<IdleConnection> idle;  // Most recently returned last
+    size_t openCount = 0;  // Leased, idle or being opened
+    size_t leasedCount = 0;
+    size_t waitingCount = 0;
+    bool stopping = false;
+    Stats counters;
+    uint64_t leasedMicros = 0;  // Lease time of every returned connection
+    std::vector<std::string> preparedStatements;  // Prepared on each new connection
+    std::function<void()> maintenanceTask;
+    std::chrono::milliseconds maintenanceTaskInterval{0};
+    std::chrono::steady_clock::time_point maintenanceTaskDue;
+    bool maintenanceTaskRunning = false;
+    std::condition_variable maintenanceTaskDone;
+    std::thread maintenance;
+
+  public:
+    /**
+     * Open minSize connections and start the maintenance thread
+     * @throws std::runtime_error when the initial connections cannot be opened (unless
+     *         connectInBackground is set)
+     */
+    PostgreSQLConnectionPool(Options poolOptions, Connector connectionFactory);
+    ~PostgreSQLConnectionPool();
+
+    PostgreSQLConnectionPool(const PostgreSQLConnectionPool&) = delete;
+    PostgreSQLConnectionPool& operator=(const PostgreSQLConnectionPool&) = delete;
+
+    /**
+     * Lease a connection, opening one if the pool is below maxSize
+     * @throws std::runtime_error after leaseTimeout, or when a new connection fails
+     * @throws DeadlineExceeded when the current DeadlineScope passes first
+     */
+    std::unique_ptr<PooledConnection> acquire();
+
+    /**
+     * Lease a connection like acquire(), but never wait for one to be returned
+     * @return null when all maxSize connections are leased
+     * @throws std::runtime_error when a new connection fails
+     */
+    std::unique_ptr<PooledConnection> tryAcquire();
+
+    /**
+     * Run task on the maintenance thread every interval, starting one interval from now
+     * Replaces the previous task (an empty one removes it) once that is no longer running, so
+     * whatever the previous task used may be released after the call. The task runs without
+     * the pool's lock and may lease connections; the pool's own maintenance waits for it.
+     * Must not be called from the task itself.
+     */
+    void setMaintenanceTask(std::function<void()> task, std::chrono::milliseconds interval);
+
+    /**
+     * Prepare statements on the idle connections now and on every connection opened later
+     * Leased connections prepare them on first use.
+     */
+    void prepareStatements(const std::vector<std::string>& statements);
+
+    [[nodiscard]] Stats stats() const;
+
+    /**
+     * One-line summary of stats() for logs
+     */
+    [[nodiscard]] std::string describe() const;
+
+    [[nodiscard]] const Options& getOptions() const {
+        return options;
+    }
+
+  private:
+    friend class PooledConnection;
+
+    /**
+     * Take a lease back; a broken connection is closed and its slot freed
+     */
+    void release(std::unique_ptr<IDatabase> database, std::chrono::microseconds leasedFor,
+                 bool reusable);
+
+    std::unique_ptr<PooledConnection> lease(bool wait);
+    std::unique_ptr<IDatabase> openConnection();
+    void maintenanceLoop();
+    void runMaintenanceTask(std::unique_lock<std::mutex>& lock);
+
+    /**
+     * Close expired idle connections and take out those due for a health check
+     * Called with the mutex held; the returned connections are checked without it.
+     */
+    std::vector<IdleConnection> collectMaintenance(std::vector<IdleConnection>& expired);
+    static bool isHealthy(IDatabase& database);
+};
+
+/**
+ * PooledDatabase - IDatabase facade that leases a pool connection per call
+ *
+ * Lets code written against one IDatabase share a pool: each query or command leases a
+ * connection for its own duration, and a transaction keeps its lease from beginTransaction()
+ * or beginReadOnlyTransaction() until commit or rollback. Like PostgreSQLDatabase, one instance is
+ * meant for one thread at a time; the pool behind it is shared.
+ */
+class PooledDatabase : public IDatabase {
+  private:
+    std::shared_ptr<PostgreSQLConnectionPool> pool;
+    std::unique_ptr<PooledConnection> transaction;
+    std::weak_ptr<PooledConnection> asyncLease;  // Alive while asynchronous results are unread
+    std::string lastError;
+
+  public:
+    explicit PooledDatabase(std::shared_ptr<PostgreSQLConnectionPool> connectionPool);
+
+    // Query execution
+    std::unique_ptr<IResultSet> execQuery(const std::string& query,
+                                          const std::vector<std::string>& parameters = {}) override;
+
+    /**
+     * Stream query on one leased connection, held until the last row has been handed out
+     */
+    void streamQuery(const std::string& query, const std::vector<std::string>& parameters,
+                     const std::function<void(IResultSet&)>& onRow,
+                     size_t fetchSize = defaultFetchSize) override;
+
+    /**
+     * Asynchronous statements share one leased connection, pipelined on it; the lease goes
+     * back to the pool once every future holding it has been read or destroyed
+     */
+    std::future<std::unique_ptr<IResultSet>>
+    execQueryAsync(const std::string& query,
+                   const std::vector<std::string>& parameters = {}) override;
+    std::future<bool> execCommandAsync(const std::string& command,
+                                       const std::vector<std::string>& parameters = {}) override;
+
+    // Command execution
+    bool execCommand(const std::string& command,
+                     const std::vector<std::string>& parameters = {}) override;
+
+    // Batch operations
+    bool execBatch(const std::vector<std::string>& commands,
+                   const std::vector<std::vector<std::string>>& parameterSets) override;
+    bool copyIn(const std::string& table, const std::vector<std::string>& columns,
+                const std::vector<std::vector<std::string>>& rows) override;
+
+    // Transaction management
+    void beginTransaction() override;
+    void beginReadOnlyTransaction() override;
+    void commitTransaction() override;
+    void rollbackTransaction() override;
+
+    // Connection management
+    bool isConnected() override;
+    void connect() override;
+    void disconnect() override;
+
+    // Utility
+    std::string getLastError() override;
+
+    /**
+     * Prepare statements on every connection of the pool, including ones opened later
+     */
+    void prepareStatements(const std::vector<std::string>& statements) override;
+
+  private:
+    std::shared_ptr<PooledConnection> leaseForAsync();
+};
+
+} // namespace rdws::database
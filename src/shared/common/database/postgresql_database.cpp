@@ -1,22 +1,102 @@
 #include "postgresql_database.h"
 
+#include "pq_result_set.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <poll.h>
 #include <stdexcept>
 #include <tuple>
 #include <utility>
 
 namespace rdws::database {
 
-// auxiliar function to expand the parameters
+namespace {
+
+// Statement cache counters of every connection in the process
+std::atomic<uint64_t> processStatementHits{0};
+std::atomic<uint64_t> processStatementMisses{0};
+std::atomic<size_t> processPreparedStatements{0};
+
+using Clock = std::chrono::steady_clock;
+
+// Rows a query returned, or the rows a command touched
+uint64_t resultRows(const pqxx::result& result) {
+    return result.columns() > 0 ? static_cast<uint64_t>(result.size()) : result.affected_rows();
+}
+
+// Rows measured by resultBytes, however many the result has
+constexpr pqxx::result::size_type bytesSampleRows = 16;
+
+// Text bytes of a result, scaled up from evenly spaced sample rows rather than a second pass
+// over every field
+uint64_t resultBytes(const pqxx::result& result) {
+    const auto rows = result.size();
+    if (rows == 0) {
+        return 0;
+    }
+    const auto step = std::max<pqxx::result::size_type>(rows / bytesSampleRows, 1);
+    uint64_t bytes = 0;
+    uint64_t sampled = 0;
+    for (pqxx::result::size_type row = 0; row < rows; row += step, ++sampled) {
+        for (int column = 0; column < result.columns(); ++column) {
+            bytes += result[row][column].size();
+        }
+    }
+    return bytes * static_cast<uint64_t>(rows) / sampled;
+}
+
+uint64_t resultRows(const PGresult* result) {
+    if (PQresultStatus(result) == PGRES_TUPLES_OK) {
+        return static_cast<uint64_t>(PQntuples(result));
+    }
+    // PQcmdTuples only reads the result
+    const char* affected = PQcmdTuples(const_cast<PGresult*>(result));
+    return *affected != '\0' ? std::strtoull(affected, nullptr, 10) : 0;
+}
+
+uint64_t resultBytes(const PGresult* result) {
+    const int rows = PQntuples(result);
+    if (rows == 0) {
+        return 0;
+    }
+    const int step = std::max(rows / static_cast<int>(bytesSampleRows), 1);
+    uint64_t bytes = 0;
+    uint64_t sampled = 0;
+    for (int row = 0; row < rows; row += step, ++sampled) {
+        for (int column = 0; column < PQnfields(result); ++column) {
+            bytes += static_cast<uint64_t>(PQgetlength(result, row, column));
+        }
+    }
+    return bytes * static_cast<uint64_t>(rows) / sampled;
+}
+
+// libpq messages end with a newline
+std::string trimmedError(std::string message) {
+    while (!message.empty() && (message.back() == '\n' || message.back() == ' ')) {
+        message.pop_back();
+    }
+    return message.empty() ? "unknown libpq error" : message;
+}
+
+} // namespace
+
+// auxiliar function to run a statement, prepared when it has a name
 template <typename Transaction>
-pqxx::result exec_prepared_helper(Transaction& txn, const std::string& stmt_name,
+pqxx::result exec_prepared_helper(Transaction& txn, const std::string* stmt_name,
                                   const std::vector<std::string>& params,
                                   const std::string& query) {
-    if (params.empty()) {
-        return txn.exec(query);
-    } else {
-        const std::vector<std::string_view> svparams(params.begin(), params.end());
-        return txn.exec(stmt_name, svparams);
+    pqxx::params values;
+    values.append_multi(params);
+    if (stmt_name == nullptr) {
+        return txn.exec(query, values);
     }
+    return txn.exec(pqxx::prepped{*stmt_name}, values);
 }
 
 // PostgreSQLResultSet Implementation
@@ -79,6 +159,50 @@ bool PostgreSQLResultSet::isNull(const std::string& columnName) {
     return result[currentRow - 1][columnName].is_null();
 }
 
+size_t PostgreSQLResultSet::getColumnIndex(const std::string& columnName) {
+    return static_cast<size_t>(result.column_number(columnName));
+}
+
+std::string PostgreSQLResultSet::getStringAt(const size_t column) {
+    return std::string(fieldAt(column).view());
+}
+
+int PostgreSQLResultSet::getIntAt(const size_t column) {
+    return fieldAt(column).as<int>();
+}
+
+double PostgreSQLResultSet::getDoubleAt(const size_t column) {
+    return fieldAt(column).as<double>();
+}
+
+bool PostgreSQLResultSet::getBoolAt(const size_t column) {
+    return fieldAt(column).as<bool>();
+}
+
+bool PostgreSQLResultSet::isNullAt(const size_t column) {
+    return fieldAt(column).is_null();
+}
+
+std::string_view PostgreSQLResultSet::getStringView(const std::string& columnName) {
+    return getStringViewAt(getColumnIndex(columnName));
+}
+
+std::string_view PostgreSQLResultSet::getStringViewAt(const size_t column) {
+    return fieldAt(column).view();
+}
+
+void PostgreSQLResultSet::getRowText(const size_t* columns, const size_t count,
+                                     std::optional<std::string_view>* fields) {
+    const auto row = currentRowData();
+    for (size_t i = 0; i < count; ++i) {
+        if (columns[i] >= static_cast<size_t>(result.columns())) {
+            throw std::runtime_error("Invalid column index: " + std::to_string(columns[i]));
+        }
+        const auto field = row[static_cast<int>(columns[i])];
+        fields[i] = field.is_null() ? std::nullopt : std::optional(field.view());
+    }
+}
+
 size_t PostgreSQLResultSet::getColumnCount() {
     return result.columns();
 }
@@ -95,67 +219,246 @@ size_t PostgreSQLResultSet::getRowCount() {
     return result.size();
 }
 
+pqxx::row PostgreSQLResultSet::currentRowData() const {
+    if (currentRow == 0 || currentRow > (pqxx::result::size_type)result.size()) {
+        throw std::runtime_error("Invalid row position");
+    }
+    return result[currentRow - 1];
+}
+
+pqxx::field PostgreSQLResultSet::fieldAt(const size_t column) const {
+    const auto row = currentRowData();
+    if (column >= static_cast<size_t>(result.columns())) {
+        throw std::runtime_error("Invalid column index: " + std::to_string(column));
+    }
+    return row[static_cast<int>(column)];
+}
+
 // PostgreSQLDatabase Implementation
 
-PostgreSQLDatabase::PostgreSQLDatabase() {
+PostgreSQLDatabase::PostgreSQLDatabase()
+    : breaker(ConnectionBreaker::forDatabase(config)),
+      statements(maxPreparedStatements, config.getSlowQueryThreshold()) {
     // Uses default Config constructor that loads from environment
     PostgreSQLDatabase::connect();
 }
 
-PostgreSQLDatabase::PostgreSQLDatabase(const rdws::Config& dbConfig) : config(dbConfig) {
+PostgreSQLDatabase::PostgreSQLDatabase(const rdws::Config& dbConfig)
+    : config(dbConfig), breaker(ConnectionBreaker::forDatabase(config)),
+      statements(maxPreparedStatements, config.getSlowQueryThreshold()) {
     PostgreSQLDatabase::connect();
 }
 
 PostgreSQLDatabase::~PostgreSQLDatabase() {
+    // Statements sent asynchronously outside a transaction are committed, as if awaited
+    finishAsyncQueries();
     if (currentTransaction) {
         PostgreSQLDatabase::rollbackTransaction();
     }
     PostgreSQLDatabase::disconnect();
 }
 
+template <typename Statement>
+auto PostgreSQLDatabase::underDeadline(Statement&& statement) -> decltype(statement()) {
+    return watchDeadline(applyDeadline(), std::forward<Statement>(statement));
+}
+
+template <typename Statement>
+auto PostgreSQLDatabase::watchDeadline(
+    const std::optional<std::chrono::steady_clock::time_point> deadline, Statement&& statement)
+    -> decltype(statement()) {
+    if (!deadline) {
+        return statement();
+    }
+
+    const QueryWatchdog::Guard guard(*deadline, [key = cancelKey] { key.cancel(); });
+    try {
+        return statement();
+    } catch (const pqxx::query_canceled&) {
+        // Canceled by the watchdog or by the statement_timeout applyDeadline set
+        DeadlineScope::markExceeded();
+        throw DeadlineExceeded();
+    } catch (const std::exception&) {
+        if (guard.fired()) {
+            DeadlineScope::markExceeded();
+            throw DeadlineExceeded();
+        }
+        throw;
+    }
+}
+
 std::unique_ptr<IResultSet>
 PostgreSQLDatabase::execQuery(const std::string& query,
                               const std::vector<std::string>& parameters) {
+    const auto start = Clock::now();
     try {
+        finishAsyncQueries();
         ensureConnection();
 
-        std::string stmt_name = "stmt_" + std::to_string(std::hash<std::string>{}(query));
-        if (currentTransaction) {
-            pqxx::result result;
-            connection->prepare(stmt_name, query);
-            result = exec_prepared_helper(*currentTransaction, stmt_name, parameters, query);
-            return std::make_unique<PostgreSQLResultSet>(std::move(result));
-        } else {
-            pqxx::work txn{*connection};
-            pqxx::result result;
-            connection->prepare(stmt_name, query);
-            result = exec_prepared_helper(txn, stmt_name, parameters, query);
-            txn.commit();
-            return std::make_unique<PostgreSQLResultSet>(std::move(result));
-        }
+        const std::string* stmt_name = preparedStatement(query);
+        pqxx::result result = underDeadline([&] {
+            if (currentTransaction) {
+                return exec_prepared_helper(*currentTransaction, stmt_name, parameters, query);
+            }
+            // A single statement is atomic on its own; autocommit skips the BEGIN and COMMIT
+            pqxx::nontransaction txn{*connection};
+            return exec_prepared_helper(txn, stmt_name, parameters, query);
+        });
+        recordStatement(query, parameters.size(), start, &result);
+        return std::make_unique<PostgreSQLResultSet>(std::move(result));
+    } catch (const DeadlineExceeded& e) {
+        recordStatement(query, parameters.size(), start, true, 0, 0);
+        lastError = e.what();
+        throw;
     } catch (const std::exception& e) {
+        recordStatement(query, parameters.size(), start, true, 0, 0);
         lastError = e.what();
         throw std::runtime_error("Query execution failed: " + std::string(e.what()));
     }
 }
+
+std::future<std::unique_ptr<IResultSet>>
+PostgreSQLDatabase::execQueryAsync(const std::string& query,
+                                   const std::vector<std::string>& parameters) {
+    try {
+        auto pending = queueAsync(query, parameters);
+        auto receive = [this, pending = std::move(pending)]() -> std::unique_ptr<IResultSet> {
+            try {
+                return std::make_unique<PqResultSet>(awaitAsync(*pending).release());
+            } catch (const DeadlineExceeded&) {
+                throw;
+            } catch (const std::exception& e) {
+                throw std::runtime_error("Query execution failed: " + std::string(e.what()));
+            }
+        };
+        return std::async(std::launch::deferred, std::move(receive));
+    } catch (const DeadlineExceeded& e) {
+        lastError = e.what();
+        std::promise<std::unique_ptr<IResultSet>> failed;
+        failed.set_exception(std::current_exception());
+        return failed.get_future();
+    } catch (const std::exception& e) {
+        lastError = e.what();
+        std::promise<std::unique_ptr<IResultSet>> failed;
+        failed.set_exception(std::make_exception_ptr(
+            std::runtime_error("Query execution failed: " + std::string(e.what()))));
+        return failed.get_future();
+    }
+}
+
+std::future<bool> PostgreSQLDatabase::execCommandAsync(const std::string& command,
+                                                       const std::vector<std::string>& parameters) {
+    try {
+        auto pending = queueAsync(command, parameters);
+        return std::async(std::launch::deferred, [this, pending = std::move(pending)] {
+            try {
+                awaitAsync(*pending);
+                return true;
+            } catch (const std::exception& e) {
+                lastError = e.what();
+                return false;
+            }
+        });
+    } catch (const std::exception& e) {
+        lastError = e.what();
+        std::promise<bool> failed;
+        failed.set_value(false);
+        return failed.get_future();
+    }
+}
+
+void PostgreSQLDatabase::streamQuery(const std::string& query,
+                                     const std::vector<std::string>& parameters,
+                                     const std::function<void(IResultSet&)>& onRow,
+                                     const size_t fetchSize) {
+    // The DECLARE/FETCH round trips count as one statement, under the query's own SQL
+    const auto start = Clock::now();
+    uint64_t rowCount = 0;
+    uint64_t byteCount = 0;
+    try {
+        finishAsyncQueries();
+        ensureConnection();
+
+        const bool wasInTransaction = (currentTransaction != nullptr);
+        if (!wasInTransaction) {
+            beginTransaction();
+        }
+
+        try {
+            const size_t chunkSize = std::max<size_t>(fetchSize, 1);
+            const std::string cursor = "rdws_cursor_" + std::to_string(++cursorCount);
+            const std::string fetch =
+                "FETCH FORWARD " + std::to_string(chunkSize) + " FROM " + cursor;
+
+            underDeadline([&] {
+                pqxx::params values;
+                values.append_multi(parameters);
+                currentTransaction->exec("DECLARE " + cursor + " NO SCROLL CURSOR FOR " + query,
+                                         values);
+
+                // Each FETCH replaces the previous chunk, so memory stays at one chunk of rows
+                for (;;) {
+                    // Time spent in onRow is not covered by the watchdog's cancel
+                    checkDeadline();
+                    pqxx::result chunk = currentTransaction->exec(fetch);
+                    rowCount += static_cast<uint64_t>(chunk.size());
+                    byteCount += resultBytes(chunk);
+                    PostgreSQLResultSet rows(std::move(chunk));
+                    const size_t fetched = rows.getRowCount();
+                    while (rows.next()) {
+                        onRow(rows);
+                    }
+                    if (fetched < chunkSize) {
+                        break;
+                    }
+                }
+                // Our own transaction closes the cursor when it commits
+                if (wasInTransaction) {
+                    currentTransaction->exec("CLOSE " + cursor);
+                }
+            });
+        } catch (const std::exception&) {
+            // A caller's transaction is theirs to roll back; the cursor ends with it
+            if (!wasInTransaction && currentTransaction) {
+                rollbackTransaction();
+            }
+            throw;
+        }
+
+        if (!wasInTransaction) {
+            commitTransaction();
+        }
+        recordStatement(query, parameters.size(), start, false, rowCount, byteCount);
+    } catch (const DeadlineExceeded& e) {
+        recordStatement(query, parameters.size(), start, true, rowCount, byteCount);
+        lastError = e.what();
+        throw;
+    } catch (const std::exception& e) {
+        recordStatement(query, parameters.size(), start, true, rowCount, byteCount);
+        lastError = e.what();
+        throw std::runtime_error("Streaming query failed: " + std::string(e.what()));
+    }
+}
+
 bool PostgreSQLDatabase::execCommand(const std::string& command,
                                      const std::vector<std::string>& parameters) {
+    const auto start = Clock::now();
     try {
+        finishAsyncQueries();
         ensureConnection();
 
-        std::string stmt_name = "stmt_" + std::to_string(std::hash<std::string>{}(command));
-        if (currentTransaction) {
-            connection->prepare(stmt_name, command);
-            exec_prepared_helper(*currentTransaction, stmt_name, parameters, command);
-            return true;
-        } else {
-            pqxx::work txn{*connection};
-            connection->prepare(stmt_name, command);
-            exec_prepared_helper(txn, stmt_name, parameters, command);
-            txn.commit();
-            return true;
-        }
+        const std::string* stmt_name = preparedStatement(command);
+        const pqxx::result result = underDeadline([&] {
+            if (currentTransaction) {
+                return exec_prepared_helper(*currentTransaction, stmt_name, parameters, command);
+            }
+            pqxx::nontransaction txn{*connection};
+            return exec_prepared_helper(txn, stmt_name, parameters, command);
+        });
+        recordStatement(command, parameters.size(), start, &result);
+        return true;
     } catch (const std::exception& e) {
+        recordStatement(command, parameters.size(), start, true, 0, 0);
         lastError = e.what();
         return false;
     }
@@ -168,7 +471,62 @@ bool PostgreSQLDatabase::execBatch(const std::vector<std::string>& commands,
         return false;
     }
 
+    if (commands.empty()) {
+        return true;
+    }
+
+    // The whole batch is one entry, apart from single runs of its first statement
+    const std::string batch = "/* batch */ " + commands.front();
+    size_t parameterCount = 0;
+    for (const auto& parameters : parameterSets) {
+        parameterCount += parameters.size();
+    }
+    const auto start = Clock::now();
     try {
+        finishAsyncQueries();
+        ensureConnection();
+
+        std::vector<PipelineStatement> statements;
+        statements.reserve(commands.size());
+        for (size_t i = 0; i < commands.size(); ++i) {
+            statements.push_back({commands[i], parameterSets[i]});
+        }
+
+        // No BEGIN and COMMIT: the pipeline's sync ends the implicit transaction
+        uint64_t rows = 0;
+        for (const auto& result : underDeadline([&] { return runPipeline(statements); })) {
+            rows += resultRows(result.get());
+        }
+
+        recordStatement(batch, parameterCount, start, false, rows, 0);
+        return true;
+    } catch (const std::exception& e) {
+        recordStatement(batch, parameterCount, start, true, 0, 0);
+        lastError = e.what();
+        if (currentTransaction) {
+            rollbackTransaction();
+        }
+        return false;
+    }
+}
+
+bool PostgreSQLDatabase::copyIn(const std::string& table, const std::vector<std::string>& columns,
+                                const std::vector<std::vector<std::string>>& rows) {
+    if (rows.empty()) {
+        return true;
+    }
+
+    // Recorded like any other statement, as the COPY it sends
+    std::string copy = "COPY " + table + " (";
+    for (size_t i = 0; i < columns.size(); ++i) {
+        copy += (i == 0 ? "" : ", ") + columns[i];
+    }
+    copy += ") FROM STDIN";
+    const auto start = Clock::now();
+    uint64_t bytes = 0;
+
+    try {
+        finishAsyncQueries();
         ensureConnection();
 
         bool wasInTransaction = (currentTransaction != nullptr);
@@ -176,19 +534,33 @@ bool PostgreSQLDatabase::execBatch(const std::vector<std::string>& commands,
             beginTransaction();
         }
 
-        for (size_t i = 0; i < commands.size(); ++i) {
-            std::string stmt_name = "stmt_" + std::to_string(std::hash<std::string>{}(commands[i]));
-            connection->prepare(stmt_name, commands[i]);
-            const auto& params = parameterSets[i];
-            exec_prepared_helper(*currentTransaction, stmt_name, params, commands[i]);
-        }
+        // The stream must be completed before the transaction can run anything else
+        underDeadline([&] {
+            auto stream = pqxx::stream_to::raw_table(*currentTransaction,
+                                                     connection->quote_table(table),
+                                                     connection->quote_columns(columns));
+            for (const auto& row : rows) {
+                if (row.size() != columns.size()) {
+                    throw std::runtime_error("Row has " + std::to_string(row.size()) +
+                                             " values for " + std::to_string(columns.size()) +
+                                             " columns");
+                }
+                stream.write_row(row);
+                for (const auto& value : row) {
+                    bytes += value.size();
+                }
+            }
+            stream.complete();
+        });
 
         if (!wasInTransaction) {
             commitTransaction();
         }
 
+        recordStatement(copy, 0, start, false, rows.size(), bytes);
         return true;
     } catch (const std::exception& e) {
+        recordStatement(copy, 0, start, true, 0, 0);
         lastError = e.what();
         if (currentTransaction) {
             rollbackTransaction();
@@ -198,6 +570,7 @@ bool PostgreSQLDatabase::execBatch(const std::vector<std::string>& commands,
 }
 
 void PostgreSQLDatabase::beginTransaction() {
+    finishAsyncQueries();
     ensureConnection();
     if (currentTransaction) {
         throw std::runtime_error("Transaction already in progress");
@@ -205,10 +578,24 @@ void PostgreSQLDatabase::beginTransaction() {
     currentTransaction = std::make_unique<pqxx::work>(*connection);
 }
 
+void PostgreSQLDatabase::beginReadOnlyTransaction() {
+    finishAsyncQueries();
+    ensureConnection();
+    if (currentTransaction) {
+        throw std::runtime_error("Transaction already in progress");
+    }
+    // BEGIN ISOLATION LEVEL REPEATABLE READ READ ONLY: one snapshot for every query, and no
+    // SSI bookkeeping or DEFERRABLE wait since nothing in it can write
+    currentTransaction = std::make_unique<
+        pqxx::transaction<pqxx::isolation_level::repeatable_read, pqxx::write_policy::read_only>>(
+        *connection);
+}
+
 void PostgreSQLDatabase::commitTransaction() {
     if (!currentTransaction) {
         throw std::runtime_error("No transaction in progress");
     }
+    finishAsyncQueries();
     currentTransaction->commit();
     currentTransaction.reset();
 }
@@ -217,25 +604,70 @@ void PostgreSQLDatabase::rollbackTransaction() {
     if (!currentTransaction) {
         throw std::runtime_error("No transaction in progress");
     }
+    abandonAsyncQueries();
     currentTransaction->abort();
     currentTransaction.reset();
+    // A SET statement_timeout sent in the transaction was undone with it
+    sessionStatementTimeout = unknownStatementTimeout;
 }
 
 bool PostgreSQLDatabase::isConnected() {
     return connection && connection->is_open();
 }
 
+bool PostgreSQLDatabase::ping() {
+    if (!isConnected() || rawConnection == nullptr) {
+        return false;
+    }
+    const PipelineResult result(PQexec(rawConnection, "SELECT 1"));
+    return result && PQresultStatus(result.get()) == PGRES_TUPLES_OK;
+}
+
 void PostgreSQLDatabase::connect() {
+    // While the server is unreachable, fail at once instead of waiting out a connect timeout
+    if (!breaker->allowAttempt()) {
+        const auto status = breaker->status();
+        lastError = "Database unreachable, next attempt in " +
+                    std::to_string(status.retryIn.count()) + " ms (" + status.lastError + ")";
+        throw std::runtime_error("Failed to connect to database: " + lastError);
+    }
+
+    bool connected = false;
     try {
-        connection = std::make_unique<pqxx::connection>(config.getConnectionString());
+        // Prepared statements belong to the server session being replaced
+        clearPreparedStatements();
+        // Opened through libpq for the cancel key, then handed over to pqxx
+        PGconn* raw = PQconnectdb(config.getConnectionString().c_str());
+        if (PQstatus(raw) != CONNECTION_OK) {
+            std::string error = PQerrorMessage(raw);
+            PQfinish(raw);
+            while (!error.empty() && error.back() == '\n') {
+                error.pop_back();
+            }
+            throw std::runtime_error(error);
+        }
+        cancelKey = CancelKey(raw, breaker);
+        rawConnection = raw;
+        connection =
+            std::make_unique<pqxx::connection>(pqxx::connection::seize_raw_connection(raw));
+        connected = true;
+        sessionStatementTimeout = 0;
+        breaker->recordSuccess();
+        for (const auto& statement : preloadedStatements) {
+            addPreparedStatement(statement);
+        }
         lastError.clear();
     } catch (const std::exception& e) {
+        if (!connected) {
+            breaker->recordFailure(e.what());
+        }
         lastError = e.what();
         throw std::runtime_error("Failed to connect to database: " + std::string(e.what()));
     }
 }
 
 void PostgreSQLDatabase::disconnect() {
+    finishAsyncQueries();
     if (currentTransaction) {
         rollbackTransaction();
     }
@@ -243,16 +675,313 @@ void PostgreSQLDatabase::disconnect() {
         connection->close();
         connection.reset();
     }
+    rawConnection = nullptr;
+    clearPreparedStatements();
 }
 
 std::string PostgreSQLDatabase::getLastError() {
     return lastError;
 }
 
+void PostgreSQLDatabase::prepareStatements(const std::vector<std::string>& statements) {
+    try {
+        finishAsyncQueries();
+        ensureConnection();
+        // Not counted as misses: those measure statements prepared while serving requests
+        for (const auto& statement : statements) {
+            if (preparedStatements.count(statement) != 0 ||
+                preparedStatements.size() >= maxPreparedStatements) {
+                continue;
+            }
+            addPreparedStatement(statement);
+            preloadedStatements.push_back(statement);
+        }
+    } catch (const std::exception& e) {
+        lastError = e.what();
+        throw std::runtime_error("Failed to prepare statements: " + std::string(e.what()));
+    }
+}
+
+StatementCacheStats PostgreSQLDatabase::getStatementCacheStats() const {
+    StatementCacheStats stats = statementCacheStats;
+    stats.size = preparedStatements.size();
+    return stats;
+}
+
+StatementCacheStats PostgreSQLDatabase::processStatementCacheStats() {
+    StatementCacheStats stats;
+    stats.hits = processStatementHits.load();
+    stats.misses = processStatementMisses.load();
+    stats.size = processPreparedStatements.load();
+    return stats;
+}
+
+std::vector<PostgreSQLDatabase::PipelineResult>
+PostgreSQLDatabase::runPipeline(const std::vector<PipelineStatement>& batch) {
+    // Prepared up front: a statement cannot be prepared and run in the same pipeline
+    std::vector<const std::string*> names;
+    names.reserve(batch.size());
+    for (const auto& statement : batch) {
+        names.push_back(preparedStatement(statement.sql));
+    }
+
+    if (PQenterPipelineMode(rawConnection) != 1) {
+        throw std::runtime_error(trimmedError(PQerrorMessage(rawConnection)));
+    }
+    std::vector<PipelineResult> results;
+    results.reserve(batch.size());
+    try {
+        // A pipeline larger than the socket buffers must not block on writing it
+        PQsetnonblocking(rawConnection, 1);
+        std::vector<const char*> values;
+        for (size_t i = 0; i < batch.size(); ++i) {
+            values.clear();
+            for (const auto& parameter : batch[i].parameters) {
+                values.push_back(parameter.c_str());
+            }
+            const int count = static_cast<int>(values.size());
+            const int sent = names[i] != nullptr
+                                 ? PQsendQueryPrepared(rawConnection, names[i]->c_str(), count,
+                                                       values.data(), nullptr, nullptr, 0)
+                                 : PQsendQueryParams(rawConnection, batch[i].sql.c_str(), count,
+                                                     nullptr, values.data(), nullptr, nullptr, 0);
+            if (sent != 1) {
+                throw std::runtime_error(trimmedError(PQerrorMessage(rawConnection)));
+            }
+        }
+        if (PQpipelineSync(rawConnection) != 1) {
+            throw std::runtime_error(trimmedError(PQerrorMessage(rawConnection)));
+        }
+        flushPipeline();
+        PQsetnonblocking(rawConnection, 0);
+
+        // After a failure the server skips the rest up to the sync (PGRES_PIPELINE_ABORTED)
+        std::string failure;
+        bool canceled = false;
+        for (size_t i = 0; i < batch.size(); ++i) {
+            PipelineResult result(PQgetResult(rawConnection));
+            if (!result) {
+                throw std::runtime_error(trimmedError(PQerrorMessage(rawConnection)));
+            }
+            if (PQresultStatus(result.get()) == PGRES_FATAL_ERROR && failure.empty()) {
+                failure = trimmedError(PQresultErrorMessage(result.get()));
+                const char* state = PQresultErrorField(result.get(), PG_DIAG_SQLSTATE);
+                canceled = state != nullptr && std::strcmp(state, "57014") == 0;
+            }
+            // Each statement's results end with a null
+            while (PipelineResult(PQgetResult(rawConnection))) {
+            }
+            results.push_back(std::move(result));
+        }
+        const PipelineResult sync(PQgetResult(rawConnection));
+        if (!sync || PQresultStatus(sync.get()) != PGRES_PIPELINE_SYNC ||
+            PQexitPipelineMode(rawConnection) != 1) {
+            throw std::runtime_error(trimmedError(PQerrorMessage(rawConnection)));
+        }
+
+        if (canceled) {
+            throw pqxx::query_canceled(failure);
+        }
+        if (!failure.empty()) {
+            throw std::runtime_error(failure);
+        }
+        return results;
+    } catch (const pqxx::query_canceled&) {
+        throw;
+    } catch (const std::exception&) {
+        PQsetnonblocking(rawConnection, 0);
+        // Results left unread would be taken for those of the next statement
+        if (PQpipelineStatus(rawConnection) != PQ_PIPELINE_OFF &&
+            PQexitPipelineMode(rawConnection) != 1) {
+            connection->close();
+        }
+        throw;
+    }
+}
+
+void PostgreSQLDatabase::flushPipeline() {
+    int pending = 0;
+    while ((pending = PQflush(rawConnection)) == 1) {
+        pollfd socket{PQsocket(rawConnection), POLLIN | POLLOUT, 0};
+        if (poll(&socket, 1, -1) < 0 && errno != EINTR) {
+            throw std::runtime_error("Waiting for the database socket failed: " +
+                                     std::string(std::strerror(errno)));
+        }
+        if ((socket.revents & POLLIN) != 0 && PQconsumeInput(rawConnection) != 1) {
+            break;
+        }
+    }
+    if (pending != 0) {
+        throw std::runtime_error(trimmedError(PQerrorMessage(rawConnection)));
+    }
+}
+
+std::shared_ptr<PostgreSQLDatabase::AsyncResult>
+PostgreSQLDatabase::queueAsync(const std::string& sql,
+                               const std::vector<std::string>& parameters) {
+    auto pending = std::make_shared<AsyncResult>();
+    pending->sql = sql;
+    pending->parameters = parameters;
+    pending->start = Clock::now();
+    // Nothing is sent before finishAsyncQueries(), so every statement shares one pipeline
+    asyncQueries.push_back(pending);
+    return pending;
+}
+
+PostgreSQLDatabase::PipelineResult PostgreSQLDatabase::awaitAsync(AsyncResult& pending) {
+    if (!pending.done) {
+        finishAsyncQueries();
+    }
+    if (pending.error) {
+        std::rethrow_exception(pending.error);
+    }
+    if (!pending.result) {
+        throw std::runtime_error("Result was already read");
+    }
+    return std::move(pending.result);
+}
+
+void PostgreSQLDatabase::finishAsyncQueries() {
+    if (asyncQueries.empty()) {
+        return;
+    }
+    const auto queries = std::move(asyncQueries);
+    asyncQueries.clear();
+
+    std::vector<PipelineStatement> batch;
+    batch.reserve(queries.size());
+    for (const auto& pending : queries) {
+        batch.push_back({pending->sql, pending->parameters});
+    }
+
+    std::exception_ptr failure;
+    try {
+        ensureConnection();
+        auto results = underDeadline([&] { return runPipeline(batch); });
+        for (size_t i = 0; i < queries.size(); ++i) {
+            queries[i]->result = std::move(results[i]);
+        }
+    } catch (const std::exception& e) {
+        lastError = e.what();
+        failure = std::current_exception();
+    }
+
+    // The batch was one implicit transaction, so a failure undid every statement in it
+    for (const auto& pending : queries) {
+        if (failure) {
+            pending->result.reset();
+            pending->error = failure;
+        }
+        pending->done = true;
+        recordStatement(pending->sql, pending->parameters.size(), pending->start,
+                        pending->result.get());
+    }
+}
+
+void PostgreSQLDatabase::abandonAsyncQueries() {
+    const auto dropped = std::make_exception_ptr(
+        std::runtime_error("Statement was dropped before it was sent: its transaction ended"));
+    for (const auto& pending : asyncQueries) {
+        pending->error = dropped;
+        pending->done = true;
+    }
+    asyncQueries.clear();
+}
+
+void PostgreSQLDatabase::checkDeadline() {
+    if (const auto deadline = DeadlineScope::current(); deadline && Clock::now() >= *deadline) {
+        DeadlineScope::markExceeded();
+        throw DeadlineExceeded();
+    }
+}
+
+std::optional<std::chrono::steady_clock::time_point> PostgreSQLDatabase::applyDeadline() {
+    checkDeadline();
+    const auto deadline = DeadlineScope::current();
+
+    int64_t timeout = 0;
+    if (deadline) {
+        const auto remaining =
+            std::chrono::ceil<std::chrono::milliseconds>(*deadline - Clock::now()).count();
+        // A session timeout up to twice the budget is kept: the watchdog enforces the exact
+        // deadline, and not resetting it spares a round trip on most statements
+        if (sessionStatementTimeout >= remaining && sessionStatementTimeout <= 2 * remaining) {
+            return deadline;
+        }
+        timeout = remaining;
+    } else if (sessionStatementTimeout == 0) {
+        return std::nullopt;
+    }
+
+    const std::string set = "SET statement_timeout = " + std::to_string(timeout);
+    if (currentTransaction) {
+        currentTransaction->exec(set);
+    } else {
+        pqxx::nontransaction txn{*connection};
+        txn.exec(set);
+    }
+    sessionStatementTimeout = timeout;
+    return deadline;
+}
+
+void PostgreSQLDatabase::recordStatement(const std::string& sql, const size_t parameterCount,
+                                         const std::chrono::steady_clock::time_point start,
+                                         const pqxx::result* result) {
+    recordStatement(sql, parameterCount, start, result == nullptr,
+                    result != nullptr ? resultRows(*result) : 0,
+                    result != nullptr ? resultBytes(*result) : 0);
+}
+
+void PostgreSQLDatabase::recordStatement(const std::string& sql, const size_t parameterCount,
+                                         const std::chrono::steady_clock::time_point start,
+                                         const PGresult* result) {
+    recordStatement(sql, parameterCount, start, result == nullptr,
+                    result != nullptr ? resultRows(result) : 0,
+                    result != nullptr ? resultBytes(result) : 0);
+}
+
+void PostgreSQLDatabase::recordStatement(const std::string& sql, const size_t parameterCount,
+                                         const std::chrono::steady_clock::time_point start,
+                                         const bool failed, const uint64_t rows,
+                                         const uint64_t bytes) {
+    // Bounded like the prepared statements
+    statements.record(sql, parameterCount,
+                      std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start),
+                      failed, rows, bytes);
+}
+
 void PostgreSQLDatabase::ensureConnection() {
     if (!isConnected()) {
         connect();
     }
 }
 
+const std::string* PostgreSQLDatabase::preparedStatement(const std::string& sql) {
+    if (const auto found = preparedStatements.find(sql); found != preparedStatements.end()) {
+        ++statementCacheStats.hits;
+        ++processStatementHits;
+        return &found->second;
+    }
+    if (preparedStatements.size() >= maxPreparedStatements) {
+        return nullptr;
+    }
+
+    ++statementCacheStats.misses;
+    ++processStatementMisses;
+    return &addPreparedStatement(sql);
+}
+
+const std::string& PostgreSQLDatabase::addPreparedStatement(const std::string& sql) {
+    // Names only need to be unique per connection
+    std::string name = "stmt_" + std::to_string(preparedStatements.size() + 1);
+    connection->prepare(name, sql);
+    ++processPreparedStatements;
+    return preparedStatements.emplace(sql, std::move(name)).first->second;
+}
+
+void PostgreSQLDatabase::clearPreparedStatements() {
+    processPreparedStatements -= preparedStatements.size();
+    preparedStatements.clear();
+}
+
 } // namespace rdws::database
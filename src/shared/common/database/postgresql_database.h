@@ -1,10 +1,25 @@
 #pragma once
 
 #include "../config/config.h"
+#include "cancel_key.h"
+#include "connection_breaker.h"
+#include "deadline.h"
 #include "idatabase.h"
+#include "statement_stats.h"
 
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <libpq-fe.h>
 #include <memory>
+#include <optional>
 #include <pqxx/pqxx>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace rdws::database {
 
@@ -28,51 +43,237 @@ class PostgreSQLResultSet : public IResultSet {
     bool getBool(const std::string& columnName) override;
     bool isNull(const std::string& columnName) override;
 
+    // Positional access
+    size_t getColumnIndex(const std::string& columnName) override;
+    std::string getStringAt(size_t column) override;
+    int getIntAt(size_t column) override;
+    double getDoubleAt(size_t column) override;
+    bool getBoolAt(size_t column) override;
+    bool isNullAt(size_t column) override;
+
+    // Views into the pqxx::result, which this result set keeps alive
+    std::string_view getStringView(const std::string& columnName) override;
+    std::string_view getStringViewAt(size_t column) override;
+    void getRowText(const size_t* columns, size_t count,
+                    std::optional<std::string_view>* fields) override;
+
     // Metadata
     size_t getColumnCount() override;
     std::vector<std::string> getColumnNames() override;
     size_t getRowCount() override;
+
+  private:
+    [[nodiscard]] pqxx::row currentRowData() const;
+    [[nodiscard]] pqxx::field fieldAt(size_t column) const;
+};
+
+struct StatementCacheStats {
+    uint64_t hits = 0;    // Executions of an already prepared statement
+    uint64_t misses = 0;  // Statements prepared on first use
+    size_t size = 0;      // Statements currently prepared
 };
 
 class PostgreSQLDatabase : public IDatabase {
   private:
+    // SQL text beyond this many distinct statements runs unprepared (dynamic WHERE clauses)
+    static constexpr size_t maxPreparedStatements = 256;
+    static constexpr int64_t unknownStatementTimeout = -1;
+
     rdws::Config config;
+    // Shared with every connection of the process to the same server
+    std::shared_ptr<ConnectionBreaker> breaker;
     std::unique_ptr<pqxx::connection> connection;
-    std::unique_ptr<pqxx::work> currentTransaction;
+    // Taken on connect, so the watchdog cancels without touching connection from its thread
+    CancelKey cancelKey;
+    std::unique_ptr<pqxx::transaction_base> currentTransaction;
     std::string lastError;
+    // Server-side statement name by SQL text; valid for the current connection only
+    std::unordered_map<std::string, std::string> preparedStatements;
+    std::vector<std::string> preloadedStatements;  // Prepared again after a reconnect
+    StatementCacheStats statementCacheStats;
+    uint64_t cursorCount = 0;  // Names the cursors of streamQuery uniquely per connection
+    // The libpq connection inside connection, which owns it; batches drive it in pipeline mode
+    PGconn* rawConnection = nullptr;
+
+    struct ResultDeleter {
+        void operator()(PGresult* result) const {
+            PQclear(result);
+        }
+    };
+    using PipelineResult = std::unique_ptr<PGresult, ResultDeleter>;
+
+    // One statement of a pipeline
+    struct PipelineStatement {
+        const std::string& sql;
+        const std::vector<std::string>& parameters;
+    };
+
+    // Outcome of one asynchronous statement. Its future holds it, so the result survives
+    // whatever else runs on the connection before the future is read.
+    struct AsyncResult {
+        std::string sql;
+        std::vector<std::string> parameters;
+        std::chrono::steady_clock::time_point start;
+        PipelineResult result;
+        std::exception_ptr error;
+        bool done = false;
+    };
+    // Statements of execQueryAsync/execCommandAsync not sent yet
+    std::vector<std::shared_ptr<AsyncResult>> asyncQueries;
+    // Per-statement metrics and the slow query log (DB_SLOW_QUERY_MS)
+    StatementRecorder statements;
+    // statement_timeout of the session in ms (0 = none), so it is only sent when it changes
+    int64_t sessionStatementTimeout = 0;
 
   public:
     PostgreSQLDatabase(); // Default constructor
     explicit PostgreSQLDatabase(const rdws::Config& dbConfig);
     ~PostgreSQLDatabase() override;
 
-    // Query execution
+    /**
+     * Outside a transaction the query runs in autocommit (pqxx::nontransaction), without the
+     * BEGIN and COMMIT a pqxx::work would add; execCommand does the same
+     * Like every statement, it is bounded by the thread's DeadlineScope.
+     * @throws DeadlineExceeded when the request's deadline passes before or while it runs
+     */
     std::unique_ptr<IResultSet> execQuery(const std::string& query,
                                           const std::vector<std::string>& parameters = {}) override;
 
+    /**
+     * Run query through a server-side cursor, fetching fetchSize rows per round trip
+     * Outside a transaction the cursor gets a transaction of its own for its lifetime.
+     * @throws std::runtime_error when the query fails or onRow throws
+     */
+    void streamQuery(const std::string& query, const std::vector<std::string>& parameters,
+                     const std::function<void(IResultSet&)>& onRow,
+                     size_t fetchSize = defaultFetchSize) override;
+
+    /**
+     * Queue the query on this connection and return at once
+     * Queued statements go out together as one pipeline (see execBatch) on the first get() or
+     * the next synchronous call on this database, whichever comes first. Each future keeps
+     * its own outcome, so it can still be read after that. Outside a transaction the batch
+     * runs as one implicit transaction: when one statement fails, every future of it throws.
+     */
+    std::future<std::unique_ptr<IResultSet>>
+    execQueryAsync(const std::string& query,
+                   const std::vector<std::string>& parameters = {}) override;
+    std::future<bool> execCommandAsync(const std::string& command,
+                                       const std::vector<std::string>& parameters = {}) override;
+
     // Command execution
     bool execCommand(const std::string& command,
                      const std::vector<std::string>& parameters = {}) override;
 
-    // Batch operations
+    /**
+     * Run the commands in libpq pipeline mode, as prepared statements with bound parameters
+     * Every command is sent before any result is read, so the batch costs one round trip.
+     * Outside a transaction the commands form one implicit transaction, so the first failure
+     * undoes the whole batch.
+     */
     bool execBatch(const std::vector<std::string>& commands,
                    const std::vector<std::vector<std::string>>& parameterSets) override;
 
+    /**
+     * Bulk load rows with COPY FROM STDIN (pqxx::stream_to); far cheaper per row than
+     * INSERTs, and all or nothing like execBatch
+     */
+    bool copyIn(const std::string& table, const std::vector<std::string>& columns,
+                const std::vector<std::vector<std::string>>& rows) override;
+
     // Transaction management
     void beginTransaction() override;
+    void beginReadOnlyTransaction() override;
     void commitTransaction() override;
     void rollbackTransaction() override;
 
     // Connection management
     bool isConnected() override;
+
+    /**
+     * SELECT 1 straight through libpq, without StatementMetrics or the deadline
+     */
+    bool ping() override;
+
+    /**
+     * Open the connection, unless the server's ConnectionBreaker is open
+     * @throws std::runtime_error at once while the breaker is open, else when connecting fails
+     */
     void connect() override;
     void disconnect() override;
 
     // Utility
     std::string getLastError() override;
 
+    /**
+     * Prepare statements now, and again whenever the connection is re-established
+     * @throws std::runtime_error when a statement cannot be prepared
+     */
+    void prepareStatements(const std::vector<std::string>& statements) override;
+
+    [[nodiscard]] StatementCacheStats getStatementCacheStats() const;
+
+    /**
+     * Statement cache counters summed over every connection of the process
+     */
+    static StatementCacheStats processStatementCacheStats();
+
   private:
     void ensureConnection();
+
+    /**
+     * Run statement under the DeadlineScope of this thread, if any: statement_timeout is set
+     * to the remaining budget and the QueryWatchdog cancels the statement at the deadline
+     * @throws DeadlineExceeded when the deadline has passed or cut the statement short
+     */
+    template <typename Statement>
+    auto underDeadline(Statement&& statement) -> decltype(statement());
+    // The watchdog part of underDeadline, for a statement_timeout applied earlier
+    template <typename Statement>
+    auto watchDeadline(std::optional<std::chrono::steady_clock::time_point> deadline,
+                       Statement&& statement) -> decltype(statement());
+    std::optional<std::chrono::steady_clock::time_point> applyDeadline();
+    static void checkDeadline();
+
+    /**
+     * Add a finished statement to the process-wide stats of its fingerprint and log it when
+     * it was slow; result is null when the statement failed
+     */
+    void recordStatement(const std::string& sql, size_t parameterCount,
+                         std::chrono::steady_clock::time_point start, const pqxx::result* result);
+    void recordStatement(const std::string& sql, size_t parameterCount,
+                         std::chrono::steady_clock::time_point start, const PGresult* result);
+    void recordStatement(const std::string& sql, size_t parameterCount,
+                         std::chrono::steady_clock::time_point start, bool failed, uint64_t rows,
+                         uint64_t bytes);
+
+    /**
+     * Name of the prepared statement for sql, preparing it on first use
+     * @return nullptr once the cache is full and sql is not in it
+     */
+    const std::string* preparedStatement(const std::string& sql);
+    const std::string& addPreparedStatement(const std::string& sql);
+    void clearPreparedStatements();
+
+    /**
+     * Send statements in libpq pipeline mode and read their results; one round trip in all
+     * Each runs as a prepared statement while the cache has room (PQsendQueryPrepared).
+     * @return One result per statement, in order
+     * @throws std::runtime_error with the first failure, once every result has been read;
+     *         pqxx::query_canceled for a canceled statement
+     */
+    std::vector<PipelineResult> runPipeline(const std::vector<PipelineStatement>& batch);
+    // Write out the pipeline, reading meanwhile so the server never blocks on its results
+    void flushPipeline();
+
+    std::shared_ptr<AsyncResult> queueAsync(const std::string& sql,
+                                            const std::vector<std::string>& parameters);
+    // Outcome of pending, sending the queued statements first if they are still waiting
+    PipelineResult awaitAsync(AsyncResult& pending);
+    // Send every queued statement and store each outcome for its future
+    void finishAsyncQueries();
+    // Fail every queued statement without sending it
+    void abandonAsyncQueries();
 };
 
 } // namespace rdws::database
@@ -0,0 +1,143 @@
+#include "pq_result_set.h"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace rdws::database {
+
+PqResultSet::PqResultSet(PGresult* res) : result(res), rowCount(res ? PQntuples(res) : 0) {}
+
+bool PqResultSet::next() {
+    if (currentRow < rowCount) {
+        ++currentRow;
+        return true;
+    }
+    return false;
+}
+
+bool PqResultSet::previous() {
+    if (currentRow > 1) {
+        --currentRow;
+        return true;
+    }
+    return false;
+}
+
+void PqResultSet::reset() {
+    currentRow = 0;
+}
+
+std::string PqResultSet::getString(const std::string& columnName) {
+    return value(columnName);
+}
+
+int PqResultSet::getInt(const std::string& columnName) {
+    return std::stoi(value(columnName));
+}
+
+double PqResultSet::getDouble(const std::string& columnName) {
+    return std::stod(value(columnName));
+}
+
+bool PqResultSet::getBool(const std::string& columnName) {
+    const std::string text = value(columnName);
+    return text == "t" || text == "true";
+}
+
+bool PqResultSet::isNull(const std::string& columnName) {
+    value(columnName);
+    return PQgetisnull(result.get(), currentRow - 1, column(columnName)) == 1;
+}
+
+size_t PqResultSet::getColumnIndex(const std::string& columnName) {
+    return static_cast<size_t>(column(columnName));
+}
+
+std::string PqResultSet::getStringAt(const size_t column) {
+    return std::string(getStringViewAt(column));
+}
+
+int PqResultSet::getIntAt(const size_t column) {
+    return std::stoi(valueAt(column));
+}
+
+double PqResultSet::getDoubleAt(const size_t column) {
+    return std::stod(valueAt(column));
+}
+
+bool PqResultSet::getBoolAt(const size_t column) {
+    const char* text = valueAt(column);
+    return std::strcmp(text, "t") == 0 || std::strcmp(text, "true") == 0;
+}
+
+bool PqResultSet::isNullAt(const size_t column) {
+    valueAt(column);
+    return PQgetisnull(result.get(), currentRow - 1, static_cast<int>(column)) == 1;
+}
+
+std::string_view PqResultSet::getStringView(const std::string& columnName) {
+    return getStringViewAt(static_cast<size_t>(column(columnName)));
+}
+
+std::string_view PqResultSet::getStringViewAt(const size_t column) {
+    const char* text = valueAt(column);
+    const int length = PQgetlength(result.get(), currentRow - 1, static_cast<int>(column));
+    return {text, static_cast<size_t>(length)};
+}
+
+void PqResultSet::getRowText(const size_t* columns, const size_t count,
+                             std::optional<std::string_view>* fields) {
+    for (size_t i = 0; i < count; ++i) {
+        const char* text = valueAt(columns[i]);
+        const int column = static_cast<int>(columns[i]);
+        if (PQgetisnull(result.get(), currentRow - 1, column) == 1) {
+            fields[i] = std::nullopt;
+        } else {
+            const int length = PQgetlength(result.get(), currentRow - 1, column);
+            fields[i] = std::string_view(text, static_cast<size_t>(length));
+        }
+    }
+}
+
+size_t PqResultSet::getColumnCount() {
+    return result ? static_cast<size_t>(PQnfields(result.get())) : 0;
+}
+
+std::vector<std::string> PqResultSet::getColumnNames() {
+    std::vector<std::string> names;
+    for (size_t i = 0; i < getColumnCount(); ++i) {
+        names.emplace_back(PQfname(result.get(), static_cast<int>(i)));
+    }
+    return names;
+}
+
+size_t PqResultSet::getRowCount() {
+    return static_cast<size_t>(rowCount);
+}
+
+int PqResultSet::column(const std::string& columnName) const {
+    const int index = result ? PQfnumber(result.get(), columnName.c_str()) : -1;
+    if (index < 0) {
+        throw std::runtime_error("Unknown column: " + columnName);
+    }
+    return index;
+}
+
+const char* PqResultSet::value(const std::string& columnName) const {
+    if (currentRow == 0 || currentRow > rowCount) {
+        throw std::runtime_error("Invalid row position");
+    }
+    return PQgetvalue(result.get(), currentRow - 1, column(columnName));
+}
+
+const char* PqResultSet::valueAt(const size_t column) const {
+    if (currentRow == 0 || currentRow > rowCount) {
+        throw std::runtime_error("Invalid row position");
+    }
+    if (column >= static_cast<size_t>(PQnfields(result.get()))) {
+        throw std::runtime_error("Invalid column index: " + std::to_string(column));
+    }
+    return PQgetvalue(result.get(), currentRow - 1, static_cast<int>(column));
+}
+
+} // namespace rdws::database
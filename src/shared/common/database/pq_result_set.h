@@ -0,0 +1,73 @@
+#pragma once
+
+#include "idatabase.h"
+
+#include <libpq-fe.h>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rdws::database {
+
+/**
+ * PqResultSet - IResultSet over a raw libpq result
+ * Same cursor semantics as PostgreSQLResultSet: call next() before reading the first row.
+ */
+class PqResultSet : public IResultSet {
+  private:
+    struct ResultDeleter {
+        void operator()(PGresult* result) const {
+            PQclear(result);
+        }
+    };
+
+    std::unique_ptr<PGresult, ResultDeleter> result;
+    int rowCount;
+    int currentRow = 0;
+
+  public:
+    /**
+     * @param res Result to take ownership of
+     */
+    explicit PqResultSet(PGresult* res);
+
+    // Navigation
+    bool next() override;
+    bool previous() override;
+    void reset() override;
+
+    // Data access
+    std::string getString(const std::string& columnName) override;
+    int getInt(const std::string& columnName) override;
+    double getDouble(const std::string& columnName) override;
+    bool getBool(const std::string& columnName) override;
+    bool isNull(const std::string& columnName) override;
+
+    // Positional access
+    size_t getColumnIndex(const std::string& columnName) override;
+    std::string getStringAt(size_t column) override;
+    int getIntAt(size_t column) override;
+    double getDoubleAt(size_t column) override;
+    bool getBoolAt(size_t column) override;
+    bool isNullAt(size_t column) override;
+
+    // Views into the PGresult, which this result set owns
+    std::string_view getStringView(const std::string& columnName) override;
+    std::string_view getStringViewAt(size_t column) override;
+    void getRowText(const size_t* columns, size_t count,
+                    std::optional<std::string_view>* fields) override;
+
+    // Metadata
+    size_t getColumnCount() override;
+    std::vector<std::string> getColumnNames() override;
+    size_t getRowCount() override;
+
+  private:
+    int column(const std::string& columnName) const;
+    const char* value(const std::string& columnName) const;
+    const char* valueAt(size_t column) const;
+};
+
+} // namespace rdws::database
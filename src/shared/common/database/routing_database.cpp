@@ -0,0 +1,385 @@
+#include "routing_database.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace rdws::database {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Milliseconds the replica trails the primary; 0 when it has replayed everything received,
+// so an idle primary does not make a caught-up replica look stale
+constexpr auto replicaLagQuery =
+    "SELECT (CASE WHEN pg_last_wal_receive_lsn() = pg_last_wal_replay_lsn() THEN 0 "
+    "ELSE COALESCE(EXTRACT(EPOCH FROM now() - pg_last_xact_replay_timestamp()) * 1000, 0) "
+    "END)::int AS lag_ms";
+
+constexpr size_t noReplica = std::numeric_limits<size_t>::max();
+
+bool startsWithKeyword(const std::string& text, const size_t position, const char* keyword) {
+    const size_t length = std::strlen(keyword);
+    if (text.size() - position < length) {
+        return false;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        if (std::tolower(static_cast<unsigned char>(text[position + i])) != keyword[i]) {
+            return false;
+        }
+    }
+    const size_t end = position + length;
+    return end == text.size() ||
+           (std::isalnum(static_cast<unsigned char>(text[end])) == 0 && text[end] != '_');
+}
+
+} // namespace
+
+// ReplicaSet Implementation
+
+ReplicaSet::ReplicaSet(std::vector<Replica> replicaPools, const Options setOptions)
+    : options(setOptions) {
+    for (auto& replica : replicaPools) {
+        State state;
+        state.replica = std::move(replica);
+        replicas.push_back(std::move(state));
+    }
+    checkLag();
+    for (size_t i = 0; i < replicas.size(); ++i) {
+        replicas[i].replica.pool->setMaintenanceTask([this, i] { checkLag(i); },
+                                                     options.lagCheckInterval);
+    }
+}
+
+ReplicaSet::~ReplicaSet() {
+    // Waits for a check in progress, which uses this set
+    for (auto& state : replicas) {
+        state.replica.pool->setMaintenanceTask({}, options.lagCheckInterval);
+    }
+}
+
+ReplicaSet::Lease ReplicaSet::acquire() {
+    size_t chosen = noReplica;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        chosen = pick();
+        if (chosen == noReplica) {
+            ++primaryReads;
+            return {};
+        }
+        ++replicas[chosen].reads;
+    }
+
+    // An exhausted replica pool sends the read to the primary rather than make it wait
+    bool failed = false;
+    try {
+        if (auto connection = replicas[chosen].replica.pool->tryAcquire()) {
+            return {chosen, std::move(connection)};
+        }
+    } catch (const std::exception&) {
+        failed = true;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (failed) {
+        replicas[chosen].usable = false;
+    }
+    ++primaryReads;
+    return {};
+}
+
+void ReplicaSet::checkLag() {
+    for (size_t i = 0; i < replicas.size(); ++i) {
+        checkLag(i);
+    }
+}
+
+void ReplicaSet::markFailed(const size_t replica) {
+    std::lock_guard<std::mutex> lock(mutex);
+    replicas.at(replica).usable = false;
+}
+
+void ReplicaSet::prepareStatements(const std::vector<std::string>& statements) {
+    for (const auto& state : replicas) {
+        try {
+            state.replica.pool->prepareStatements(statements);
+        } catch (const std::exception&) {
+            // Unprepared statements still run; a broken replica is caught by its lag check
+        }
+    }
+}
+
+std::string ReplicaSet::describe() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream out;
+    for (const auto& state : replicas) {
+        out << state.replica.name << (state.usable ? "" : " (skipped)")
+            << " lagMs=" << state.lagMillis << " reads=" << state.reads << " ";
+    }
+    out << "primaryReads=" << primaryReads;
+    return out.str();
+}
+
+void ReplicaSet::checkLag(const size_t replica) {
+    std::optional<int64_t> lag;
+    try {
+        const auto lease = replicas[replica].replica.pool->tryAcquire();
+        if (!lease) {
+            // Every connection is serving reads: keep the last measurement
+            return;
+        }
+        if (const auto result = lease->execQuery(replicaLagQuery); result && result->next()) {
+            lag = result->getInt("lag_ms");
+        }
+    } catch (const std::exception&) {
+        // Unreachable: skipped until the next check
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& state = replicas[replica];
+    state.lagMillis = lag.value_or(0);
+    state.usable = lag.has_value() && std::chrono::milliseconds(*lag) <= options.maxLag;
+}
+
+size_t ReplicaSet::pick() {
+    size_t chosen = noReplica;
+    size_t chosenLoad = std::numeric_limits<size_t>::max();
+    for (size_t offset = 0; offset < replicas.size(); ++offset) {
+        const size_t candidate = (nextReplica + offset) % replicas.size();
+        if (!replicas[candidate].usable) {
+            continue;
+        }
+        if (options.policy == Policy::RoundRobin) {
+            chosen = candidate;
+            break;
+        }
+        const auto stats = replicas[candidate].replica.pool->stats();
+        if (const size_t load = stats.inUse + stats.waiting; load < chosenLoad) {
+            chosen = candidate;
+            chosenLoad = load;
+        }
+    }
+    if (chosen != noReplica) {
+        nextReplica = (chosen + 1) % replicas.size();
+    }
+    return chosen;
+}
+
+// RoutingDatabase Implementation
+
+RoutingDatabase::RoutingDatabase(std::shared_ptr<IDatabase> primaryDatabase,
+                                 std::shared_ptr<ReplicaSet> replicaSet)
+    : primary(std::move(primaryDatabase)), replicas(std::move(replicaSet)) {
+    if (!primary || !replicas) {
+        throw std::invalid_argument("RoutingDatabase needs a primary and a replica set");
+    }
+}
+
+std::unique_ptr<IResultSet> RoutingDatabase::execQuery(const std::string& query,
+                                                       const std::vector<std::string>& parameters) {
+    if (readsFromReplica(query)) {
+        if (auto lease = replicas->acquire(); lease.connection) {
+            try {
+                return lease.connection->execQuery(query, parameters);
+            } catch (const std::exception&) {
+                if (!lease.connection->isConnected()) {
+                    replicas->markFailed(lease.replica);
+                }
+            }
+        }
+    }
+    recordQueryWrite(query);
+    return primary->execQuery(query, parameters);
+}
+
+void RoutingDatabase::streamQuery(const std::string& query,
+                                  const std::vector<std::string>& parameters,
+                                  const std::function<void(IResultSet&)>& onRow,
+                                  const size_t fetchSize) {
+    if (readsFromReplica(query)) {
+        if (auto lease = replicas->acquire(); lease.connection) {
+            bool delivered = false;
+            try {
+                lease.connection->streamQuery(
+                    query, parameters,
+                    [&onRow, &delivered](IResultSet& row) {
+                        delivered = true;
+                        onRow(row);
+                    },
+                    fetchSize);
+                return;
+            } catch (const std::exception&) {
+                if (!lease.connection->isConnected()) {
+                    replicas->markFailed(lease.replica);
+                }
+                // Starting over on the primary would hand the same rows out twice
+                if (delivered) {
+                    throw;
+                }
+            }
+        }
+    }
+    recordQueryWrite(query);
+    primary->streamQuery(query, parameters, onRow, fetchSize);
+}
+
+std::future<std::unique_ptr<IResultSet>>
+RoutingDatabase::execQueryAsync(const std::string& query,
+                                const std::vector<std::string>& parameters) {
+    if (readsFromReplica(query)) {
+        if (auto lease = replicaForAsync()) {
+            auto pending = lease->connection->execQueryAsync(query, parameters);
+            // The future keeps the replica lease; a failed read is retried on the primary
+            return std::async(std::launch::deferred, [this, query, parameters,
+                                                      lease = std::move(lease),
+                                                      pending = std::move(pending)]() mutable {
+                try {
+                    return pending.get();
+                } catch (const std::exception&) {
+                    if (!lease->connection->isConnected()) {
+                        replicas->markFailed(lease->replica);
+                    }
+                    return primary->execQuery(query, parameters);
+                }
+            });
+        }
+    }
+    recordQueryWrite(query);
+    return primary->execQueryAsync(query, parameters);
+}
+
+bool RoutingDatabase::execCommand(const std::string& command,
+                                  const std::vector<std::string>& parameters) {
+    recordWrite();
+    return primary->execCommand(command, parameters);
+}
+
+std::future<bool> RoutingDatabase::execCommandAsync(const std::string& command,
+                                                    const std::vector<std::string>& parameters) {
+    recordWrite();
+    return primary->execCommandAsync(command, parameters);
+}
+
+bool RoutingDatabase::execBatch(const std::vector<std::string>& commands,
+                                const std::vector<std::vector<std::string>>& parameterSets) {
+    recordWrite();
+    return primary->execBatch(commands, parameterSets);
+}
+
+bool RoutingDatabase::copyIn(const std::string& table, const std::vector<std::string>& columns,
+                             const std::vector<std::vector<std::string>>& rows) {
+    recordWrite();
+    return primary->copyIn(table, columns, rows);
+}
+
+void RoutingDatabase::beginTransaction() {
+    primary->beginTransaction();
+    inTransaction = true;
+}
+
+void RoutingDatabase::beginReadOnlyTransaction() {
+    primary->beginReadOnlyTransaction();
+    inTransaction = true;
+    readOnlyTransaction = true;
+}
+
+void RoutingDatabase::commitTransaction() {
+    // Whatever the transaction wrote is only on the primary for now
+    if (!readOnlyTransaction) {
+        recordWrite();
+    }
+    inTransaction = false;
+    readOnlyTransaction = false;
+    primary->commitTransaction();
+}
+
+void RoutingDatabase::rollbackTransaction() {
+    inTransaction = false;
+    readOnlyTransaction = false;
+    primary->rollbackTransaction();
+}
+
+bool RoutingDatabase::isConnected() {
+    return primary->isConnected();
+}
+
+void RoutingDatabase::connect() {
+    primary->connect();
+}
+
+void RoutingDatabase::disconnect() {
+    inTransaction = false;
+    readOnlyTransaction = false;
+    primary->disconnect();
+}
+
+std::string RoutingDatabase::getLastError() {
+    return primary->getLastError();
+}
+
+void RoutingDatabase::prepareStatements(const std::vector<std::string>& statements) {
+    primary->prepareStatements(statements);
+    replicas->prepareStatements(statements);
+}
+
+bool RoutingDatabase::isReadOnlyQuery(const std::string& query) {
+    const size_t start = query.find_first_not_of(" \t\r\n(");
+    if (start == std::string::npos || !startsWithKeyword(query, start, "select")) {
+        return false;
+    }
+
+    // Row locks (FOR UPDATE, FOR NO KEY UPDATE, FOR SHARE, FOR KEY SHARE) need the primary
+    for (size_t i = start + 6; i < query.size(); ++i) {
+        if (std::isspace(static_cast<unsigned char>(query[i - 1])) == 0 ||
+            !startsWithKeyword(query, i, "for")) {
+            continue;
+        }
+        const size_t next = query.find_first_not_of(" \t\r\n", i + 3);
+        if (next == std::string::npos) {
+            break;
+        }
+        for (const char* lockStrength : {"update", "share", "no", "key"}) {
+            if (startsWithKeyword(query, next, lockStrength)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool RoutingDatabase::readsFromReplica(const std::string& query) const {
+    return !inTransaction && Clock::now() - lastWrite >= replicas->getOptions().maxLag &&
+           isReadOnlyQuery(query);
+}
+
+void RoutingDatabase::recordWrite() {
+    lastWrite = Clock::now();
+}
+
+void RoutingDatabase::recordQueryWrite(const std::string& query) {
+    // INSERT/UPDATE ... RETURNING and writable CTEs come through the query methods too;
+    // a transaction records its writes when it commits
+    if (!inTransaction && !isReadOnlyQuery(query)) {
+        recordWrite();
+    }
+}
+
+std::shared_ptr<ReplicaSet::Lease> RoutingDatabase::replicaForAsync() {
+    if (auto lease = asyncReplica.lock()) {
+        return lease;
+    }
+    auto lease = replicas->acquire();
+    if (!lease.connection) {
+        return nullptr;
+    }
+    auto shared = std::make_shared<ReplicaSet::Lease>(std::move(lease));
+    asyncReplica = shared;
+    return shared;
+}
+
+} // namespace rdws::database
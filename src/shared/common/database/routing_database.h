@@ -0,0 +1,178 @@
+#pragma once
+
+#include "idatabase.h"
+#include "postgresql_connection_pool.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace rdws::database {
+
+/**
+ * ReplicaSet - Read replicas shared by every RoutingDatabase of the process
+ *
+ * Picks the replica to read from, round-robin or least loaded (fewest leased plus waiting
+ * connections in its pool). A read never waits for a replica: when the chosen pool has no
+ * free connection it goes to the primary. Replication lag is measured when the set is built
+ * and then every lagCheckInterval on the maintenance thread of the replica's pool, so reads
+ * never run a check. A replica further behind than maxLag, or one whose check or connection
+ * failed, is skipped until a later check clears it.
+ */
+class ReplicaSet {
+  public:
+    enum class Policy { RoundRobin, LeastLoaded };
+
+    struct Options {
+        Policy policy = Policy::LeastLoaded;
+        std::chrono::milliseconds maxLag{1000};
+        std::chrono::milliseconds lagCheckInterval{1000};
+    };
+
+    struct Replica {
+        std::string name;  // host[:port], for the logs
+        std::shared_ptr<PostgreSQLConnectionPool> pool;
+    };
+
+    /**
+     * A connection on one replica; connection is null when no replica can serve the read
+     */
+    struct Lease {
+        size_t replica = 0;
+        std::unique_ptr<PooledConnection> connection;
+    };
+
+  private:
+    struct State {
+        Replica replica;
+        bool usable = false;
+        int64_t lagMillis = 0;
+        uint64_t reads = 0;
+    };
+
+    const Options options;
+    mutable std::mutex mutex;
+    std::vector<State> replicas;
+    size_t nextReplica = 0;     // Round-robin cursor, also breaks least-loaded ties
+    uint64_t primaryReads = 0;  // Reads that found no usable replica
+
+  public:
+    ReplicaSet(std::vector<Replica> replicaPools, Options setOptions);
+    ~ReplicaSet();
+
+    ReplicaSet(const ReplicaSet&) = delete;
+    ReplicaSet& operator=(const ReplicaSet&) = delete;
+
+    /**
+     * Lease a connection on the replica to read from next, without waiting for one
+     */
+    Lease acquire();
+
+    /**
+     * Measure the lag of every replica now, instead of at their next scheduled check
+     */
+    void checkLag();
+
+    /**
+     * Take a replica out of rotation until its next lag check
+     */
+    void markFailed(size_t replica);
+
+    /**
+     * Prepare statements on every replica connection, including ones opened later
+     */
+    void prepareStatements(const std::vector<std::string>& statements);
+
+    [[nodiscard]] const Options& getOptions() const {
+        return options;
+    }
+
+    /**
+     * One-line summary of every replica for the logs
+     */
+    [[nodiscard]] std::string describe() const;
+
+  private:
+    void checkLag(size_t replica);
+    size_t pick();  // Called with the mutex held
+};
+
+/**
+ * RoutingDatabase - IDatabase that sends reads to replicas and everything else to the primary
+ *
+ * A SELECT (without FOR UPDATE/SHARE) outside a transaction is read from a replica of the
+ * ReplicaSet. Writes, transactions and every read issued within maxLag of this instance's
+ * last write go to the primary, so a request always sees its own changes. A read that fails
+ * on a replica is retried on the primary. Like PooledDatabase, one instance is meant for one
+ * thread at a time; the primary pool and the replica set behind it are shared.
+ */
+class RoutingDatabase : public IDatabase {
+  private:
+    std::shared_ptr<IDatabase> primary;
+    std::shared_ptr<ReplicaSet> replicas;
+    bool inTransaction = false;
+    bool readOnlyTransaction = false;  // Nothing to wait for on the replicas after its commit
+    std::chrono::steady_clock::time_point lastWrite;
+    // Replica connection of the asynchronous reads still unread, so they share one pipeline
+    std::weak_ptr<ReplicaSet::Lease> asyncReplica;
+
+  public:
+    RoutingDatabase(std::shared_ptr<IDatabase> primaryDatabase,
+                    std::shared_ptr<ReplicaSet> replicaSet);
+
+    // Query execution
+    std::unique_ptr<IResultSet> execQuery(const std::string& query,
+                                          const std::vector<std::string>& parameters = {}) override;
+    void streamQuery(const std::string& query, const std::vector<std::string>& parameters,
+                     const std::function<void(IResultSet&)>& onRow,
+                     size_t fetchSize = defaultFetchSize) override;
+    std::future<std::unique_ptr<IResultSet>>
+    execQueryAsync(const std::string& query,
+                   const std::vector<std::string>& parameters = {}) override;
+
+    // Command execution
+    bool execCommand(const std::string& command,
+                     const std::vector<std::string>& parameters = {}) override;
+    std::future<bool> execCommandAsync(const std::string& command,
+                                       const std::vector<std::string>& parameters = {}) override;
+
+    // Batch operations
+    bool execBatch(const std::vector<std::string>& commands,
+                   const std::vector<std::vector<std::string>>& parameterSets) override;
+    bool copyIn(const std::string& table, const std::vector<std::string>& columns,
+                const std::vector<std::vector<std::string>>& rows) override;
+
+    // Transaction management
+    void beginTransaction() override;
+    void beginReadOnlyTransaction() override;
+    void commitTransaction() override;
+    void rollbackTransaction() override;
+
+    // Connection management
+    bool isConnected() override;
+    void connect() override;
+    void disconnect() override;
+
+    // Utility
+    std::string getLastError() override;
+
+    void prepareStatements(const std::vector<std::string>& statements) override;
+
+    /**
+     * True for a single SELECT that takes no row locks (case-insensitive)
+     */
+    static bool isReadOnlyQuery(const std::string& query);
+
+  private:
+    [[nodiscard]] bool readsFromReplica(const std::string& query) const;
+    void recordWrite();
+    // recordWrite() for a query that is not known to be read-only
+    void recordQueryWrite(const std::string& query);
+    // The replica lease of pending asynchronous reads, or a new one; null without a replica
+    std::shared_ptr<ReplicaSet::Lease> replicaForAsync();
+};
+
+} // namespace rdws::database
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "idatabase.h"
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace rdws::database {
+
+/**
+ * Text format of a column as PostgreSQL sends it, which decides how a field is decoded
+ */
+enum class WireType { Integer, Float, Boolean, Text };
+
+/**
+ * One column of an entity: its name in SQL, the member it maps to and its wire type
+ */
+template <WireType Wire, typename Entity, typename Member> struct ColumnField {
+    static constexpr WireType wire = Wire;
+
+    const char* name;
+    Member Entity::*member;
+};
+
+template <WireType Wire, typename Entity, typename Member>
+constexpr ColumnField<Wire, Entity, Member> column(const char* name, Member Entity::*member) {
+    return {name, member};
+}
+
+/**
+ * Columns of an entity, specialized once per entity next to its repository:
+ *
+ *   template <> struct RowDescriptor<types::User> {
+ *       static constexpr auto fields =
+ *           std::make_tuple(column<WireType::Integer>("id", &types::User::id),
+ *                           column<WireType::Text>("name", &types::User::name));
+ *   };
+ */
+template <typename Entity> struct RowDescriptor;
+
+namespace detail {
+
+template <typename T> struct IsOptional : std::false_type {};
+template <typename T> struct IsOptional<std::optional<T>> : std::true_type {};
+
+template <WireType Wire, typename Value>
+void decodeField(const std::string_view text, Value& value, const char* name) {
+    if constexpr (Wire == WireType::Text && std::is_same_v<Value, std::string_view>) {
+        value = text;
+    } else if constexpr (Wire == WireType::Text) {
+        value.assign(text.data(), text.size());
+    } else if constexpr (Wire == WireType::Boolean) {
+        value = text == "t" || text == "true";
+    } else {
+        static_assert(Wire != WireType::Integer || std::is_integral_v<Value>,
+                      "Integer columns map to integral members");
+        static_assert(Wire != WireType::Float || std::is_floating_point_v<Value>,
+                      "Float columns map to floating point members");
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc() || end != text.data() + text.size()) {
+            throw std::runtime_error("Invalid value in column " + std::string(name) + ": " +
+                                     std::string(text));
+        }
+    }
+}
+
+} // namespace detail
+
+/**
+ * RowMapper - Builds entities from the rows of one result, driven by RowDescriptor<Entity>
+ *
+ * The column positions are resolved on the first read() and reused for every later row.
+ * Each row is then fetched with a single getRowText call and decoded field by field in
+ * inline code, so there is one virtual call per row rather than one per field. NULL maps
+ * to std::nullopt for std::optional members and throws for any other. Text columns may
+ * map to std::string_view members, which then point into the result instead of copying; such
+ * an entity is only valid as long as the result's row. Use one mapper per result:
+ *
+ *   RowMapper<types::User> mapper;
+ *   while (result->next()) {
+ *       users.push_back(mapper.read(*result));
+ *   }
+ */
+template <typename Entity> class RowMapper {
+  private:
+    static constexpr auto& fields = RowDescriptor<Entity>::fields;
+    static constexpr size_t fieldCount =
+        std::tuple_size_v<std::decay_t<decltype(RowDescriptor<Entity>::fields)>>;
+
+    std::array<size_t, fieldCount> columns{};
+    std::array<std::optional<std::string_view>, fieldCount> text;
+    bool resolved = false;
+
+  public:
+    /**
+     * Entity of the current row
+     * @throws std::runtime_error when a column is missing, NULL or not of its wire type
+     */
+    Entity read(IResultSet& result) {
+        if (!resolved) {
+            resolveColumns(result, std::make_index_sequence<fieldCount>{});
+            resolved = true;
+        }
+        result.getRowText(columns.data(), fieldCount, text.data());
+
+        Entity entity{};
+        decodeFields(entity, std::make_index_sequence<fieldCount>{});
+        return entity;
+    }
+
+    /**
+     * The mapped columns as a SELECT or RETURNING list ("id, name, ..."), built once
+     */
+    static const std::string& columnList() {
+        static const std::string list = [] {
+            std::string joined;
+            std::apply(
+                [&joined](const auto&... field) {
+                    ((joined += (joined.empty() ? "" : ", "), joined += field.name), ...);
+                },
+                fields);
+            return joined;
+        }();
+        return list;
+    }
+
+  private:
+    template <size_t... Indices>
+    void resolveColumns(IResultSet& result, std::index_sequence<Indices...>) {
+        ((columns[Indices] = result.getColumnIndex(std::get<Indices>(fields).name)), ...);
+    }
+
+    template <size_t... Indices>
+    void decodeFields(Entity& entity, std::index_sequence<Indices...>) const {
+        (decodeField(entity, std::get<Indices>(fields), text[Indices]), ...);
+    }
+
+    template <typename Field>
+    static void decodeField(Entity& entity, const Field& field,
+                            const std::optional<std::string_view>& fieldText) {
+        auto& value = entity.*(field.member);
+        using Value = std::decay_t<decltype(value)>;
+
+        if constexpr (detail::IsOptional<Value>::value) {
+            if (!fieldText) {
+                value.reset();
+                return;
+            }
+            detail::decodeField<Field::wire>(*fieldText, value.emplace(), field.name);
+        } else {
+            if (!fieldText) {
+                throw std::runtime_error("Unexpected NULL in column " + std::string(field.name));
+            }
+            detail::decodeField<Field::wire>(*fieldText, value, field.name);
+        }
+    }
+};
+
+} // namespace rdws::database
@@ -0,0 +1,216 @@
+#include "statement_stats.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace rdws::database {
+
+namespace {
+
+constexpr auto otherStatements = "(other)";
+
+std::mutex statementsMutex;
+std::unordered_map<std::string, std::unique_ptr<StatementStats>> statements;
+
+bool isIdentifierChar(const char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_' || c == '$';
+}
+
+} // namespace
+
+// LatencyHistogram Implementation
+
+void LatencyHistogram::record(const std::chrono::microseconds elapsed) {
+    const auto micros = static_cast<uint64_t>(std::max<int64_t>(elapsed.count(), 0));
+    buckets[bucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    totalMicros.fetch_add(micros, std::memory_order_relaxed);
+
+    uint64_t seen = maxMicros.load(std::memory_order_relaxed);
+    while (micros > seen &&
+           !maxMicros.compare_exchange_weak(seen, micros, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t LatencyHistogram::getCount() const {
+    return count.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::getTotalMicros() const {
+    return totalMicros.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::getMaxMicros() const {
+    return maxMicros.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::percentileMicros(const double quantile) const {
+    // Buckets are read one by one while others record, so the total is taken from them
+    std::array<uint64_t, bucketCount> counts{};
+    uint64_t total = 0;
+    for (size_t i = 0; i < bucketCount; ++i) {
+        counts[i] = buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    const auto rank = std::max<uint64_t>(
+        1, static_cast<uint64_t>(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(total)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < bucketCount; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::min(bucketUpperBound(i), getMaxMicros());
+        }
+    }
+    return getMaxMicros();
+}
+
+size_t LatencyHistogram::bucketIndex(const uint64_t micros) {
+    if (micros < subBuckets) {
+        return static_cast<size_t>(micros);
+    }
+    // Bucket of the highest set bit, then the next three bits pick the sub-bucket
+    const unsigned magnitude = 63 - static_cast<unsigned>(__builtin_clzll(micros));
+    const size_t index =
+        (magnitude - 2) * subBuckets + ((micros >> (magnitude - 3)) & (subBuckets - 1));
+    return std::min(index, bucketCount - 1);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(const size_t index) {
+    if (index < subBuckets) {
+        return index;
+    }
+    const size_t magnitude = index / subBuckets + 2;
+    const uint64_t lower = (subBuckets + index % subBuckets) << (magnitude - 3);
+    return lower + (uint64_t{1} << (magnitude - 3)) - 1;
+}
+
+// Fingerprints
+
+std::string fingerprintStatement(const std::string& sql) {
+    std::string fingerprint;
+    fingerprint.reserve(sql.size());
+
+    for (size_t i = 0; i < sql.size(); ++i) {
+        const char c = sql[i];
+        if (std::isspace(static_cast<unsigned char>(c)) != 0) {
+            if (!fingerprint.empty() && fingerprint.back() != ' ') {
+                fingerprint += ' ';
+            }
+        } else if (c == '\'') {
+            // A doubled quote is an escaped one and stays inside the literal
+            for (++i; i < sql.size(); ++i) {
+                if (sql[i] == '\'' && (i + 1 == sql.size() || sql[i + 1] != '\'')) {
+                    break;
+                }
+                i += sql[i] == '\'' ? 1 : 0;
+            }
+            fingerprint += '?';
+        } else if (c == '"') {
+            const size_t end = sql.find('"', i + 1);
+            const size_t last = end == std::string::npos ? sql.size() - 1 : end;
+            fingerprint.append(sql, i, last - i + 1);
+            i = last;
+        } else if (std::isdigit(static_cast<unsigned char>(c)) != 0 &&
+                   (fingerprint.empty() || !isIdentifierChar(fingerprint.back()))) {
+            while (i + 1 < sql.size() &&
+                   (std::isdigit(static_cast<unsigned char>(sql[i + 1])) != 0 ||
+                    sql[i + 1] == '.')) {
+                ++i;
+            }
+            fingerprint += '?';
+        } else {
+            fingerprint += c;
+        }
+    }
+
+    if (!fingerprint.empty() && fingerprint.back() == ' ') {
+        fingerprint.pop_back();
+    }
+    return fingerprint;
+}
+
+// StatementMetrics Implementation
+
+StatementStats& StatementMetrics::forStatement(const std::string& sql) {
+    std::string fingerprint = fingerprintStatement(sql);
+
+    std::lock_guard<std::mutex> lock(statementsMutex);
+    if (const auto found = statements.find(fingerprint); found != statements.end()) {
+        return *found->second;
+    }
+    if (statements.size() >= maxStatements) {
+        fingerprint = otherStatements;
+    }
+    auto& entry = statements[fingerprint];
+    if (!entry) {
+        entry = std::make_unique<StatementStats>(fingerprint);
+    }
+    return *entry;
+}
+
+std::vector<StatementSummary> StatementMetrics::snapshot() {
+    std::vector<StatementSummary> summaries;
+    {
+        std::lock_guard<std::mutex> lock(statementsMutex);
+        summaries.reserve(statements.size());
+        for (const auto& [fingerprint, stats] : statements) {
+            StatementSummary summary;
+            summary.fingerprint = fingerprint;
+            summary.calls = stats->latency.getCount();
+            summary.errors = stats->errors.load(std::memory_order_relaxed);
+            summary.rows = stats->rows.load(std::memory_order_relaxed);
+            summary.bytes = stats->bytes.load(std::memory_order_relaxed);
+            summary.totalMicros = stats->latency.getTotalMicros();
+            summary.p50Micros = stats->latency.percentileMicros(0.50);
+            summary.p95Micros = stats->latency.percentileMicros(0.95);
+            summary.p99Micros = stats->latency.percentileMicros(0.99);
+            summary.maxMicros = stats->latency.getMaxMicros();
+            summaries.push_back(std::move(summary));
+        }
+    }
+
+    std::sort(summaries.begin(), summaries.end(), [](const auto& a, const auto& b) {
+        return a.totalMicros > b.totalMicros;
+    });
+    return summaries;
+}
+
+// StatementRecorder Implementation
+
+void StatementRecorder::record(const std::string& sql, const size_t parameterCount,
+                               const std::chrono::microseconds elapsed, const bool failed,
+                               const uint64_t rows, const uint64_t bytes) {
+    StatementStats* stats = nullptr;
+    if (const auto found = entries.find(sql); found != entries.end()) {
+        stats = found->second;
+    } else {
+        stats = &StatementMetrics::forStatement(sql);
+        // SQL past the capacity is looked up every time
+        if (entries.size() < capacity) {
+            entries.emplace(sql, stats);
+        }
+    }
+    stats->latency.record(elapsed);
+    stats->rows.fetch_add(rows, std::memory_order_relaxed);
+    stats->bytes.fetch_add(bytes, std::memory_order_relaxed);
+    if (failed) {
+        stats->errors.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Parameter values are left out of the log: they may be personal data
+    if (slowQueryThreshold.count() > 0 && elapsed >= slowQueryThreshold) {
+        std::cerr << "Slow query: " << elapsed.count() / 1000 << " ms, " << parameterCount
+                  << " parameters, " << rows << " rows" << (failed ? ", failed" : "") << ": "
+                  << sql << std::endl;
+    }
+}
+
+} // namespace rdws::database
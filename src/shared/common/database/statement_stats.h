@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace rdws::database {
+
+/**
+ * LatencyHistogram - Lock-free log-linear histogram of durations in microseconds
+ *
+ * Like an HDR histogram with one significant digit: every power of two is split into 8
+ * buckets, so a recorded value is off by at most 12.5% over the range from 1 µs to
+ * about 12 days. Recording is a few relaxed atomic increments, safe from any thread.
+ */
+class LatencyHistogram {
+  public:
+    static constexpr unsigned subBuckets = 8;
+    static constexpr unsigned maxMagnitude = 40;  // 2^40 µs
+    static constexpr size_t bucketCount = (maxMagnitude - 1) * subBuckets;
+
+  private:
+    std::array<std::atomic<uint64_t>, bucketCount> buckets{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> totalMicros{0};
+    std::atomic<uint64_t> maxMicros{0};
+
+  public:
+    void record(std::chrono::microseconds elapsed);
+
+    [[nodiscard]] uint64_t getCount() const;
+    [[nodiscard]] uint64_t getTotalMicros() const;
+    [[nodiscard]] uint64_t getMaxMicros() const;
+
+    /**
+     * Upper bound of the bucket holding the given quantile (0.5 = median), capped at the max
+     * @return 0 when nothing was recorded
+     */
+    [[nodiscard]] uint64_t percentileMicros(double quantile) const;
+
+    static size_t bucketIndex(uint64_t micros);
+    static uint64_t bucketUpperBound(size_t index);
+};
+
+/**
+ * StatementStats - Counters of one statement fingerprint, shared by every connection
+ */
+struct StatementStats {
+    explicit StatementStats(std::string statementFingerprint)
+        : fingerprint(std::move(statementFingerprint)) {}
+
+    const std::string fingerprint;
+    std::atomic<uint64_t> errors{0};
+    std::atomic<uint64_t> rows{0};   // Returned by queries, affected by commands
+    std::atomic<uint64_t> bytes{0};  // Size of the values returned
+    LatencyHistogram latency;
+};
+
+/**
+ * Plain copy of StatementStats for reports
+ */
+struct StatementSummary {
+    std::string fingerprint;
+    uint64_t calls = 0;
+    uint64_t errors = 0;
+    uint64_t rows = 0;
+    uint64_t bytes = 0;
+    uint64_t totalMicros = 0;
+    uint64_t p50Micros = 0;
+    uint64_t p95Micros = 0;
+    uint64_t p99Micros = 0;
+    uint64_t maxMicros = 0;
+};
+
+/**
+ * Normalize SQL so statements that differ only in literals share one entry
+ *
+ * Quoted strings and numbers become ?, runs of whitespace become one space and keywords
+ * keep their case; $n placeholders and quoted identifiers are left as they are.
+ */
+std::string fingerprintStatement(const std::string& sql);
+
+/**
+ * Process-wide statement counters
+ *
+ * Entries are created on first use and live as long as the process, so the returned
+ * reference can be cached. Past maxStatements distinct fingerprints, further statements
+ * are counted together under "(other)".
+ */
+class StatementMetrics {
+  public:
+    static constexpr size_t maxStatements = 1000;
+
+    static StatementStats& forStatement(const std::string& sql);
+
+    /**
+     * Every statement seen so far, the most total time first
+     */
+    static std::vector<StatementSummary> snapshot();
+};
+
+/**
+ * StatementRecorder - Records the statements of one connection into StatementMetrics
+ *
+ * Remembers the entry of every SQL text it has seen (up to capacity), so the fingerprint
+ * is worked out once per statement, and logs the statements that took slowQueryThreshold
+ * or longer. Not thread-safe: one per connection, or per loop thread.
+ */
+class StatementRecorder {
+  private:
+    std::unordered_map<std::string, StatementStats*> entries;
+    size_t capacity;
+    std::chrono::milliseconds slowQueryThreshold;  // 0 = no slow query log
+
+  public:
+    StatementRecorder(size_t cachedStatements, std::chrono::milliseconds slowThreshold)
+        : capacity(cachedStatements), slowQueryThreshold(slowThreshold) {}
+
+    /**
+     * @param rows Returned by a query, or affected by a command
+     * @param bytes Size of the values returned
+     */
+    void record(const std::string& sql, size_t parameterCount,
+                std::chrono::microseconds elapsed, bool failed, uint64_t rows, uint64_t bytes);
+};
+
+} // namespace rdws::database
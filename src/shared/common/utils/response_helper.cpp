@@ -4,6 +4,12 @@
 
 namespace rdws::utils {
 
+namespace {
+
+constexpr auto defaultSource = "microservice C++ with PostgreSQL";
+
+} // namespace
+
 std::string ResponseHelper::returnSuccess(const std::string& message, int statusCode,
                                           const ::rapidjson::Value* data) {
     ::rapidjson::Document doc;
@@ -68,10 +74,43 @@ std::string ResponseHelper::returnData(const ::rapidjson::Value& data, const std
     return documentToString(doc);
 }
 
+std::string ResponseHelper::returnEntityList(JsonListWriter& entities,
+                                             const std::string& entitiesName,
+                                             const std::string& message, int statusCode) {
+    ::rapidjson::StringBuffer buffer;
+    ::rapidjson::Writer<::rapidjson::StringBuffer> writer(buffer);
+
+    writer.StartObject();
+    writer.Key("success");
+    writer.Bool(true);
+    writer.Key("statusCode");
+    writer.Int(statusCode);
+    if (!message.empty()) {
+        writer.Key("message");
+        writer.String(message.c_str());
+    }
+
+    // Known to be one valid array, so it is copied in as it is
+    const auto total = entities.size();
+    const auto array = entities.finish();
+    writer.Key(entitiesName.c_str());
+    writer.RawValue(array.data(), array.size(), ::rapidjson::kArrayType);
+    writer.Key("total");
+    writer.Int(static_cast<int>(total));
+
+    writer.Key("source");
+    writer.String(defaultSource);
+    writer.Key("timestamp");
+    writer.Int64(static_cast<int64_t>(std::time(nullptr)));
+    writer.EndObject();
+
+    return buffer.GetString();
+}
+
 void ResponseHelper::addMetadata(::rapidjson::Document& doc,
                                  ::rapidjson::Document::AllocatorType& allocator,
                                  const std::string& source) {
-    std::string src = source.empty() ? "microservice C++ with PostgreSQL" : source;
+    std::string src = source.empty() ? defaultSource : source;
     doc.AddMember("source", ::rapidjson::Value(src.c_str(), allocator), allocator);
     doc.AddMember("timestamp", ::rapidjson::Value(static_cast<int64_t>(std::time(nullptr))),
                   allocator);
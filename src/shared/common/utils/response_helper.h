@@ -1,12 +1,45 @@
 #pragma once
 
 #include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace rdws::utils {
 
+/**
+ * JsonListWriter - A JSON array written entity by entity as the rows arrive, so a listing
+ * holds neither the entities nor a DOM; an entity provides writeJson(Writer&)
+ */
+class JsonListWriter {
+  private:
+    ::rapidjson::StringBuffer buffer;
+    ::rapidjson::Writer<::rapidjson::StringBuffer> writer;
+    size_t count = 0;
+
+  public:
+    JsonListWriter() : writer(buffer) {
+        writer.StartArray();
+    }
+
+    template <typename T> void add(const T& entity) {
+        entity.writeJson(writer);
+        ++count;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return count;
+    }
+
+    // Close the array and return its text; nothing may be added afterwards
+    std::string_view finish() {
+        writer.EndArray();
+        return {buffer.GetString(), buffer.GetSize()};
+    }
+};
+
 class ResponseHelper {
   public:
     static std::string returnSuccess(const std::string& message = "", int statusCode = 200,
@@ -27,6 +60,12 @@ class ResponseHelper {
                                       const std::string& entitiesName,
                                       const std::string& message = "", int statusCode = 200);
 
+    /**
+     * Same document as returnEntities, with the entities already written by a JsonListWriter
+     */
+    static std::string returnEntityList(JsonListWriter& entities, const std::string& entitiesName,
+                                        const std::string& message = "", int statusCode = 200);
+
   private:
     static void addMetadata(::rapidjson::Document& doc,
                             ::rapidjson::Document::AllocatorType& allocator,
@@ -0,0 +1,123 @@
+#include "startup_profile.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+
+namespace rdws::utils {
+
+namespace {
+
+constexpr auto profileVariable = "RDWS_STARTUP_PROFILE";
+constexpr auto execStartVariable = "RDWS_EXEC_START_NS";
+
+std::chrono::nanoseconds clockNow(const clockid_t clock) {
+    timespec now{};
+    clock_gettime(clock, &now);
+    return std::chrono::seconds(now.tv_sec) + std::chrono::nanoseconds(now.tv_nsec);
+}
+
+// Process start from /proc/self/stat (field 22, clock ticks since boot)
+bool procStartTime(std::chrono::nanoseconds& sinceBoot) {
+    std::ifstream stat("/proc/self/stat");
+    std::string line;
+    if (!std::getline(stat, line)) {
+        return false;
+    }
+    // The command name may contain spaces; fields are counted after its closing parenthesis
+    const auto commandEnd = line.rfind(')');
+    if (commandEnd == std::string::npos) {
+        return false;
+    }
+    std::istringstream fields(line.substr(commandEnd + 2));
+    std::string field;
+    for (int index = 3; index <= 22 && fields >> field; ++index) {
+        if (index == 22) {
+            const long ticksPerSecond = sysconf(_SC_CLK_TCK);
+            sinceBoot = std::chrono::nanoseconds(std::stoull(field) * 1'000'000'000ULL /
+                                                 static_cast<unsigned long long>(ticksPerSecond));
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+StartupProfile::Scope::Scope(const char* phaseName)
+    : phase(phaseName), startedAt(Clock::now()), parent(nullptr) {
+    auto& profile = StartupProfile::process();
+    if (profile.enabled) {
+        parent = profile.currentScope;
+        profile.currentScope = this;
+    }
+}
+
+StartupProfile::Scope::~Scope() {
+    auto& profile = StartupProfile::process();
+    if (!profile.enabled) {
+        return;
+    }
+    const auto elapsed = Clock::now() - startedAt;
+    profile.record(phase, elapsed - nested);
+    if (parent != nullptr) {
+        parent->nested += elapsed;
+    }
+    profile.currentScope = parent;
+}
+
+StartupProfile::StartupProfile() = default;
+
+StartupProfile& StartupProfile::process() {
+    static StartupProfile profile;
+    return profile;
+}
+
+void StartupProfile::recordExecToMain() {
+    // Only the exec path opts in, so the threaded server modes never touch the profile
+    const char* value = std::getenv(profileVariable);
+    enabled = value != nullptr && *value != '\0' && std::strcmp(value, "0") != 0;
+    if (!enabled) {
+        return;
+    }
+    if (const char* spawnedAt = std::getenv(execStartVariable); spawnedAt != nullptr) {
+        const auto execStart = std::chrono::nanoseconds(std::strtoll(spawnedAt, nullptr, 10));
+        record("exec+link", clockNow(CLOCK_MONOTONIC) - execStart);
+        return;
+    }
+    if (std::chrono::nanoseconds started{}; procStartTime(started)) {
+        record("exec+link", clockNow(CLOCK_BOOTTIME) - started);
+    }
+}
+
+void StartupProfile::record(const std::string& phase, const Clock::duration elapsed) {
+    if (!enabled) {
+        return;
+    }
+    for (auto& [name, total] : phases) {
+        if (name == phase) {
+            total += elapsed;
+            return;
+        }
+    }
+    phases.emplace_back(phase, elapsed);
+}
+
+std::string StartupProfile::summary() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+    Clock::duration total{};
+    for (const auto& [name, elapsed] : phases) {
+        oss << name << "=" << std::chrono::duration<double, std::milli>(elapsed).count()
+            << "ms ";
+        total += elapsed;
+    }
+    oss << "total=" << std::chrono::duration<double, std::milli>(total).count() << "ms";
+    return oss.str();
+}
+
+} // namespace rdws::utils
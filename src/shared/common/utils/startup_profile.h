@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rdws::utils {
+
+/**
+ * StartupProfile - Where an exec-per-request process spends its time
+ *
+ * Phases are listed in the order they first finish; nested scopes are subtracted from the
+ * enclosing one, so the phases add up to the total. Process-wide and not thread-safe: only
+ * the single-threaded exec path enables it, when RDWS_STARTUP_PROFILE=1.
+ */
+class StartupProfile {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Times a phase for the lifetime of the scope (no-op when profiling is disabled)
+     */
+    class Scope {
+      private:
+        const char* phase;
+        Clock::time_point startedAt;
+        Clock::duration nested{};
+        Scope* parent;
+
+      public:
+        explicit Scope(const char* phaseName);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+  private:
+    bool enabled = false;
+    std::vector<std::pair<std::string, Clock::duration>> phases;
+    Scope* currentScope = nullptr;
+
+    StartupProfile();
+
+  public:
+    static StartupProfile& process();
+
+    [[nodiscard]] bool isEnabled() const {
+        return enabled;
+    }
+
+    /**
+     * Enable the profile from RDWS_STARTUP_PROFILE and, when enabled, record the time
+     * between exec and main(): kernel exec, dynamic linking, static initialisation
+     * Uses RDWS_EXEC_START_NS (CLOCK_MONOTONIC at exec, set by the spawner) when present,
+     * otherwise the process start time from /proc (clock tick resolution).
+     */
+    void recordExecToMain();
+
+    void record(const std::string& phase, Clock::duration elapsed);
+
+    /**
+     * One line breakdown, e.g. "exec+link=1.21ms config=0.04ms connect=3.80ms total=5.05ms"
+     */
+    [[nodiscard]] std::string summary() const;
+};
+
+} // namespace rdws::utils
@@ -53,6 +53,83 @@ class OrderController : public rdws::controllers::BaseController {
         return buffer.GetString();
     }
 
+    /**
+     * Format the orders a streaming call wrote into orders: the same JSON as
+     * formatOrdersResponse, without Order objects or a DOM in between
+     * @param result Outcome of the call; on error the orders written so far are dropped
+     * @param orders The listing the call wrote each order to
+     * @return JSON string response
+     */
+    static std::string formatOrdersListing(const rdws::types::CountResult& result,
+                                           rdws::utils::JsonListWriter& orders) {
+        if (result.isError()) {
+            return formatErrorResponse(result.getErrorMessage(), result.getStatusCode());
+        }
+
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+        const auto total = orders.size();
+        const auto array = orders.finish();
+        writer.StartObject();
+        writer.Key("success");
+        writer.Bool(true);
+        writer.Key("orders");
+        writer.RawValue(array.data(), array.size(), rapidjson::kArrayType);
+        writer.Key("total");
+        writer.Int(static_cast<int>(total));
+        writer.Key("source");
+        writer.String("orders_service C++ with clean architecture");
+        writer.Key("endpoint");
+        writer.String("/orders");
+        writer.Key("timestamp");
+        writer.Int64(static_cast<int64_t>(std::time(nullptr)));
+        writer.EndObject();
+
+        return buffer.GetString();
+    }
+
+    /**
+     * Format one page of orders; "total" counts every order, not just the page
+     * @param result ServiceResult containing the page
+     * @param limit Page size that was requested
+     * @param offset Number of orders skipped
+     * @return JSON string response
+     */
+    static std::string formatOrdersPageResponse(const rdws::types::OrderPageResult& result,
+                                                const int limit, const int offset) {
+        if (result.isError()) {
+            return formatErrorResponse(result.getErrorMessage(), result.getStatusCode());
+        }
+
+        const auto& page = result.getData();
+
+        rapidjson::Document doc;
+        doc.SetObject();
+        auto& allocator = doc.GetAllocator();
+
+        rapidjson::Value ordersArray(rapidjson::kArrayType);
+        for (const auto& order : page.orders) {
+            ordersArray.PushBack(order.toJson(allocator), allocator);
+        }
+
+        // Build response object
+        doc.AddMember("success", true, allocator);
+        doc.AddMember("orders", ordersArray, allocator);
+        doc.AddMember("total", static_cast<int64_t>(page.total), allocator);
+        doc.AddMember("limit", limit, allocator);
+        doc.AddMember("offset", offset, allocator);
+        doc.AddMember("source", "orders_service C++ with clean architecture", allocator);
+        doc.AddMember("endpoint", "/orders", allocator);
+        doc.AddMember("timestamp", static_cast<int64_t>(std::time(nullptr)), allocator);
+
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        doc.Accept(writer);
+
+        return buffer.GetString();
+    }
+
     /**
      * Format a successful single order response
      * @param result ServiceResult containing a single order
@@ -27,6 +27,21 @@ class UserController : public rdws::controllers::BaseController {
         }
     }
 
+    /**
+     * Users listing from the rows a streaming call wrote into users: the same JSON as
+     * formatUsersResponse, without User objects or a DOM in between
+     * @param result Outcome of the call; on error the rows written so far are dropped
+     */
+    static std::string formatUsersListing(const rdws::types::CountResult& result,
+                                          rdws::utils::JsonListWriter& users) {
+        if (result.isSuccess()) {
+            return rdws::utils::ResponseHelper::returnEntityList(users, "users");
+        } else {
+            return rdws::utils::ResponseHelper::returnError(result.getErrorMessage(),
+                                                            result.getStatusCode());
+        }
+    }
+
     /**
      * Convert UserResult to JSON response
      */
@@ -1,56 +1,96 @@
 #include "order_repository.h"
 
 #include <sstream>
+#include <string>
 
 namespace rdws::services::orders {
 
+namespace {
+
+// Column list generated from the orders RowDescriptor, so the SQL matches the mapping
+const std::string& orderColumns = OrderRepository::OrderMapper::columnList();
+const std::string selectOrders = "SELECT " + orderColumns + " FROM orders";
+
+// Fixed statements of the repository, prepared ahead by prepareStatements()
+constexpr auto insertBatchQuery =
+    "INSERT INTO orders (user_id, product, amount, status) VALUES ($1, $2, $3, $4)";
+constexpr auto countByUserIdQuery = "SELECT COUNT(*) as total FROM orders WHERE user_id = $1";
+constexpr auto updateStatusQuery = "UPDATE orders SET status = $1 WHERE id = $2";
+constexpr auto pingQuery = "SELECT 1";
+
+} // namespace
+
+// Streamed through a cursor rather than prepared
+const std::string OrderRepository::findAllQuery = selectOrders + " ORDER BY created_at DESC";
+const std::string OrderRepository::findByIdQuery = selectOrders + " WHERE id = $1";
+const std::string OrderRepository::findByUserIdQuery =
+    selectOrders + " WHERE user_id = $1 ORDER BY created_at DESC";
+const std::string OrderRepository::findPageQuery =
+    selectOrders + " ORDER BY created_at DESC LIMIT $1 OFFSET $2";
+const std::string OrderRepository::insertQuery =
+    "INSERT INTO orders (user_id, product, amount, status) VALUES ($1, $2, $3, $4) RETURNING " +
+    orderColumns;
+const std::string OrderRepository::updateQuery =
+    "UPDATE orders SET user_id = $1, product = $2, amount = $3, status = $4 WHERE id = $5 "
+    "RETURNING " +
+    orderColumns;
+
 OrderRepository::OrderRepository(std::shared_ptr<rdws::database::IDatabase> db)
     : db_(std::move(db)) {}
 
-types::Order OrderRepository::resultToOrder(rdws::database::IResultSet& result) {
-    types::Order order;
-    order.id = result.getInt("id");
-    order.userId = result.getInt("user_id");
-    order.product = result.getString("product");
-    order.amount = result.getDouble("amount");
-    order.status = result.getString("status");
-    order.createdAt = result.getString("created_at");
-    return order;
-}
-
 std::vector<types::Order> OrderRepository::findAll() const {
     std::vector<types::Order> orders;
 
     if (!db_)
         return orders;
 
-    const std::string query = "SELECT id, user_id, product, amount, status, created_at FROM orders "
-                              "ORDER BY created_at DESC";
-    const auto result = db_->execQuery(query);
+    // Read whole in one round trip: the cursor of findAllWithCallback would not save memory
+    const auto result = db_->execQuery(findAllQuery);
 
     if (!result)
         return orders;
 
+    OrderMapper mapper;
     while (result->next()) {
-        orders.push_back(resultToOrder(*result));
+        orders.push_back(mapper.read(*result));
     }
 
     return orders;
 }
 
+void OrderRepository::findAllWithCallback(
+    const std::function<void(const types::Order&)>& callback) const {
+    if (!db_)
+        return;
+
+    OrderMapper mapper;
+    db_->streamQuery(findAllQuery, {}, [&callback, &mapper](rdws::database::IResultSet& row) {
+        callback(mapper.read(row));
+    });
+}
+
+void OrderRepository::findAllViews(
+    const std::function<void(const types::OrderView&)>& callback) const {
+    if (!db_)
+        return;
+
+    rdws::database::RowMapper<types::OrderView> mapper;
+    db_->streamQuery(findAllQuery, {}, [&callback, &mapper](rdws::database::IResultSet& row) {
+        callback(mapper.read(row));
+    });
+}
+
 std::optional<types::Order> OrderRepository::findById(const int orderId) const {
     if (!db_)
         return std::nullopt;
 
-    const std::string query =
-        "SELECT id, user_id, product, amount, status, created_at FROM orders WHERE id = $1";
-    const auto result = db_->execQuery(query, {std::to_string(orderId)});
+    const auto result = db_->execQuery(findByIdQuery, {std::to_string(orderId)});
 
     if (!result || !result->next()) {
         return std::nullopt;
     }
 
-    return resultToOrder(*result);
+    return OrderMapper().read(*result);
 }
 
 std::vector<types::Order> OrderRepository::findByUserId(const int userId) const {
@@ -59,73 +99,106 @@ std::vector<types::Order> OrderRepository::findByUserId(const int userId) const
     if (!db_)
         return orders;
 
-    const std::string query = "SELECT id, user_id, product, amount, status, created_at FROM orders "
-                              "WHERE user_id = $1 ORDER BY created_at DESC";
-    const auto result = db_->execQuery(query, {std::to_string(userId)});
+    const auto result = db_->execQuery(findByUserIdQuery, {std::to_string(userId)});
 
     if (!result)
         return {};
 
+    OrderMapper mapper;
     while (result->next()) {
-        orders.push_back(resultToOrder(*result));
+        orders.push_back(mapper.read(*result));
     }
 
     return orders;
 }
 
+types::OrderPage OrderRepository::findPage(const int limit, const int offset) const {
+    types::OrderPage page;
+
+    if (!db_)
+        return page;
+
+    auto total = db_->execQueryAsync(countQuery);
+    auto rows = db_->execQueryAsync(findPageQuery, {std::to_string(limit), std::to_string(offset)});
+
+    if (const auto result = rows.get()) {
+        OrderMapper mapper;
+        while (result->next()) {
+            page.orders.push_back(mapper.read(*result));
+        }
+    }
+    if (const auto result = total.get(); result && result->next()) {
+        page.total = static_cast<size_t>(result->getInt("total"));
+    }
+
+    return page;
+}
+
 std::optional<types::Order> OrderRepository::create(const types::Order& order) const {
     if (!db_)
         return std::nullopt;
 
-    const auto query = "INSERT INTO orders (user_id, product, amount, status) "
-                       "VALUES ($1, $2, $3, $4) "
-                       "RETURNING id, user_id, product, amount, status, created_at";
     const auto params = {std::to_string(order.userId), order.product, std::to_string(order.amount),
                          order.status};
 
-    const auto result = db_->execQuery(query, params);
+    const auto result = db_->execQuery(insertQuery, params);
 
     if (!result || !result->next()) {
         return std::nullopt;
     }
 
-    return resultToOrder(*result);
+    return OrderMapper().read(*result);
+}
+
+bool OrderRepository::createBatch(const std::vector<types::Order>& orders) const {
+    if (!db_)
+        return false;
+    if (orders.empty())
+        return true;
+
+    std::vector<std::vector<std::string>> parameterSets;
+    parameterSets.reserve(orders.size());
+    for (const auto& order : orders) {
+        parameterSets.push_back({std::to_string(order.userId), order.product,
+                                 std::to_string(order.amount), order.status});
+    }
+
+    if (orders.size() >= rdws::database::IDatabase::copyInThreshold) {
+        return db_->copyIn("orders", {"user_id", "product", "amount", "status"}, parameterSets);
+    }
+
+    const std::vector<std::string> queries(orders.size(), insertBatchQuery);
+    return db_->execBatch(queries, parameterSets);
 }
 
 std::optional<types::Order> OrderRepository::update(const types::Order& order) const {
     if (!db_)
         return std::nullopt;
 
-    const auto query = "UPDATE orders SET user_id = $1, product = $2, amount = $3, status = $4 "
-                       "WHERE id = $5 "
-                       "RETURNING id, user_id, product, amount, status, created_at";
-
     const auto params = {std::to_string(order.userId), order.product, std::to_string(order.amount),
                          order.status, std::to_string(order.id)};
 
-    const auto result = db_->execQuery(query, params);
+    const auto result = db_->execQuery(updateQuery, params);
 
     if (!result || !result->next()) {
         return std::nullopt;
     }
 
-    return resultToOrder(*result);
+    return OrderMapper().read(*result);
 }
 
 bool OrderRepository::deleteById(const int orderId) const {
     if (!db_)
         return false;
 
-    const auto query = "DELETE FROM orders WHERE id = $1";
-    return db_->execCommand(query, {std::to_string(orderId)});
+    return db_->execCommand(deleteQuery, {std::to_string(orderId)});
 }
 
 int OrderRepository::count() const {
     if (!db_)
         return 0;
 
-    const auto query = "SELECT COUNT(*) as total FROM orders";
-    const auto result = db_->execQuery(query);
+    const auto result = db_->execQuery(countQuery);
 
     if (!result || !result->next()) {
         return 0;
@@ -138,8 +211,7 @@ int OrderRepository::countByUserId(const int userId) const {
     if (!db_)
         return 0;
 
-    const auto query = "SELECT COUNT(*) as total FROM orders WHERE user_id = $1";
-    const auto result = db_->execQuery(query, {std::to_string(userId)});
+    const auto result = db_->execQuery(countByUserIdQuery, {std::to_string(userId)});
 
     if (!result || !result->next()) {
         return 0;
@@ -152,8 +224,23 @@ bool OrderRepository::updateStatus(int orderId, const std::string& newStatus) co
     if (!db_)
         return false;
 
-    const auto query = "UPDATE orders SET status = $1 WHERE id = $2";
-    return db_->execCommand(query, {newStatus, std::to_string(orderId)});
+    return db_->execCommand(updateStatusQuery, {newStatus, std::to_string(orderId)});
+}
+
+void OrderRepository::prepareStatements() const {
+    if (!db_)
+        return;
+
+    db_->prepareStatements({findByIdQuery, findByUserIdQuery, findPageQuery, insertQuery,
+                            insertBatchQuery, updateQuery, deleteQuery, countQuery,
+                            countByUserIdQuery, updateStatusQuery});
+}
+
+void OrderRepository::ping() const {
+    if (!db_)
+        return;
+
+    [[maybe_unused]] const auto result = db_->execQuery(pingQuery);
 }
 
 } // namespace rdws::services::orders
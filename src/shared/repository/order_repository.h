@@ -1,12 +1,41 @@
 #pragma once
 
 #include "common/database/idatabase.h"
+#include "common/database/row_mapper.h"
 #include "types/order.h"
 
+#include <functional>
 #include <memory>
 #include <optional>
+#include <string>
+#include <tuple>
 #include <vector>
 
+namespace rdws::database {
+
+// Columns of orders; shared by the repository and the async service
+template <> struct RowDescriptor<rdws::types::Order> {
+    static constexpr auto fields =
+        std::make_tuple(column<WireType::Integer>("id", &rdws::types::Order::id),
+                        column<WireType::Integer>("user_id", &rdws::types::Order::userId),
+                        column<WireType::Text>("product", &rdws::types::Order::product),
+                        column<WireType::Float>("amount", &rdws::types::Order::amount),
+                        column<WireType::Text>("status", &rdws::types::Order::status),
+                        column<WireType::Text>("created_at", &rdws::types::Order::createdAt));
+};
+
+template <> struct RowDescriptor<rdws::types::OrderView> {
+    static constexpr auto fields = std::make_tuple(
+        column<WireType::Integer>("id", &rdws::types::OrderView::id),
+        column<WireType::Integer>("user_id", &rdws::types::OrderView::userId),
+        column<WireType::Text>("product", &rdws::types::OrderView::product),
+        column<WireType::Float>("amount", &rdws::types::OrderView::amount),
+        column<WireType::Text>("status", &rdws::types::OrderView::status),
+        column<WireType::Text>("created_at", &rdws::types::OrderView::createdAt));
+};
+
+} // namespace rdws::database
+
 namespace rdws::services::orders {
 
 /**
@@ -17,14 +46,24 @@ class OrderRepository {
   private:
     std::shared_ptr<rdws::database::IDatabase> db_;
 
+  public:
     /**
-     * Convert database result row to Order object
-     * @param result Database result containing order data
-     * @return Order object created from database row
+     * Builds orders from result rows (also used by the async service); one per result
      */
-    static types::Order resultToOrder(rdws::database::IResultSet& result);
+    using OrderMapper = rdws::database::RowMapper<types::Order>;
+
+    /**
+     * Statements the async service sends as well, so both paths run the same SQL
+     */
+    static const std::string findAllQuery;
+    static const std::string findByIdQuery;
+    static const std::string findByUserIdQuery;
+    static const std::string findPageQuery;
+    static const std::string insertQuery;
+    static const std::string updateQuery;
+    static constexpr auto deleteQuery = "DELETE FROM orders WHERE id = $1";
+    static constexpr auto countQuery = "SELECT COUNT(*) as total FROM orders";
 
-  public:
     /**
      * Constructor with database dependency injection
      * @param db Database interface for order operations
@@ -37,6 +76,18 @@ class OrderRepository {
      */
     [[nodiscard]] std::vector<types::Order> findAll() const;
 
+    /**
+     * Hand every order to callback as its row arrives, streaming the table in chunks
+     * @param callback Called once per order, in the same order as findAll()
+     */
+    void findAllWithCallback(const std::function<void(const types::Order&)>& callback) const;
+
+    /**
+     * Same as findAllWithCallback, with each order as views into the streamed result
+     * @param callback Called once per order; the view is only valid during the call
+     */
+    void findAllViews(const std::function<void(const types::OrderView&)>& callback) const;
+
     /**
      * Find order by ID
      * @param orderId ID of the order to find
@@ -51,6 +102,14 @@ class OrderRepository {
      */
     [[nodiscard]] std::vector<types::Order> findByUserId(int userId) const;
 
+    /**
+     * Find one page of all orders, newest first, together with the total count; both
+     * queries share one round trip
+     * @param limit Maximum number of orders in the page
+     * @param offset Number of orders to skip
+     */
+    [[nodiscard]] types::OrderPage findPage(int limit, int offset) const;
+
     /**
      * Create a new order
      * @param order Order object to create (ID will be auto-generated)
@@ -58,6 +117,14 @@ class OrderRepository {
      */
     [[nodiscard]] std::optional<types::Order> create(const types::Order& order) const;
 
+    /**
+     * Create many orders at once, all or nothing
+     * Large batches are loaded with COPY (IDatabase::copyIn), smaller ones as pipelined INSERTs.
+     * @param orders Orders to create (IDs and creation times are assigned by the database)
+     * @return True if every order was created, false otherwise
+     */
+    [[nodiscard]] bool createBatch(const std::vector<types::Order>& orders) const;
+
     /**
      * Update an existing order
      * @param order Order object with updated information
@@ -92,6 +159,16 @@ class OrderRepository {
      * @return True if update was successful, false otherwise
      */
     [[nodiscard]] bool updateStatus(int orderId, const std::string& newStatus) const;
+
+    /**
+     * Prepare the repository's fixed statements on the connection before the first request
+     */
+    void prepareStatements() const;
+
+    /**
+     * Run one trivial query, so the first request does not pay for connection setup
+     */
+    void ping() const;
 };
 
 } // namespace rdws::services::orders
@@ -1,9 +1,39 @@
 #include "user_repository.h"
 
+#include "common/database/array_literal.h"
+
 #include <stdexcept>
+#include <string>
+#include <unordered_map>
 
 namespace rdws::repository {
 
+namespace {
+
+// Column list generated from the users RowDescriptor, so the SQL matches the mapping
+const std::string selectUsers =
+    "SELECT " + UserRepository::UserMapper::columnList() + " FROM users";
+
+// Fixed statements of the repository, prepared ahead by prepareStatements()
+const std::string findByEmailQuery = selectUsers + " WHERE email = $1";
+constexpr auto insertQuery = "INSERT INTO users (name, email) VALUES ($1, $2) RETURNING id";
+// Set-based batches: the rows arrive as array parameters, one statement per batch
+constexpr auto updateBatchQuery =
+    "UPDATE users SET name = batch.name, email = batch.email "
+    "FROM unnest($1::int[], $2::text[], $3::text[]) AS batch(id, name, email) "
+    "WHERE users.id = batch.id";
+constexpr auto deleteBatchQuery = "DELETE FROM users WHERE id = ANY($1::int[])";
+constexpr auto existsByEmailQuery = "SELECT 1 FROM users WHERE email = $1 LIMIT 1";
+constexpr auto pingQuery = "SELECT 1";
+
+} // namespace
+
+const std::string UserRepository::findByIdQuery = selectUsers + " WHERE id = $1";
+// Streamed through a cursor rather than prepared
+const std::string UserRepository::findAllQuery = selectUsers + " ORDER BY id";
+const std::string UserRepository::createReturningQuery =
+    "INSERT INTO users (name, email) VALUES ($1, $2) RETURNING " + UserMapper::columnList();
+
 UserRepository::UserRepository(std::shared_ptr<rdws::database::IDatabase> database)
     : db(std::move(database)) {
     if (!db) {
@@ -13,11 +43,9 @@ UserRepository::UserRepository(std::shared_ptr<rdws::database::IDatabase> databa
 
 std::optional<rdws::types::User> UserRepository::findById(const int id) const {
     try {
-        const auto query = "SELECT id, name, email, created_at FROM users WHERE id = $1";
-
-        if (const auto result = db->execQuery(query, {std::to_string(id)});
+        if (const auto result = db->execQuery(findByIdQuery, {std::to_string(id)});
             result && result->next()) {
-            return mapResultToUser(*result);
+            return UserMapper().read(*result);
         }
 
         return std::nullopt;
@@ -29,11 +57,12 @@ std::optional<rdws::types::User> UserRepository::findById(const int id) const {
 std::vector<rdws::types::User> UserRepository::findAll() const {
     try {
         std::vector<rdws::types::User> users;
-        const auto query = "SELECT id, name, email, created_at FROM users ORDER BY id";
 
-        if (const auto result = db->execQuery(query)) {
+        // Read whole in one round trip: the vector holds every row anyway
+        if (const auto result = db->execQuery(findAllQuery)) {
+            UserMapper mapper;
             while (result->next()) {
-                users.push_back(mapResultToUser(*result));
+                users.push_back(mapper.read(*result));
             }
         }
 
@@ -46,11 +75,11 @@ std::vector<rdws::types::User> UserRepository::findAll() const {
 std::vector<rdws::types::User> UserRepository::findByEmail(const std::string& email) const {
     try {
         std::vector<rdws::types::User> users;
-        const auto query = "SELECT id, name, email, created_at FROM users WHERE email = $1";
 
-        if (const auto result = db->execQuery(query, {email})) {
+        if (const auto result = db->execQuery(findByEmailQuery, {email})) {
+            UserMapper mapper;
             while (result->next()) {
-                users.push_back(mapResultToUser(*result));
+                users.push_back(mapper.read(*result));
             }
         }
 
@@ -62,8 +91,7 @@ std::vector<rdws::types::User> UserRepository::findByEmail(const std::string& em
 
 bool UserRepository::create(const rdws::types::User& user) const {
     try {
-        const auto query = "INSERT INTO users (name, email) VALUES ($1, $2) RETURNING id";
-        return db->execCommand(query, {user.name, user.email});
+        return db->execCommand(insertQuery, {user.name, user.email});
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to create user: " + std::string(e.what()));
     }
@@ -71,8 +99,7 @@ bool UserRepository::create(const rdws::types::User& user) const {
 
 bool UserRepository::update(const rdws::types::User& user) const {
     try {
-        const auto query = "UPDATE users SET name = $1, email = $2 WHERE id = $3";
-        return db->execCommand(query, {user.name, user.email, std::to_string(user.id)});
+        return db->execCommand(updateQuery, {user.name, user.email, std::to_string(user.id)});
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to update user: " + std::string(e.what()));
     }
@@ -80,7 +107,7 @@ bool UserRepository::update(const rdws::types::User& user) const {
 
 bool UserRepository::deleteById(const int id) const {
     try {
-        return db->execCommand("DELETE FROM users WHERE id = $1", {std::to_string(id)});
+        return db->execCommand(deleteQuery, {std::to_string(id)});
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to delete user: " + std::string(e.what()));
     }
@@ -96,10 +123,15 @@ bool UserRepository::createBatch(const std::vector<rdws::types::User>& users) co
         std::vector<std::vector<std::string>> parameterSets;
 
         for (const auto& [id, name, email, created_at] : users) {
-            queries.emplace_back("INSERT INTO users (name, email) VALUES ($1, $2) RETURNING id");
             parameterSets.push_back({name, email});
         }
 
+        // Nightly imports: COPY streams the rows instead of running an INSERT per row
+        if (users.size() >= rdws::database::IDatabase::copyInThreshold) {
+            return db->copyIn("users", {"name", "email"}, parameterSets);
+        }
+
+        queries.assign(users.size(), insertQuery);
         return db->execBatch(queries, parameterSets);
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to create users in batch: " + std::string(e.what()));
@@ -112,15 +144,31 @@ bool UserRepository::updateBatch(const std::vector<rdws::types::User>& users) co
     }
 
     try {
-        std::vector<std::string> queries;
-        std::vector<std::vector<std::string>> parameterSets;
-
+        std::vector<int> ids;
+        std::vector<std::string> names;
+        std::vector<std::string> emails;
+        ids.reserve(users.size());
+        names.reserve(users.size());
+        emails.reserve(users.size());
+
+        // UPDATE ... FROM applies an arbitrary one of several rows joined to the same user,
+        // so a repeated id keeps only its last entry, as separate updates would leave it
+        std::unordered_map<int, size_t> positions;
         for (const auto& [id, name, email, created_at] : users) {
-            queries.emplace_back("UPDATE users SET name = $1, email = $2 WHERE id = $3");
-            parameterSets.push_back({name, email, std::to_string(id)});
+            if (const auto [position, added] = positions.try_emplace(id, ids.size()); !added) {
+                names[position->second] = name;
+                emails[position->second] = email;
+                continue;
+            }
+            ids.push_back(id);
+            names.push_back(name);
+            emails.push_back(email);
         }
 
-        return db->execBatch(queries, parameterSets);
+        return db->execCommand(updateBatchQuery,
+                               {rdws::database::toArrayLiteral(ids),
+                                rdws::database::toArrayLiteral(names),
+                                rdws::database::toArrayLiteral(emails)});
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to update users in batch: " + std::string(e.what()));
     }
@@ -132,15 +180,7 @@ bool UserRepository::deleteBatch(const std::vector<int>& ids) const {
     }
 
     try {
-        std::vector<std::string> queries;
-        std::vector<std::vector<std::string>> parameterSets;
-
-        for (const int id : ids) {
-            queries.emplace_back("DELETE FROM users WHERE id = $1");
-            parameterSets.push_back({std::to_string(id)});
-        }
-
-        return db->execBatch(queries, parameterSets);
+        return db->execCommand(deleteBatchQuery, {rdws::database::toArrayLiteral(ids)});
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to delete users in batch: " + std::string(e.what()));
     }
@@ -149,31 +189,37 @@ bool UserRepository::deleteBatch(const std::vector<int>& ids) const {
 void UserRepository::findAllWithCallback(
     const std::function<void(const rdws::types::User&)>& callback) const {
     try {
-        const auto query = "SELECT id, name, email, created_at FROM users ORDER BY id";
-        if (const auto result = db->execQuery(query)) {
-            while (result->next()) {
-                auto user = mapResultToUser(*result);
-                callback(user);
-            }
-        }
+        UserMapper mapper;
+        db->streamQuery(findAllQuery, {}, [&callback, &mapper](rdws::database::IResultSet& row) {
+            callback(mapper.read(row));
+        });
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to process users with callback: " + std::string(e.what()));
     }
 }
 
+void UserRepository::findAllViews(
+    const std::function<void(const rdws::types::UserView&)>& callback) const {
+    try {
+        rdws::database::RowMapper<rdws::types::UserView> mapper;
+        db->streamQuery(findAllQuery, {}, [&callback, &mapper](rdws::database::IResultSet& row) {
+            callback(mapper.read(row));
+        });
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Failed to stream users: " + std::string(e.what()));
+    }
+}
+
 void UserRepository::findByConditionWithCallback(
     const std::string& whereClause, const std::vector<std::string>& parameters,
     const std::function<void(const rdws::types::User&)>& callback) const {
     try {
-        const auto query =
-            "SELECT id, name, email, created_at FROM users WHERE " + whereClause + " ORDER BY id";
+        const auto query = selectUsers + " WHERE " + whereClause + " ORDER BY id";
 
-        if (const auto result = db->execQuery(query, parameters)) {
-            while (result->next()) {
-                auto user = mapResultToUser(*result);
-                callback(user);
-            }
-        }
+        UserMapper mapper;
+        db->streamQuery(query, parameters, [&callback, &mapper](rdws::database::IResultSet& row) {
+            callback(mapper.read(row));
+        });
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to process users with condition callback: " +
                                  std::string(e.what()));
@@ -182,8 +228,7 @@ void UserRepository::findByConditionWithCallback(
 
 size_t UserRepository::count() const {
     try {
-        const auto query = "SELECT COUNT(*) as total FROM users";
-        if (const auto result = db->execQuery(query); result && result->next()) {
+        if (const auto result = db->execQuery(countQuery); result && result->next()) {
             return static_cast<size_t>(result->getInt("total"));
         }
 
@@ -195,8 +240,7 @@ size_t UserRepository::count() const {
 
 bool UserRepository::exists(const int id) const {
     try {
-        const auto query = "SELECT 1 FROM users WHERE id = $1 LIMIT 1";
-        const auto result = db->execQuery(query, {std::to_string(id)});
+        const auto result = db->execQuery(existsQuery, {std::to_string(id)});
         return result && result->next();
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to check user existence: " + std::string(e.what()));
@@ -205,8 +249,7 @@ bool UserRepository::exists(const int id) const {
 
 bool UserRepository::existsByEmail(const std::string& email) const {
     try {
-        const auto query = "SELECT 1 FROM users WHERE email = $1 LIMIT 1";
-        const auto result = db->execQuery(query, {email});
+        const auto result = db->execQuery(existsByEmailQuery, {email});
         return result && result->next();
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to check user existence by email: " +
@@ -214,14 +257,14 @@ bool UserRepository::existsByEmail(const std::string& email) const {
     }
 }
 
-// Private helper methods
+void UserRepository::prepareStatements() const {
+    db->prepareStatements({findByIdQuery, findByEmailQuery, insertQuery, updateQuery, deleteQuery,
+                           updateBatchQuery, deleteBatchQuery, countQuery, existsQuery,
+                           existsByEmailQuery});
+}
 
-rdws::types::User UserRepository::mapResultToUser(rdws::database::IResultSet& result) {
-    rdws::types::User user;
-    user.id = result.getInt("id");
-    user.name = result.getString("name");
-    user.email = result.getString("email");
-    user.created_at = result.getString("created_at");
-    return user;
+void UserRepository::ping() const {
+    [[maybe_unused]] const auto result = db->execQuery(pingQuery);
 }
+
 } // namespace rdws::repository
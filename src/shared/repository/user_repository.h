@@ -1,12 +1,36 @@
 #pragma once
 
 #include "../common/database/idatabase.h"
+#include "../common/database/row_mapper.h"
 #include "../types/user.h"
 
 #include <functional>
 #include <optional>
+#include <string>
+#include <tuple>
 #include <vector>
 
+namespace rdws::database {
+
+// Columns of users; shared by the repository and the async service
+template <> struct RowDescriptor<rdws::types::User> {
+    static constexpr auto fields =
+        std::make_tuple(column<WireType::Integer>("id", &rdws::types::User::id),
+                        column<WireType::Text>("name", &rdws::types::User::name),
+                        column<WireType::Text>("email", &rdws::types::User::email),
+                        column<WireType::Text>("created_at", &rdws::types::User::created_at));
+};
+
+template <> struct RowDescriptor<rdws::types::UserView> {
+    static constexpr auto fields = std::make_tuple(
+        column<WireType::Integer>("id", &rdws::types::UserView::id),
+        column<WireType::Text>("name", &rdws::types::UserView::name),
+        column<WireType::Text>("email", &rdws::types::UserView::email),
+        column<WireType::Text>("created_at", &rdws::types::UserView::created_at));
+};
+
+} // namespace rdws::database
+
 namespace rdws::repository {
 
 class UserRepository {
@@ -24,13 +48,16 @@ class UserRepository {
     [[nodiscard]] bool update(const rdws::types::User& user) const;
     [[nodiscard]] bool deleteById(int id) const;
 
-    // Batch operations
+    // Batch operations: large creates use COPY, updates and deletes run as one statement.
+    // updateBatch applies the last entry of a user listed more than once.
     [[nodiscard]] bool createBatch(const std::vector<rdws::types::User>& users) const;
     [[nodiscard]] bool updateBatch(const std::vector<rdws::types::User>& users) const;
     [[nodiscard]] bool deleteBatch(const std::vector<int>& ids) const;
 
-    // Query with callback for large datasets
+    // Query with callback for large datasets: rows are streamed in chunks, not loaded at once
     void findAllWithCallback(const std::function<void(const rdws::types::User&)>& callback) const;
+    // The same rows as views into the streamed result, valid only during the callback
+    void findAllViews(const std::function<void(const rdws::types::UserView&)>& callback) const;
     void findByConditionWithCallback(
         const std::string& whereClause, const std::vector<std::string>& parameters,
         const std::function<void(const rdws::types::User&)>& callback) const;
@@ -40,9 +67,23 @@ class UserRepository {
     [[nodiscard]] bool exists(int id) const;
     [[nodiscard]] bool existsByEmail(const std::string& email) const;
 
-  private:
-    // Helper methods
-    static rdws::types::User mapResultToUser(rdws::database::IResultSet& result);
+    // Prepare the fixed statements above on the connection before the first request
+    void prepareStatements() const;
+
+    // One trivial round trip, so the first request does not pay for connection setup
+    void ping() const;
+
+    // Row mapping, shared with the async service; one mapper per result
+    using UserMapper = rdws::database::RowMapper<rdws::types::User>;
+
+    // Statements the async service sends as well, so both paths run the same SQL
+    static const std::string findByIdQuery;
+    static const std::string findAllQuery;
+    static const std::string createReturningQuery;  // Hands back the whole stored row
+    static constexpr auto updateQuery = "UPDATE users SET name = $1, email = $2 WHERE id = $3";
+    static constexpr auto deleteQuery = "DELETE FROM users WHERE id = $1";
+    static constexpr auto countQuery = "SELECT COUNT(*) as total FROM users";
+    static constexpr auto existsQuery = "SELECT 1 FROM users WHERE id = $1 LIMIT 1";
 };
 
 } // namespace rdws::repository
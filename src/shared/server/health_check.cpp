@@ -0,0 +1,67 @@
+#include "health_check.h"
+
+#include "../common/database/connection_breaker.h"
+#include "../common/utils/response_helper.h"
+
+#include <utility>
+
+namespace rdws::server {
+
+namespace {
+
+constexpr auto healthPath = "/health";
+
+} // namespace
+
+HandlerResponse healthResponse() {
+    using rdws::database::ConnectionBreaker;
+
+    rapidjson::Document doc;
+    doc.SetObject();
+    auto& allocator = doc.GetAllocator();
+
+    bool available = true;
+    rapidjson::Value databases(rapidjson::kArrayType);
+    for (const auto& status : ConnectionBreaker::processStatus()) {
+        available = available && status.state == ConnectionBreaker::State::Closed;
+
+        rapidjson::Value entry(rapidjson::kObjectType);
+        entry.AddMember("target", rapidjson::Value(status.target.c_str(), allocator), allocator);
+        entry.AddMember("circuit",
+                        rapidjson::Value(ConnectionBreaker::stateName(status.state), allocator),
+                        allocator);
+        entry.AddMember("consecutiveFailures", rapidjson::Value(status.consecutiveFailures),
+                        allocator);
+        entry.AddMember("rejected", rapidjson::Value(status.rejected), allocator);
+        entry.AddMember("retryInMs", rapidjson::Value(static_cast<int64_t>(status.retryIn.count())),
+                        allocator);
+        entry.AddMember("lastError", rapidjson::Value(status.lastError.c_str(), allocator),
+                        allocator);
+        databases.PushBack(entry, allocator);
+    }
+    doc.AddMember("status", rapidjson::Value(available ? "ok" : "unavailable", allocator),
+                  allocator);
+    doc.AddMember("databases", databases, allocator);
+
+    // 503 takes the instance out of a load balancer's rotation until the database is back
+    const int statusCode = available ? 200 : 503;
+    return {rdws::utils::ResponseHelper::returnData(doc, "Health", statusCode), 0, statusCode};
+}
+
+bool isHealthCheck(const rdws::types::LambdaEvent& event) {
+    return event.isGet() && event.getPath() == healthPath;
+}
+
+void HealthCheckExecutor::submit(RequestJob job) {
+    if (isHealthCheck(job.event)) {
+        job.complete(healthResponse());
+        return;
+    }
+    executor->submit(std::move(job));
+}
+
+void HealthCheckExecutor::shutdown() {
+    executor->shutdown();
+}
+
+} // namespace rdws::server
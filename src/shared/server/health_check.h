@@ -0,0 +1,38 @@
+#pragma once
+
+#include "request_executor.h"
+
+#include <memory>
+
+namespace rdws::server {
+
+/**
+ * GET /health body: the database circuit breakers of the process, 200 while all of them
+ * are closed and 503 otherwise
+ */
+HandlerResponse healthResponse();
+
+/**
+ * True for GET /health
+ */
+bool isHealthCheck(const rdws::types::LambdaEvent& event);
+
+/**
+ * HealthCheckExecutor - Answers GET /health itself and passes every other request on
+ *
+ * The check reads process state only, so it runs on the calling thread: it stays fast while
+ * workers or database connections are busy, whichever executor it wraps.
+ */
+class HealthCheckExecutor : public RequestExecutor {
+  private:
+    std::unique_ptr<RequestExecutor> executor;
+
+  public:
+    explicit HealthCheckExecutor(std::unique_ptr<RequestExecutor> requestExecutor)
+        : executor(std::move(requestExecutor)) {}
+
+    void submit(RequestJob job) override;
+    void shutdown() override;
+};
+
+} // namespace rdws::server
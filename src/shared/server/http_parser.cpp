@@ -0,0 +1,203 @@
+#include "http_parser.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+
+namespace rdws::server {
+
+namespace {
+
+constexpr std::string_view crlf = "\r\n";
+constexpr std::string_view headerTerminator = "\r\n\r\n";
+
+std::string_view trim(std::string_view value) {
+    while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+std::string toLower(std::string_view value) {
+    std::string lower(value);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return lower;
+}
+
+bool containsToken(const std::string& headerValue, const std::string_view token) {
+    return toLower(headerValue).find(token) != std::string::npos;
+}
+
+HttpParseResult parseError(const int status, std::string message) {
+    HttpParseResult result;
+    result.status = HttpParseStatus::Error;
+    result.errorStatus = status;
+    result.error = std::move(message);
+    return result;
+}
+
+} // namespace
+
+std::string HttpRequest::getHeader(const std::string& lowerCaseName) const {
+    for (const auto& [name, value] : headers) {
+        if (name == lowerCaseName) {
+            return value;
+        }
+    }
+    return "";
+}
+
+HttpParseResult HttpParser::parse(const std::string_view buffer, HttpRequest& request) {
+    const size_t headerEnd = buffer.find(headerTerminator);
+    if (headerEnd == std::string_view::npos) {
+        if (buffer.size() > maxHeaderBytes) {
+            return parseError(431, "Request header fields too large");
+        }
+        return {};
+    }
+    if (headerEnd > maxHeaderBytes) {
+        return parseError(431, "Request header fields too large");
+    }
+
+    const std::string_view head = buffer.substr(0, headerEnd);
+
+    // Request line: METHOD SP request-target SP HTTP-version
+    const size_t lineEnd = std::min(head.find(crlf), head.size());
+    const std::string_view requestLine = head.substr(0, lineEnd);
+    const size_t firstSpace = requestLine.find(' ');
+    const size_t lastSpace = requestLine.rfind(' ');
+    if (firstSpace == std::string_view::npos || firstSpace == lastSpace) {
+        return parseError(400, "Malformed request line");
+    }
+
+    HttpRequest parsed;
+    parsed.method = std::string(requestLine.substr(0, firstSpace));
+    parsed.target = std::string(requestLine.substr(firstSpace + 1, lastSpace - firstSpace - 1));
+    parsed.version = std::string(requestLine.substr(lastSpace + 1));
+    if (parsed.method.empty() || parsed.target.empty() || parsed.version.rfind("HTTP/1.", 0) != 0) {
+        return parseError(400, "Malformed request line");
+    }
+
+    // Header fields
+    size_t position = lineEnd + crlf.size();
+    while (position < head.size()) {
+        const size_t next = std::min(head.find(crlf, position), head.size());
+        const std::string_view line = head.substr(position, next - position);
+        position = next + crlf.size();
+
+        const size_t colon = line.find(':');
+        if (colon == std::string_view::npos || colon == 0) {
+            return parseError(400, "Malformed header field");
+        }
+        parsed.headers.emplace_back(toLower(line.substr(0, colon)),
+                                    std::string(trim(line.substr(colon + 1))));
+    }
+
+    const std::string connection = parsed.getHeader("connection");
+    parsed.keepAlive = parsed.version == "HTTP/1.1" ? !containsToken(connection, "close")
+                                                    : containsToken(connection, "keep-alive");
+
+    if (!parsed.getHeader("transfer-encoding").empty()) {
+        return parseError(501, "Chunked request bodies are not supported");
+    }
+
+    size_t contentLength = 0;
+    if (const std::string lengthHeader = parsed.getHeader("content-length");
+        !lengthHeader.empty()) {
+        const auto [end, ec] = std::from_chars(
+            lengthHeader.data(), lengthHeader.data() + lengthHeader.size(), contentLength);
+        if (ec != std::errc() || end != lengthHeader.data() + lengthHeader.size()) {
+            return parseError(400, "Invalid Content-Length");
+        }
+        if (contentLength > maxBodyBytes) {
+            return parseError(413, "Request body too large");
+        }
+    }
+
+    const size_t bodyStart = headerEnd + headerTerminator.size();
+    if (buffer.size() - bodyStart < contentLength) {
+        return {};
+    }
+
+    parsed.body = std::string(buffer.substr(bodyStart, contentLength));
+    request = std::move(parsed);
+
+    HttpParseResult result;
+    result.status = HttpParseStatus::Complete;
+    result.consumed = bodyStart + contentLength;
+    return result;
+}
+
+std::string HttpParser::formatResponse(const int statusCode, const std::string& body,
+                                       const bool keepAlive) {
+    std::string response;
+    response.reserve(body.size() + 128);
+
+    response.append("HTTP/1.1 ")
+        .append(std::to_string(statusCode))
+        .append(" ")
+        .append(reasonPhrase(statusCode))
+        .append("\r\nContent-Type: application/json\r\nContent-Length: ")
+        .append(std::to_string(body.size()))
+        .append(keepAlive ? "\r\nConnection: keep-alive\r\n\r\n" : "\r\nConnection: close\r\n\r\n")
+        .append(body);
+
+    return response;
+}
+
+const char* HttpParser::reasonPhrase(const int statusCode) {
+    switch (statusCode) {
+        case 200:
+            return "OK";
+        case 201:
+            return "Created";
+        case 204:
+            return "No Content";
+        case 400:
+            return "Bad Request";
+        case 404:
+            return "Not Found";
+        case 405:
+            return "Method Not Allowed";
+        case 408:
+            return "Request Timeout";
+        case 413:
+            return "Payload Too Large";
+        case 431:
+            return "Request Header Fields Too Large";
+        case 501:
+            return "Not Implemented";
+        case 503:
+            return "Service Unavailable";
+        case 504:
+            return "Gateway Timeout";
+        default:
+            return statusCode >= 500 ? "Internal Server Error" : "Unknown";
+    }
+}
+
+rdws::types::LambdaEvent toLambdaEvent(const HttpRequest& request, const std::string& sourceIp) {
+    rdws::types::LambdaEvent event(request.method, request.target, request.body);
+
+    for (const auto& [name, value] : request.headers) {
+        event.setHeader(name, value);
+    }
+
+    auto& requestContext = event.getRequestContext();
+    requestContext.protocol = request.version;
+    requestContext.sourceIp = sourceIp;
+    if (const std::string userAgent = request.getHeader("user-agent"); !userAgent.empty()) {
+        requestContext.userAgent = userAgent;
+    }
+    if (const std::string requestId = request.getHeader("x-request-id"); !requestId.empty()) {
+        requestContext.requestId = requestId;
+    }
+
+    return event;
+}
+
+} // namespace rdws::server
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../types/lambda_event.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace rdws::server {
+
+/**
+ * Minimal HTTP/1.x request as read from a socket
+ * Header names are stored lower-cased
+ */
+struct HttpRequest {
+    std::string method;
+    std::string target;
+    std::string version;
+    std::vector<std::pair<std::string, std::string>> headers;
+    std::string body;
+    bool keepAlive = true;
+
+    [[nodiscard]] std::string getHeader(const std::string& lowerCaseName) const;
+};
+
+enum class HttpParseStatus { Complete, Incomplete, Error };
+
+struct HttpParseResult {
+    HttpParseStatus status = HttpParseStatus::Incomplete;
+    size_t consumed = 0;  // bytes of the buffer used by a complete request
+    int errorStatus = 0;  // HTTP status to answer with when status == Error
+    std::string error;
+};
+
+/**
+ * HttpParser - Incremental parser for HTTP/1.0 and HTTP/1.1 requests
+ * Supports Content-Length bodies; chunked request bodies are rejected with 501.
+ */
+class HttpParser {
+  public:
+    static constexpr size_t maxHeaderBytes = 16 * 1024;
+    static constexpr size_t maxBodyBytes = 10 * 1024 * 1024;
+
+    /**
+     * Try to parse one request from the start of the buffer
+     * @param buffer Bytes received so far on the connection
+     * @param request Filled in when the result is Complete
+     * @return Parse status and number of bytes consumed
+     */
+    static HttpParseResult parse(std::string_view buffer, HttpRequest& request);
+
+    /**
+     * Serialize a JSON response
+     * @param statusCode HTTP status code
+     * @param body Response body
+     * @param keepAlive Whether the connection stays open after this response
+     */
+    static std::string formatResponse(int statusCode, const std::string& body, bool keepAlive);
+
+    static const char* reasonPhrase(int statusCode);
+};
+
+/**
+ * Build the Lambda-style event for an HTTP request
+ * @param request Parsed HTTP request
+ * @param sourceIp Address of the peer
+ */
+rdws::types::LambdaEvent toLambdaEvent(const HttpRequest& request, const std::string& sourceIp);
+
+} // namespace rdws::server
@@ -0,0 +1,96 @@
+#include "http_server.h"
+
+#include "../common/utils/response_helper.h"
+#include "../controllers/base_controller.h"
+
+#include <exception>
+#include <string_view>
+#include <utility>
+
+using rdws::controllers::BaseController;
+
+namespace rdws::server {
+
+HttpServer::HttpServer(const int listeningSocket, RequestExecutor& requestExecutor,
+                       std::string serviceName, const std::chrono::milliseconds timeout,
+                       const IoBackend backend)
+    : StreamServer(listeningSocket, backend), executor(requestExecutor),
+      functionName(std::move(serviceName)), requestTimeout(timeout) {}
+
+void HttpServer::onData(Connection& connection) {
+    size_t offset = 0;
+
+    // Pipelined requests are answered in order: the next one is parsed once the previous completed
+    while (offset < connection.input.size() && !connection.closeAfterWrite &&
+           connection.pendingResponses == 0) {
+        HttpRequest request;
+        const auto parsed = HttpParser::parse(
+            std::string_view(connection.input).substr(offset), request);
+
+        if (parsed.status == HttpParseStatus::Incomplete) {
+            break;
+        }
+        if (parsed.status == HttpParseStatus::Error) {
+            connection.output += HttpParser::formatResponse(
+                parsed.errorStatus, BaseController::formatError(parsed.error, parsed.errorStatus),
+                false);
+            connection.closeAfterWrite = true;
+            break;
+        }
+
+        offset += parsed.consumed;
+        dispatch(connection, request);
+    }
+
+    connection.input.erase(0, offset);
+}
+
+void HttpServer::dispatch(Connection& connection, const HttpRequest& request) {
+    const int fd = connection.fd;
+    const uint64_t connectionId = connection.id;
+    const bool keepAlive = request.keepAlive;
+
+    try {
+        auto event = toLambdaEvent(request, connection.peer);
+        rdws::types::LambdaContext context(event.getRequestContext().requestId, functionName,
+                                           "1.0", requestTimeout);
+
+        executor.submit(RequestJob{
+            std::move(event), std::move(context),
+            [this, fd, connectionId, keepAlive](HandlerResponse response) {
+                post([this, fd, connectionId, keepAlive, response = std::move(response)] {
+                    finishRequest(fd, connectionId, keepAlive, response);
+                });
+            }});
+        // Completions always run later on the loop thread, so counting after submit is safe
+        ++connection.pendingResponses;
+    } catch (const std::exception& e) {
+        connection.output += HttpParser::formatResponse(
+            500, BaseController::formatServiceError(e.what()), false);
+        connection.closeAfterWrite = true;
+    }
+}
+
+void HttpServer::finishRequest(const int fd, const uint64_t connectionId, const bool keepAlive,
+                               const HandlerResponse& response) {
+    Connection* connection = findConnection(fd, connectionId);
+    if (connection == nullptr) {
+        return;
+    }
+
+    // A draining server tells the client to reconnect (to whichever process took over)
+    const bool keepOpen = keepAlive && !isDraining();
+    --connection->pendingResponses;
+    connection->output += HttpParser::formatResponse(response.statusCode, response.body, keepOpen);
+    if (!keepOpen) {
+        connection->closeAfterWrite = true;
+    }
+
+    // Continue with requests that were pipelined behind this one
+    if (!connection->input.empty()) {
+        onData(*connection);
+    }
+    flushConnection(*connection);
+}
+
+} // namespace rdws::server
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "http_parser.h"
+#include "request_executor.h"
+#include "stream_server.h"
+
+#include <chrono>
+#include <string>
+
+namespace rdws::server {
+
+/**
+ * HttpServer - HTTP/1.1 front end for a RequestExecutor
+ * Requests are parsed straight into LambdaEvent and answered on keep-alive connections.
+ * Pipelined requests on one connection are executed one at a time to keep responses in order.
+ */
+class HttpServer : public StreamServer {
+  private:
+    RequestExecutor& executor;
+    std::string functionName;
+    std::chrono::milliseconds requestTimeout;
+
+  public:
+    /**
+     * @param listeningSocket Listening TCP socket (see StreamServer::listenTcp)
+     * @param requestExecutor Runs the handler for every request
+     * @param serviceName Reported as LambdaContext function name
+     * @param timeout Deadline of every request, as the gateway's context would carry it
+     * @param backend I/O backend driving the event loop
+     */
+    HttpServer(int listeningSocket, RequestExecutor& requestExecutor, std::string serviceName,
+               std::chrono::milliseconds timeout, IoBackend backend = IoBackend::Epoll);
+
+  protected:
+    void onData(Connection& connection) override;
+
+  private:
+    void dispatch(Connection& connection, const HttpRequest& request);
+    void finishRequest(int fd, uint64_t connectionId, bool keepAlive,
+                       const HandlerResponse& response);
+};
+
+} // namespace rdws::server
@@ -0,0 +1,192 @@
+#include "listener_handoff.h"
+
+#include "stream_server.h"
+
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <utility>
+
+namespace rdws::server {
+
+namespace {
+
+// One byte carries the descriptor, one byte comes back once the successor holds it
+constexpr char offerByte = 'L';
+constexpr char ackByte = 'A';
+constexpr int transferTimeoutSeconds = 5;
+
+std::runtime_error systemError(const std::string& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+void setTimeouts(const int fd) {
+    timeval timeout{};
+    timeout.tv_sec = transferTimeoutSeconds;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+}
+
+} // namespace
+
+ListenerHandoff::ListenerHandoff(std::string offerPath, const int listeningSocket,
+                                 std::function<void()> handedOffCallback)
+    : path(std::move(offerPath)), listenFd(listeningSocket),
+      onHandedOff(std::move(handedOffCallback)) {
+    offerFd = StreamServer::listenUnix(path, 4);
+    ::chmod(path.c_str(), S_IRUSR | S_IWUSR);
+    struct stat offered {};
+    if (::stat(path.c_str(), &offered) == 0) {
+        offerInode = offered.st_ino;
+    }
+
+    stopFd = eventfd(0, EFD_CLOEXEC);
+    if (stopFd < 0) {
+        const auto error = systemError("eventfd failed");
+        ::close(offerFd);
+        throw error;
+    }
+    thread = std::thread([this] { serve(); });
+}
+
+ListenerHandoff::~ListenerHandoff() {
+    const uint64_t one = 1;
+    [[maybe_unused]] const auto written = ::write(stopFd, &one, sizeof(one));
+    thread.join();
+
+    // After a handoff the path belongs to the successor
+    struct stat current {};
+    if (::lstat(path.c_str(), &current) == 0 && current.st_ino == offerInode) {
+        ::unlink(path.c_str());
+    }
+    ::close(offerFd);
+    ::close(stopFd);
+}
+
+void ListenerHandoff::serve() {
+    pollfd watched[2] = {{offerFd, POLLIN, 0}, {stopFd, POLLIN, 0}};
+
+    while (!handedOff.load()) {
+        if (::poll(watched, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        if (watched[1].revents != 0) {
+            return;
+        }
+        if (watched[0].revents == 0) {
+            continue;
+        }
+
+        const int successor = accept4(offerFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (successor < 0) {
+            continue;
+        }
+
+        ucred peer{};
+        socklen_t length = sizeof(peer);
+        const bool sameUser =
+            getsockopt(successor, SOL_SOCKET, SO_PEERCRED, &peer, &length) == 0 &&
+            peer.uid == geteuid();
+        if (sameUser && offerTo(successor)) {
+            handedOff.store(true);
+        }
+        ::close(successor);
+    }
+
+    if (handedOff.load() && onHandedOff) {
+        onHandedOff();
+    }
+}
+
+bool ListenerHandoff::offerTo(const int successor) const {
+    // Blocking exchange, bounded so a stuck successor cannot hold the handoff thread
+    setTimeouts(successor);
+
+    char payload = offerByte;
+    iovec data{&payload, 1};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+    msghdr message{};
+    message.msg_iov = &data;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    cmsghdr* header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(header), &listenFd, sizeof(int));
+
+    if (::sendmsg(successor, &message, MSG_NOSIGNAL) != 1) {
+        return false;
+    }
+
+    // Without the acknowledgement the successor may have died: keep serving
+    char ack = 0;
+    return ::recv(successor, &ack, 1, 0) == 1 && ack == ackByte;
+}
+
+int ListenerHandoff::takeOver(const std::string& offerPath) {
+    sockaddr_un address{};
+    if (offerPath.empty() || offerPath.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Invalid handoff socket path: " + offerPath);
+    }
+    address.sun_family = AF_UNIX;
+    offerPath.copy(address.sun_path, offerPath.size());
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw systemError("socket failed");
+    }
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        // No file, or a stale one left by a process that is gone: nobody to take over from
+        const int error = errno;
+        ::close(fd);
+        if (error == ENOENT || error == ECONNREFUSED) {
+            return -1;
+        }
+        errno = error;
+        throw systemError("Cannot reach " + offerPath);
+    }
+    setTimeouts(fd);
+
+    char payload = 0;
+    iovec data{&payload, 1};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+    msghdr message{};
+    message.msg_iov = &data;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    const ssize_t received = ::recvmsg(fd, &message, MSG_CMSG_CLOEXEC);
+    const cmsghdr* header = CMSG_FIRSTHDR(&message);
+    if (received != 1 || payload != offerByte || header == nullptr ||
+        header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS) {
+        ::close(fd);
+        throw std::runtime_error("No listener received from " + offerPath);
+    }
+    int listener = -1;
+    std::memcpy(&listener, CMSG_DATA(header), sizeof(int));
+
+    const char ack = ackByte;
+    if (::send(fd, &ack, 1, MSG_NOSIGNAL) != 1) {
+        const auto error = systemError("Handoff acknowledgement failed");
+        ::close(listener);
+        ::close(fd);
+        throw error;
+    }
+    ::close(fd);
+    return listener;
+}
+
+} // namespace rdws::server
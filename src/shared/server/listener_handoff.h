@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <sys/types.h>
+#include <thread>
+
+namespace rdws::server {
+
+/**
+ * ListenerHandoff - Passes a listening socket to the next process over SCM_RIGHTS
+ *
+ * A serving process offers its listener on a Unix socket path. A newly deployed process
+ * calls takeOver() once it is ready to serve: when a predecessor answers, both processes
+ * share the very same listening socket, so no connection is refused in between, and the
+ * predecessor is told to drain. The new process then offers the listener in turn.
+ *
+ * Only processes of the same user may take the listener over.
+ */
+class ListenerHandoff {
+  private:
+    std::string path;
+    int listenFd;
+    int offerFd = -1;
+    int stopFd = -1;
+    ino_t offerInode = 0;
+    std::atomic<bool> handedOff{false};
+    std::function<void()> onHandedOff;
+    std::thread thread;
+
+  public:
+    /**
+     * Offer a listener at path until a successor confirms it received it
+     * @param listeningSocket Stays owned by the caller and must outlive this object
+     * @param handedOffCallback Called on the handoff thread once a successor has the listener
+     * @throws std::runtime_error when path cannot be bound
+     */
+    ListenerHandoff(std::string offerPath, int listeningSocket,
+                    std::function<void()> handedOffCallback);
+
+    /**
+     * Stop offering; removes the socket file unless a successor already replaced it
+     */
+    ~ListenerHandoff();
+
+    ListenerHandoff(const ListenerHandoff&) = delete;
+    ListenerHandoff& operator=(const ListenerHandoff&) = delete;
+
+    [[nodiscard]] bool wasHandedOff() const {
+        return handedOff.load();
+    }
+
+    /**
+     * Receive the listener offered at path
+     * @return The listening socket, or -1 when no process offers one there
+     * @throws std::runtime_error when a process answered but the transfer failed
+     */
+    static int takeOver(const std::string& offerPath);
+
+  private:
+    void serve();
+    bool offerTo(int successor) const;
+};
+
+} // namespace rdws::server
@@ -0,0 +1,85 @@
+#include "metrics_registry.h"
+
+#include "../common/database/statement_stats.h"
+#include "../common/utils/response_helper.h"
+
+#include <algorithm>
+
+namespace rdws::server {
+
+void MetricsRegistry::record(const std::string& route, const int statusCode,
+                             const std::chrono::microseconds elapsed) {
+    const auto micros = static_cast<uint64_t>(std::max<int64_t>(elapsed.count(), 0));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& stats = routes[route];
+    ++stats.requests;
+    if (statusCode >= 500) {
+        ++stats.serverErrors;
+    } else if (statusCode >= 400) {
+        ++stats.clientErrors;
+    }
+    stats.totalMicros += micros;
+    stats.maxMicros = std::max(stats.maxMicros, micros);
+}
+
+std::map<std::string, MetricsRegistry::RouteStats> MetricsRegistry::snapshot() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return routes;
+}
+
+std::string MetricsRegistry::toJson() const {
+    const auto stats = snapshot();
+    const auto uptime = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now() - startedAt);
+
+    rapidjson::Document doc;
+    doc.SetObject();
+    auto& allocator = doc.GetAllocator();
+
+    rapidjson::Value routeArray(rapidjson::kArrayType);
+    uint64_t totalRequests = 0;
+    for (const auto& [route, routeStats] : stats) {
+        rapidjson::Value entry(rapidjson::kObjectType);
+        entry.AddMember("route", rapidjson::Value(route.c_str(), allocator), allocator);
+        entry.AddMember("requests", rapidjson::Value(routeStats.requests), allocator);
+        entry.AddMember("clientErrors", rapidjson::Value(routeStats.clientErrors), allocator);
+        entry.AddMember("serverErrors", rapidjson::Value(routeStats.serverErrors), allocator);
+        entry.AddMember("avgMicros",
+                        rapidjson::Value(routeStats.requests > 0
+                                             ? routeStats.totalMicros / routeStats.requests
+                                             : 0),
+                        allocator);
+        entry.AddMember("maxMicros", rapidjson::Value(routeStats.maxMicros), allocator);
+        routeArray.PushBack(entry, allocator);
+        totalRequests += routeStats.requests;
+    }
+
+    // Time spent in the database, per statement, to set against the handler times above
+    rapidjson::Value statementArray(rapidjson::kArrayType);
+    for (const auto& statement : rdws::database::StatementMetrics::snapshot()) {
+        rapidjson::Value entry(rapidjson::kObjectType);
+        entry.AddMember("statement", rapidjson::Value(statement.fingerprint.c_str(), allocator),
+                        allocator);
+        entry.AddMember("calls", rapidjson::Value(statement.calls), allocator);
+        entry.AddMember("errors", rapidjson::Value(statement.errors), allocator);
+        entry.AddMember("rows", rapidjson::Value(statement.rows), allocator);
+        entry.AddMember("bytes", rapidjson::Value(statement.bytes), allocator);
+        entry.AddMember("totalMicros", rapidjson::Value(statement.totalMicros), allocator);
+        entry.AddMember("p50Micros", rapidjson::Value(statement.p50Micros), allocator);
+        entry.AddMember("p95Micros", rapidjson::Value(statement.p95Micros), allocator);
+        entry.AddMember("p99Micros", rapidjson::Value(statement.p99Micros), allocator);
+        entry.AddMember("maxMicros", rapidjson::Value(statement.maxMicros), allocator);
+        statementArray.PushBack(entry, allocator);
+    }
+
+    doc.AddMember("uptimeSeconds", rapidjson::Value(static_cast<int64_t>(uptime.count())),
+                  allocator);
+    doc.AddMember("totalRequests", rapidjson::Value(totalRequests), allocator);
+    doc.AddMember("routes", routeArray, allocator);
+    doc.AddMember("statements", statementArray, allocator);
+
+    return rdws::utils::ResponseHelper::returnData(doc, "Server metrics");
+}
+
+} // namespace rdws::server
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace rdws::server {
+
+/**
+ * MetricsRegistry - Process-wide request counters, keyed by route pattern
+ * Thread-safe; shared by every dispatcher (and worker) of a process.
+ */
+class MetricsRegistry {
+  public:
+    struct RouteStats {
+        uint64_t requests = 0;
+        uint64_t clientErrors = 0;  // 4xx
+        uint64_t serverErrors = 0;  // 5xx
+        uint64_t totalMicros = 0;
+        uint64_t maxMicros = 0;
+    };
+
+  private:
+    mutable std::mutex mutex;
+    std::map<std::string, RouteStats> routes;
+    const std::chrono::steady_clock::time_point startedAt = std::chrono::steady_clock::now();
+
+  public:
+    /**
+     * Record one handled request
+     * @param route Route pattern that matched (not the raw path, to bound cardinality)
+     * @param statusCode HTTP status of the response
+     * @param elapsed Time spent in the handler
+     */
+    void record(const std::string& route, int statusCode, std::chrono::microseconds elapsed);
+
+    [[nodiscard]] std::map<std::string, RouteStats> snapshot() const;
+
+    /**
+     * Render the metrics as a standard data response, with the process-wide database
+     * statement stats (StatementMetrics) next to the routes
+     */
+    [[nodiscard]] std::string toJson() const;
+};
+
+} // namespace rdws::server
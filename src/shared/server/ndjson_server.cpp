@@ -0,0 +1,52 @@
+#include "ndjson_server.h"
+
+#include "../common/utils/response_helper.h"
+#include "../controllers/base_controller.h"
+#include "request_executor.h"
+#include "request_frame.h"
+
+#include <exception>
+
+using rdws::controllers::BaseController;
+
+namespace rdws::server {
+
+NdjsonServer::NdjsonServer(RequestHandler& requestHandler) : handler(requestHandler) {}
+
+size_t NdjsonServer::run(std::istream& in, std::ostream& out) {
+    size_t served = 0;
+    std::string line;
+
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+
+        // Flush per frame: the caller is waiting on this line before sending the next one
+        out << handleFrame(line) << '\n' << std::flush;
+        ++served;
+    }
+
+    return served;
+}
+
+std::string NdjsonServer::handleFrame(const std::string& line) {
+    try {
+        rapidjson::Document doc;
+        if (doc.Parse(line.c_str()).HasParseError()) {
+            return BaseController::formatError("Invalid request frame: JSON parse error", 400);
+        }
+
+        auto [event, context] = RequestFrame::fromJson(doc);
+        context.log("Function started", "INFO");
+
+        return invokeHandler(handler, event, context).body;
+    } catch (const std::exception& e) {
+        return BaseController::formatServiceError(e.what());
+    }
+}
+
+} // namespace rdws::server
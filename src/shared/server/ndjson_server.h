@@ -0,0 +1,41 @@
+#pragma once
+
+#include "request_handler.h"
+
+#include <istream>
+#include <ostream>
+#include <string>
+
+namespace rdws::server {
+
+/**
+ * NdjsonServer - Persistent worker loop over newline-delimited JSON
+ *
+ * Each input line is a frame of the form {"event": {...}, "context": {...}}.
+ * Exactly one single-line JSON response is written to the output per frame,
+ * so callers can pair requests and responses by order.
+ */
+class NdjsonServer {
+  private:
+    RequestHandler& handler;
+
+  public:
+    explicit NdjsonServer(RequestHandler& requestHandler);
+
+    /**
+     * Serve frames until the input stream reaches EOF
+     * @param in Stream with one request frame per line
+     * @param out Stream receiving one response per line
+     * @return Number of frames served
+     */
+    size_t run(std::istream& in, std::ostream& out);
+
+    /**
+     * Handle a single frame
+     * @param line Raw frame text
+     * @return Single-line JSON response body
+     */
+    std::string handleFrame(const std::string& line);
+};
+
+} // namespace rdws::server
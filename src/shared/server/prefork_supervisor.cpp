@@ -0,0 +1,155 @@
+#include "prefork_supervisor.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <utility>
+
+namespace rdws::server {
+
+namespace {
+
+// Workers that die sooner than this after starting are restarted with a delay
+constexpr auto minimumHealthyUptime = std::chrono::seconds(1);
+constexpr auto maximumRestartDelay = std::chrono::seconds(30);
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void requestStop(int) {
+    stopRequested = 1;
+}
+
+// Install without SA_RESTART so waitpid() returns EINTR when a stop signal arrives
+void installHandler(const int signal, void (*handler)(int)) {
+    struct sigaction action {};
+    action.sa_handler = handler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = 0;
+    sigaction(signal, &action, nullptr);
+}
+
+std::string describeExit(const int status) {
+    if (WIFEXITED(status)) {
+        return "exited with code " + std::to_string(WEXITSTATUS(status));
+    }
+    if (WIFSIGNALED(status)) {
+        return std::string("killed by signal ") + strsignal(WTERMSIG(status));
+    }
+    return "stopped";
+}
+
+} // namespace
+
+PreforkSupervisor::PreforkSupervisor(const size_t count, WorkerMain main,
+                                     const rdws::types::LambdaContext& context)
+    : workerCount(count), workerMain(std::move(main)), logContext(context), workers(count) {}
+
+int PreforkSupervisor::run() {
+    stopRequested = 0;
+    installHandler(SIGINT, requestStop);
+    installHandler(SIGTERM, requestStop);
+
+    for (size_t i = 0; i < workerCount; ++i) {
+        if (!spawn(i)) {
+            stopWorkers();
+            return 1;
+        }
+    }
+    logContext.log("Supervising " + std::to_string(workerCount) + " worker processes", "INFO");
+
+    while (!stopRequested) {
+        int status = 0;
+        const pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            logContext.log(std::string("waitpid failed: ") + std::strerror(errno), "ERROR");
+            break;
+        }
+        handleExit(pid, status);
+    }
+
+    stopWorkers();
+    installHandler(SIGINT, SIG_DFL);
+    installHandler(SIGTERM, SIG_DFL);
+    logContext.log("All workers stopped", "INFO");
+    return 0;
+}
+
+bool PreforkSupervisor::spawn(const size_t index) {
+    const pid_t pid = fork();
+    if (pid < 0) {
+        logContext.log(std::string("fork failed: ") + std::strerror(errno), "ERROR");
+        return false;
+    }
+
+    if (pid == 0) {
+        // Worker: default signal handling, the server installs its own
+        installHandler(SIGINT, SIG_DFL);
+        installHandler(SIGTERM, SIG_DFL);
+        std::_Exit(workerMain(index));
+    }
+
+    workers[index].pid = pid;
+    workers[index].startedAt = std::chrono::steady_clock::now();
+    logContext.log("Worker " + std::to_string(index) + " started with pid " + std::to_string(pid),
+                   "INFO");
+    return true;
+}
+
+void PreforkSupervisor::handleExit(const pid_t pid, const int status) {
+    for (size_t index = 0; index < workers.size(); ++index) {
+        Worker& worker = workers[index];
+        if (worker.pid != pid) {
+            continue;
+        }
+
+        worker.pid = -1;
+        logContext.log("Worker " + std::to_string(index) + " (pid " + std::to_string(pid) + ") " +
+                           describeExit(status),
+                       "WARN");
+
+        // Back off on crash loops (e.g. database down) instead of forking continuously
+        const auto uptime = std::chrono::steady_clock::now() - worker.startedAt;
+        worker.rapidFailures = uptime < minimumHealthyUptime ? worker.rapidFailures + 1 : 0;
+        if (worker.rapidFailures > 0) {
+            const auto delay = std::min<std::chrono::seconds>(
+                std::chrono::seconds(1u << std::min(worker.rapidFailures - 1, 5u)),
+                maximumRestartDelay);
+            // nanosleep() returns early when a stop signal arrives
+            const timespec pause{static_cast<time_t>(delay.count()), 0};
+            nanosleep(&pause, nullptr);
+        }
+
+        if (!stopRequested) {
+            spawn(index);
+        }
+        return;
+    }
+}
+
+void PreforkSupervisor::stopWorkers() {
+    for (const Worker& worker : workers) {
+        if (worker.pid > 0) {
+            kill(worker.pid, SIGTERM);
+        }
+    }
+
+    for (Worker& worker : workers) {
+        if (worker.pid > 0) {
+            int status = 0;
+            while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) {
+            }
+            worker.pid = -1;
+        }
+    }
+}
+
+} // namespace rdws::server
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "../types/lambda_context.h"
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <sys/types.h>
+#include <vector>
+
+namespace rdws::server {
+
+/**
+ * PreforkSupervisor - Runs N copies of a server in forked worker processes
+ *
+ * Workers share nothing but the listening port (each binds it with SO_REUSEPORT,
+ * so the kernel balances connections). Crashed workers are restarted; SIGINT and
+ * SIGTERM are forwarded to every worker and the supervisor exits once they are gone.
+ */
+class PreforkSupervisor {
+  public:
+    /**
+     * Body of a worker process, run after fork(); its return value is the exit code
+     */
+    using WorkerMain = std::function<int(size_t workerIndex)>;
+
+  private:
+    struct Worker {
+        pid_t pid = -1;
+        std::chrono::steady_clock::time_point startedAt;
+        unsigned int rapidFailures = 0;
+    };
+
+    size_t workerCount;
+    WorkerMain workerMain;
+    const rdws::types::LambdaContext& logContext;
+    std::vector<Worker> workers;
+
+  public:
+    PreforkSupervisor(size_t count, WorkerMain main, const rdws::types::LambdaContext& context);
+
+    /**
+     * Fork the workers and supervise them until a stop signal arrives
+     * @return 0 after a clean shutdown, 1 when the workers could not be started
+     */
+    int run();
+
+  private:
+    bool spawn(size_t index);
+    void handleExit(pid_t pid, int status);
+    void stopWorkers();
+};
+
+} // namespace rdws::server
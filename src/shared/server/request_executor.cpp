@@ -0,0 +1,41 @@
+#include "request_executor.h"
+
+#include "../common/database/deadline.h"
+#include "../common/utils/response_helper.h"
+#include "../controllers/base_controller.h"
+
+#include <exception>
+#include <utility>
+
+using rdws::controllers::BaseController;
+
+namespace rdws::server {
+
+HandlerResponse invokeHandler(RequestHandler& handler, rdws::types::LambdaEvent& event,
+                              const rdws::types::LambdaContext& context) {
+    const rdws::database::DeadlineScope deadline(context.getRemainingTimeMs());
+    try {
+        auto response = handler.handle(event, context);
+        return deadline.wasExceeded() ? deadlineExceededResponse(context) : response;
+    } catch (const std::exception& e) {
+        if (deadline.wasExceeded()) {
+            return deadlineExceededResponse(context);
+        }
+        context.log(std::string("Unhandled error: ") + e.what(), "ERROR");
+        return {BaseController::formatServiceError(e.what()), 1, 500};
+    }
+}
+
+HandlerResponse deadlineExceededResponse(const rdws::types::LambdaContext& context) {
+    // Whatever the service made of the failed database call, the caller gets a timeout
+    context.log("Deadline of " + std::to_string(context.getTimeout().count()) +
+                    " ms exceeded, database work canceled",
+                "WARN");
+    return {BaseController::formatError("Request deadline exceeded", 504), 1, 504};
+}
+
+void InlineExecutor::submit(RequestJob job) {
+    job.complete(invokeHandler(*handler, job.event, job.context));
+}
+
+} // namespace rdws::server
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "request_handler.h"
+
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace rdws::server {
+
+/**
+ * A request waiting to be handled
+ * complete is invoked exactly once, possibly on another thread.
+ */
+struct RequestJob {
+    rdws::types::LambdaEvent event;
+    rdws::types::LambdaContext context;
+    std::function<void(HandlerResponse)> complete;
+};
+
+/**
+ * Run a handler, turning exceptions into a 500 service error response
+ * The handler runs under a DeadlineScope of the context's remaining time; once a database
+ * call gives up on that deadline, the response is a 504 whatever the handler returned.
+ */
+HandlerResponse invokeHandler(RequestHandler& handler, rdws::types::LambdaEvent& event,
+                              const rdws::types::LambdaContext& context);
+
+/**
+ * 504 response for a request whose deadline cut its database work short
+ */
+HandlerResponse deadlineExceededResponse(const rdws::types::LambdaContext& context);
+
+/**
+ * RequestExecutor - Decides where the network servers run their handlers
+ */
+class RequestExecutor {
+  public:
+    virtual ~RequestExecutor() = default;
+
+    virtual void submit(RequestJob job) = 0;
+
+    /**
+     * Finish queued work and release resources; called before the server is destroyed
+     */
+    virtual void shutdown() {}
+};
+
+/**
+ * InlineExecutor - Handles each request immediately on the calling (event loop) thread
+ */
+class InlineExecutor : public RequestExecutor {
+  private:
+    std::unique_ptr<RequestHandler> handler;
+
+  public:
+    explicit InlineExecutor(std::unique_ptr<RequestHandler> requestHandler)
+        : handler(std::move(requestHandler)) {}
+
+    void submit(RequestJob job) override;
+};
+
+} // namespace rdws::server
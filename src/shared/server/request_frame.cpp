@@ -0,0 +1,22 @@
+#include "request_frame.h"
+
+#include <stdexcept>
+
+namespace rdws::server {
+
+RequestFrame RequestFrame::fromJson(const rapidjson::Value& frame) {
+    if (!frame.IsObject()) {
+        throw std::runtime_error("Request frame must be a JSON object");
+    }
+    if (!frame.HasMember("event") || !frame["event"].IsObject()) {
+        throw std::runtime_error("Request frame is missing the event object");
+    }
+    if (!frame.HasMember("context") || !frame["context"].IsObject()) {
+        throw std::runtime_error("Request frame is missing the context object");
+    }
+
+    return RequestFrame{rdws::types::LambdaEvent::fromJsonValue(frame["event"]),
+                        rdws::types::LambdaContext::fromJsonValue(frame["context"])};
+}
+
+} // namespace rdws::server
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "../types/lambda_context.h"
+#include "../types/lambda_event.h"
+
+#include <rapidjson/document.h>
+
+namespace rdws::server {
+
+/**
+ * RequestFrame - Event/Context pair carried by the persistent server modes
+ * Wire format: {"event": <LambdaEvent JSON>, "context": <LambdaContext JSON>}
+ */
+struct RequestFrame {
+    rdws::types::LambdaEvent event;
+    rdws::types::LambdaContext context;
+
+    /**
+     * Build a frame from a parsed JSON object
+     * @param frame JSON object with "event" and "context" members
+     * @throws std::runtime_error if a member is missing or malformed
+     */
+    static RequestFrame fromJson(const rapidjson::Value& frame);
+};
+
+} // namespace rdws::server
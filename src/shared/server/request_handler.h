@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../types/lambda_context.h"
+#include "../types/lambda_event.h"
+
+#include <string>
+
+namespace rdws::server {
+
+/**
+ * Response produced by a service for a single Lambda-style request
+ */
+struct HandlerResponse {
+    std::string body;
+    int exitCode = 0;
+    int statusCode = 200;
+};
+
+/**
+ * RequestHandler - Routes a LambdaEvent to the business logic of a service
+ * Implementations are reused across requests by the long-lived server modes
+ */
+class RequestHandler {
+  public:
+    virtual ~RequestHandler() = default;
+
+    /**
+     * Handle a single request
+     * @param event Request event (path parameters are extracted in place)
+     * @param context Runtime context of the request
+     * @return JSON response body, the exit code used by the one-shot mode and the HTTP status
+     */
+    virtual HandlerResponse handle(rdws::types::LambdaEvent& event,
+                                   const rdws::types::LambdaContext& context) = 0;
+
+    /**
+     * Fill caches before the first request (long-lived modes only)
+     * Called once the database connection is open, before the server starts accepting.
+     */
+    virtual void warmUp() {}
+};
+
+} // namespace rdws::server
@@ -0,0 +1,99 @@
+#include "route_dispatcher.h"
+
+#include "../controllers/base_controller.h"
+#include "health_check.h"
+
+#include <chrono>
+#include <set>
+#include <utility>
+
+using rdws::controllers::BaseController;
+
+namespace rdws::server {
+
+namespace {
+
+constexpr auto metricsPath = "/metrics";
+
+} // namespace
+
+RouteDispatcher::RouteDispatcher(std::shared_ptr<MetricsRegistry> metricsRegistry)
+    : metrics(std::move(metricsRegistry)) {}
+
+void RouteDispatcher::addRoute(const std::string& pattern,
+                               std::shared_ptr<RequestHandler> handler) {
+    routes.push_back(Route{pattern, splitPath(pattern), std::move(handler)});
+}
+
+HandlerResponse RouteDispatcher::handle(rdws::types::LambdaEvent& event,
+                                        const rdws::types::LambdaContext& context) {
+    const std::string& path = event.getPath();
+
+    if (path == metricsPath && event.isGet()) {
+        return {metrics->toJson(), 0, 200};
+    }
+    if (isHealthCheck(event)) {
+        return healthResponse();
+    }
+
+    const Route* route = findRoute(path);
+    if (route == nullptr) {
+        context.log("No route for " + event.getHttpMethod() + " " + path, "WARN");
+        return {BaseController::formatError("Route " + path + " not found", 404), 1, 404};
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    auto response = route->handler->handle(event, context);
+    metrics->record(route->pattern, response.statusCode,
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - start));
+    return response;
+}
+
+void RouteDispatcher::warmUp() {
+    std::set<RequestHandler*> warmed;
+    for (const auto& route : routes) {
+        if (warmed.insert(route.handler.get()).second) {
+            route.handler->warmUp();
+        }
+    }
+}
+
+const RouteDispatcher::Route* RouteDispatcher::findRoute(const std::string_view path) const {
+    const auto segments = splitPath(path);
+
+    for (const auto& route : routes) {
+        if (route.segments.size() != segments.size()) {
+            continue;
+        }
+
+        bool matched = true;
+        for (size_t i = 0; i < segments.size() && matched; ++i) {
+            const std::string& expected = route.segments[i];
+            const bool isParameter = !expected.empty() && expected.front() == '{';
+            matched = isParameter ? !segments[i].empty() : expected == segments[i];
+        }
+        if (matched) {
+            return &route;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<std::string> RouteDispatcher::splitPath(std::string_view path) {
+    std::vector<std::string> segments;
+    while (!path.empty() && path.front() == '/') {
+        path.remove_prefix(1);
+    }
+    while (!path.empty()) {
+        const size_t slash = path.find('/');
+        segments.emplace_back(path.substr(0, slash));
+        if (slash == std::string_view::npos) {
+            break;
+        }
+        path.remove_prefix(slash + 1);
+    }
+    return segments;
+}
+
+} // namespace rdws::server
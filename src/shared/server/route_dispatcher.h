@@ -0,0 +1,54 @@
+#pragma once
+
+#include "metrics_registry.h"
+#include "request_handler.h"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rdws::server {
+
+/**
+ * RouteDispatcher - Routes requests of several services inside one process
+ *
+ * Routes are matched in registration order against path patterns such as
+ * /users/{userId}/orders, so more specific patterns must be added first.
+ * GET /metrics is served from the shared MetricsRegistry, and GET /health reports the
+ * database circuit breakers of the process (503 while one is not closed).
+ */
+class RouteDispatcher : public RequestHandler {
+  private:
+    struct Route {
+        std::string pattern;
+        std::vector<std::string> segments;  // "{...}" matches any single segment
+        std::shared_ptr<RequestHandler> handler;
+    };
+
+    std::vector<Route> routes;
+    std::shared_ptr<MetricsRegistry> metrics;
+
+  public:
+    explicit RouteDispatcher(std::shared_ptr<MetricsRegistry> metricsRegistry);
+
+    /**
+     * Register a handler for a path pattern
+     * A handler may be registered under several patterns.
+     */
+    void addRoute(const std::string& pattern, std::shared_ptr<RequestHandler> handler);
+
+    HandlerResponse handle(rdws::types::LambdaEvent& event,
+                           const rdws::types::LambdaContext& context) override;
+
+    /**
+     * Warm up every registered handler once
+     */
+    void warmUp() override;
+
+  private:
+    [[nodiscard]] const Route* findRoute(std::string_view path) const;
+    static std::vector<std::string> splitPath(std::string_view path);
+};
+
+} // namespace rdws::server
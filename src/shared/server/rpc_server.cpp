@@ -0,0 +1,126 @@
+#include "rpc_server.h"
+
+#include "../common/utils/response_helper.h"
+#include "../controllers/base_controller.h"
+#include "request_frame.h"
+
+#include <exception>
+#include <utility>
+
+using rdws::controllers::BaseController;
+
+namespace rdws::server {
+
+namespace {
+
+uint32_t readUint32(const std::string_view bytes, const size_t offset) {
+    return (static_cast<uint32_t>(static_cast<unsigned char>(bytes[offset])) << 24) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(bytes[offset + 1])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(bytes[offset + 2])) << 8) |
+           static_cast<uint32_t>(static_cast<unsigned char>(bytes[offset + 3]));
+}
+
+void writeUint32(std::string& out, const uint32_t value) {
+    out.push_back(static_cast<char>((value >> 24) & 0xFF));
+    out.push_back(static_cast<char>((value >> 16) & 0xFF));
+    out.push_back(static_cast<char>((value >> 8) & 0xFF));
+    out.push_back(static_cast<char>(value & 0xFF));
+}
+
+} // namespace
+
+RpcFrameHeader RpcFrameHeader::decode(const std::string_view bytes) {
+    return RpcFrameHeader{readUint32(bytes, 0), readUint32(bytes, 4), readUint32(bytes, 8)};
+}
+
+void RpcFrameHeader::encodeTo(std::string& out) const {
+    writeUint32(out, payloadLength);
+    writeUint32(out, requestId);
+    writeUint32(out, status);
+}
+
+RpcServer::RpcServer(const int listeningSocket, RequestExecutor& requestExecutor,
+                     const IoBackend backend)
+    : StreamServer(listeningSocket, backend), executor(requestExecutor) {}
+
+void RpcServer::appendFrame(std::string& out, const uint32_t requestId, const uint32_t status,
+                            const std::string_view payload) {
+    out.reserve(out.size() + RpcFrameHeader::size + payload.size());
+    RpcFrameHeader{static_cast<uint32_t>(payload.size()), requestId, status}.encodeTo(out);
+    out.append(payload);
+}
+
+void RpcServer::onData(Connection& connection) {
+    const std::string_view input(connection.input);
+    size_t offset = 0;
+
+    while (input.size() - offset >= RpcFrameHeader::size) {
+        const auto header = RpcFrameHeader::decode(input.substr(offset));
+
+        if (header.payloadLength > RpcFrameHeader::maxPayloadLength) {
+            // The stream cannot be resynchronised after a bad length
+            appendFrame(connection.output, header.requestId, 413,
+                        BaseController::formatError("RPC frame too large", 413));
+            connection.closeAfterWrite = true;
+            offset = input.size();
+            break;
+        }
+        if (input.size() - offset - RpcFrameHeader::size < header.payloadLength) {
+            break;
+        }
+
+        const std::string payload(
+            input.substr(offset + RpcFrameHeader::size, header.payloadLength));
+        offset += RpcFrameHeader::size + header.payloadLength;
+
+        dispatch(connection, header.requestId, payload);
+    }
+
+    connection.input.erase(0, offset);
+}
+
+void RpcServer::dispatch(Connection& connection, const uint32_t requestId,
+                         const std::string& payload) {
+    try {
+        rapidjson::Document doc;
+        if (doc.Parse(payload.c_str(), payload.size()).HasParseError()) {
+            appendFrame(
+                connection.output, requestId, 400,
+                BaseController::formatError("Invalid request frame: JSON parse error", 400));
+            return;
+        }
+
+        auto [event, context] = RequestFrame::fromJson(doc);
+        context.log("Function started", "INFO");
+
+        const int fd = connection.fd;
+        const uint64_t connectionId = connection.id;
+        executor.submit(RequestJob{
+            std::move(event), std::move(context),
+            [this, fd, connectionId, requestId](HandlerResponse response) {
+                post([this, fd, connectionId, requestId, response = std::move(response)] {
+                    finishRequest(fd, connectionId, requestId, response);
+                });
+            }});
+        // Completions always run later on the loop thread, so counting after submit is safe
+        ++connection.pendingResponses;
+    } catch (const std::exception& e) {
+        appendFrame(connection.output, requestId, 500,
+                    BaseController::formatServiceError(e.what()));
+    }
+}
+
+void RpcServer::finishRequest(const int fd, const uint64_t connectionId, const uint32_t requestId,
+                              const HandlerResponse& response) {
+    Connection* connection = findConnection(fd, connectionId);
+    if (connection == nullptr) {
+        return;
+    }
+
+    --connection->pendingResponses;
+    appendFrame(connection->output, requestId, static_cast<uint32_t>(response.statusCode),
+                response.body);
+    flushConnection(*connection);
+}
+
+} // namespace rdws::server
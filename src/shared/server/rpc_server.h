@@ -0,0 +1,70 @@
+#pragma once
+
+#include "request_executor.h"
+#include "stream_server.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace rdws::server {
+
+/**
+ * Header preceding every RPC frame (all fields big-endian)
+ *
+ *   uint32 payloadLength   bytes following the header
+ *   uint32 requestId       chosen by the client, echoed in the response
+ *   uint32 status          0 in requests, HTTP status code in responses
+ *
+ * Request payload: {"event": {...}, "context": {...}} (same object as an NDJSON frame)
+ * Response payload: the controller JSON body
+ */
+struct RpcFrameHeader {
+    static constexpr size_t size = 12;
+    static constexpr uint32_t maxPayloadLength = 16 * 1024 * 1024;
+
+    uint32_t payloadLength = 0;
+    uint32_t requestId = 0;
+    uint32_t status = 0;
+
+    static RpcFrameHeader decode(std::string_view bytes);
+    void encodeTo(std::string& out) const;
+};
+
+/**
+ * RpcServer - Length-prefixed request/response protocol for the API gateway
+ *
+ * Served over a Unix domain socket; a client may keep many requests in flight on
+ * one connection and match responses by request ID. With a WorkerPool executor
+ * responses are written in completion order.
+ */
+class RpcServer : public StreamServer {
+  private:
+    RequestExecutor& executor;
+
+  public:
+    /**
+     * @param listeningSocket Listening socket (see StreamServer::listenUnix)
+     * @param requestExecutor Runs the handler for every request
+     * @param backend I/O backend driving the event loop
+     */
+    RpcServer(int listeningSocket, RequestExecutor& requestExecutor,
+              IoBackend backend = IoBackend::Epoll);
+
+    /**
+     * Append a complete response frame to out
+     */
+    static void appendFrame(std::string& out, uint32_t requestId, uint32_t status,
+                            std::string_view payload);
+
+  protected:
+    void onData(Connection& connection) override;
+
+  private:
+    void dispatch(Connection& connection, uint32_t requestId, const std::string& payload);
+    void finishRequest(int fd, uint64_t connectionId, uint32_t requestId,
+                       const HandlerResponse& response);
+};
+
+} // namespace rdws::server
@@ -0,0 +1,529 @@
+#include "service_runner.h"
+
+#include "../common/database/deadline.h"
+#include "../common/database/postgresql_connection_pool.h"
+#include "../common/database/postgresql_database.h"
+#include "../common/database/routing_database.h"
+#include "../common/database/statement_stats.h"
+#include "../common/utils/lambda_params_helper.h"
+#include "../common/utils/response_helper.h"
+#include "../common/utils/startup_profile.h"
+#include "../controllers/base_controller.h"
+#include "health_check.h"
+#include "http_server.h"
+#include "listener_handoff.h"
+#include "ndjson_server.h"
+#include "prefork_supervisor.h"
+#include "rpc_server.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <unistd.h>
+#include <utility>
+
+using rdws::controllers::BaseController;
+using rdws::types::LambdaContext;
+using rdws::types::LambdaEvent;
+using rdws::utils::StartupProfile;
+
+namespace rdws::server {
+
+constexpr auto serveFlag = "--serve";
+constexpr auto httpFlag = "--http";
+constexpr auto hostFlag = "--host";
+constexpr auto socketFlag = "--socket";
+constexpr auto workersFlag = "--workers";
+constexpr auto poolFlag = "--pool";
+constexpr auto preforkFlag = "--prefork";
+constexpr auto ioUringFlag = "--io-uring";
+constexpr auto asyncFlag = "--async";
+constexpr auto handoffFlag = "--handoff";
+constexpr size_t defaultAsyncConnections = 16;
+constexpr auto defaultHttpHost = "0.0.0.0";
+
+namespace {
+
+// Server stopped by SIGINT/SIGTERM; stop() only writes to an eventfd
+StreamServer* activeServer = nullptr;
+
+void stopActiveServer(int) {
+    if (activeServer != nullptr) {
+        activeServer->stop();
+    }
+}
+
+// Run the server until SIGINT/SIGTERM, restoring default signal handling afterwards
+// The executor is shut down while the server is still alive since completions post to it.
+void runUntilSignalled(StreamServer& server, RequestExecutor& executor) {
+    struct SignalScope {
+        RequestExecutor& executor;
+
+        SignalScope(StreamServer& target, RequestExecutor& requestExecutor)
+            : executor(requestExecutor) {
+            activeServer = &target;
+            std::signal(SIGINT, stopActiveServer);
+            std::signal(SIGTERM, stopActiveServer);
+        }
+        ~SignalScope() {
+            std::signal(SIGINT, SIG_DFL);
+            std::signal(SIGTERM, SIG_DFL);
+            activeServer = nullptr;
+            executor.shutdown();
+        }
+        SignalScope(const SignalScope&) = delete;
+        SignalScope& operator=(const SignalScope&) = delete;
+    } scope(server, executor);
+
+    server.run();
+}
+
+// Value following a flag, or nullptr when the flag is absent
+const char* optionValue(const int argc, char* argv[], const char* flag) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], flag) == 0) {
+            return argv[i + 1];
+        }
+    }
+    return nullptr;
+}
+
+bool hasFlag(const int argc, char* argv[], const char* flag) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], flag) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+IoBackend selectBackend(const int argc, char* argv[]) {
+    return hasFlag(argc, argv, ioUringFlag) ? IoBackend::IoUring : IoBackend::Epoll;
+}
+
+// Listener taken over from the process offering it at the --handoff path, else a new one
+int acquireListener(const char* handoffPath, const std::function<int()>& bindListener,
+                    const LambdaContext& processContext) {
+    if (handoffPath != nullptr) {
+        if (const int listener = ListenerHandoff::takeOver(handoffPath); listener >= 0) {
+            processContext.log(std::string("Took over the listener offered at ") + handoffPath,
+                               "INFO");
+            return listener;
+        }
+    }
+    return bindListener();
+}
+
+// Offer the listener to the next deploy; the server drains once a successor holds it
+std::unique_ptr<ListenerHandoff> offerListener(const char* handoffPath, const int listener,
+                                               StreamServer& server,
+                                               const LambdaContext& processContext) {
+    if (handoffPath == nullptr) {
+        return nullptr;
+    }
+    return std::make_unique<ListenerHandoff>(handoffPath, listener, [&server, &processContext] {
+        processContext.log("Listener handed over, draining in-flight requests", "INFO");
+        server.drain();
+    });
+}
+
+} // namespace
+
+ServiceRunner::ServiceRunner(std::string name, HandlerFactory factory)
+    : serviceName(std::move(name)), handlerFactory(std::move(factory)) {}
+
+void ServiceRunner::setAsyncExecutorFactory(AsyncExecutorFactory factory) {
+    asyncExecutorFactory = std::move(factory);
+}
+
+int ServiceRunner::run(const int argc, char* argv[]) {
+    if (argc >= 2 && std::strcmp(argv[1], serveFlag) == 0) {
+        return runServeLoop();
+    }
+    if (argc >= 2 && std::strcmp(argv[1], httpFlag) == 0) {
+        return runHttpServer(argc, argv);
+    }
+    if (argc >= 2 && std::strcmp(argv[1], socketFlag) == 0) {
+        return runSocketServer(argc, argv);
+    }
+    return runSingleRequest(argc, argv);
+}
+
+int ServiceRunner::runSingleRequest(const int argc, char* argv[]) {
+    // Startup is request latency here: phases are timed with RDWS_STARTUP_PROFILE=1
+    auto& profile = rdws::utils::StartupProfile::process();
+    profile.recordExecToMain();
+
+    try {
+        if (const auto checkParameters = rdws::utils::LambdaParamsHelper::checkParams(argc, argv);
+            !checkParameters.has_value()) {
+            std::cerr << BaseController::formatUsageError(checkParameters.error()) << std::endl;
+            return 1;
+        }
+
+        std::optional<LambdaEvent> event;
+        std::optional<LambdaContext> context;
+        {
+            const StartupProfile::Scope scope("parse");
+            const rdws::utils::LambdaParams params{.eventJson = argv[1], .contextJson = argv[2]};
+            event.emplace(LambdaEvent::fromJson(params.eventJson));
+            context.emplace(LambdaContext::fromJson(params.contextJson));
+        }
+
+        context->log("Function started", "INFO");
+
+        std::optional<rdws::Config> config;
+        {
+            const StartupProfile::Scope scope("config");
+            config.emplace();
+        }
+
+        // Initialize database connection
+        std::shared_ptr<rdws::database::PostgreSQLDatabase> db;
+        {
+            const StartupProfile::Scope scope("connect");
+            db = std::make_shared<rdws::database::PostgreSQLDatabase>(*config);
+        }
+        if (!db->isConnected()) {
+            context->log("Failed to connect to database", "ERROR");
+            std::cerr << BaseController::formatDatabaseError() << std::endl;
+            return 1;
+        }
+
+        std::unique_ptr<RequestHandler> handler;
+        {
+            const StartupProfile::Scope scope("handler");
+            handler = handlerFactory(db);
+        }
+
+        HandlerResponse response;
+        {
+            // Lazily built validators are reported as "schema" rather than "handle"
+            const StartupProfile::Scope scope("handle");
+            // Statements get the remaining budget as statement_timeout. The gateway passes its
+            // SERVICE_TIMEOUT less a margin, so they stop before it gives up on this process
+            const rdws::database::DeadlineScope deadline(context->getRemainingTimeMs());
+            response =
+                isHealthCheck(*event) ? healthResponse() : handler->handle(*event, *context);
+            if (deadline.wasExceeded()) {
+                response = deadlineExceededResponse(*context);
+            }
+        }
+        std::cout << response.body << std::endl;
+
+        if (profile.isEnabled()) {
+            context->log("Startup profile: " + profile.summary(), "INFO");
+        }
+        return response.exitCode;
+    } catch (const std::exception& e) {
+        std::cerr << BaseController::formatServiceError(e.what()) << std::endl;
+        return 1;
+    }
+}
+
+std::unique_ptr<RequestHandler>
+ServiceRunner::createSharedHandler(const LambdaContext& processContext) const {
+    // Config, database connection and validators are created once and reused by every request
+    std::shared_ptr<rdws::database::IDatabase> db;
+    if (connectionPool) {
+        db = std::make_shared<rdws::database::PooledDatabase>(connectionPool);
+    } else {
+        db = std::make_shared<rdws::database::PostgreSQLDatabase>();
+    }
+    if (!db->isConnected()) {
+        processContext.log("Failed to connect to database", "ERROR");
+        std::cerr << BaseController::formatDatabaseError() << std::endl;
+        return nullptr;
+    }
+    if (replicaSet) {
+        db = std::make_shared<rdws::database::RoutingDatabase>(db, replicaSet);
+    }
+
+    // Prepared before the server accepts, so a restart does not hit the database cold
+    auto handler = handlerFactory(db);
+    handler->warmUp();
+    return handler;
+}
+
+std::unique_ptr<RequestExecutor>
+ServiceRunner::createExecutor(const LambdaContext& processContext, const int argc,
+                              char* argv[]) {
+    auto executor = createHandlerExecutor(processContext, argc, argv);
+    if (!executor) {
+        return nullptr;
+    }
+    return std::make_unique<HealthCheckExecutor>(std::move(executor));
+}
+
+std::unique_ptr<RequestExecutor>
+ServiceRunner::createHandlerExecutor(const LambdaContext& processContext, const int argc,
+                                     char* argv[]) {
+    if (const char* value = optionValue(argc, argv, asyncFlag); value != nullptr) {
+        if (!asyncExecutorFactory) {
+            processContext.log(serviceName + " has no async handlers", "ERROR");
+            return nullptr;
+        }
+        size_t connections = std::stoul(value);
+        if (connections == 0) {
+            connections = defaultAsyncConnections;
+        }
+        try {
+            auto executor = asyncExecutorFactory(connections);
+            processContext.log("Opened " + std::to_string(connections) + " async connections",
+                               "INFO");
+            return executor;
+        } catch (const std::runtime_error& e) {
+            processContext.log(e.what(), "ERROR");
+            std::cerr << BaseController::formatDatabaseError() << std::endl;
+            return nullptr;
+        }
+    }
+
+    size_t workers = 1;
+    if (const char* value = optionValue(argc, argv, workersFlag); value != nullptr) {
+        workers = WorkerPool::resolveWorkerCount(std::stoul(value));
+    }
+
+    // Workers lease connections from one pool instead of holding one each
+    if (const char* value = optionValue(argc, argv, poolFlag); value != nullptr) {
+        rdws::database::PostgreSQLConnectionPool::Options options;
+        const size_t size = std::stoul(value);
+        options.maxSize = size > 0 ? size : workers;
+        try {
+            connectionPool = std::make_shared<rdws::database::PostgreSQLConnectionPool>(
+                options, [] { return std::make_unique<rdws::database::PostgreSQLDatabase>(); });
+        } catch (const std::runtime_error& e) {
+            processContext.log(e.what(), "ERROR");
+            std::cerr << BaseController::formatDatabaseError() << std::endl;
+            return nullptr;
+        }
+        processContext.log("Connection pool of up to " + std::to_string(options.maxSize) +
+                               " connections",
+                           "INFO");
+    }
+
+    openReplicas(processContext, connectionPool ? connectionPool->getOptions().maxSize : workers);
+
+    if (workers == 1) {
+        auto handler = createSharedHandler(processContext);
+        if (!handler) {
+            return nullptr;
+        }
+        return std::make_unique<InlineExecutor>(std::move(handler));
+    }
+
+    // One connection and one set of services per worker thread
+    try {
+        auto pool = std::make_unique<WorkerPool>(
+            workers, [this, &processContext] { return createSharedHandler(processContext); });
+        processContext.log("Started " + std::to_string(workers) + " worker threads", "INFO");
+        return pool;
+    } catch (const std::runtime_error& e) {
+        processContext.log(e.what(), "ERROR");
+        return nullptr;
+    }
+}
+
+void ServiceRunner::openReplicas(const LambdaContext& processContext, const size_t poolSize) {
+    const rdws::Config config;
+    std::vector<rdws::database::ReplicaSet::Replica> replicas;
+    for (const auto& host : config.getReplicaHosts()) {
+        rdws::database::PostgreSQLConnectionPool::Options options;
+        options.maxSize = poolSize;
+        // A replica that is down now is skipped by the lag checks until it answers again
+        options.connectInBackground = true;
+        auto pool = std::make_shared<rdws::database::PostgreSQLConnectionPool>(
+            options, [replicaConfig = config.forReplica(host)] {
+                return std::make_unique<rdws::database::PostgreSQLDatabase>(replicaConfig);
+            });
+        replicas.push_back({host, std::move(pool)});
+    }
+    if (replicas.empty()) {
+        return;
+    }
+
+    rdws::database::ReplicaSet::Options options;
+    options.maxLag = config.getReplicaMaxLag();
+    const size_t count = replicas.size();
+    replicaSet = std::make_shared<rdws::database::ReplicaSet>(std::move(replicas), options);
+    processContext.log("Reading from " + std::to_string(count) + " replica(s): " +
+                           replicaSet->describe(),
+                       "INFO");
+}
+
+void ServiceRunner::logDatabaseStats(const LambdaContext& processContext) const {
+    const auto statements = rdws::database::PostgreSQLDatabase::processStatementCacheStats();
+    processContext.log("Prepared statements: hits=" + std::to_string(statements.hits) +
+                           " misses=" + std::to_string(statements.misses),
+                       "INFO");
+    if (connectionPool) {
+        processContext.log("Connection pool: " + connectionPool->describe(), "INFO");
+    }
+    if (replicaSet) {
+        processContext.log("Replicas: " + replicaSet->describe(), "INFO");
+    }
+
+    // The statements that took the most database time; the rest are on GET /metrics
+    constexpr size_t loggedStatements = 5;
+    const auto statementStats = rdws::database::StatementMetrics::snapshot();
+    for (size_t i = 0; i < std::min(loggedStatements, statementStats.size()); ++i) {
+        const auto& statement = statementStats[i];
+        processContext.log("Statement: calls=" + std::to_string(statement.calls) +
+                               " totalMs=" + std::to_string(statement.totalMicros / 1000) +
+                               " p50Us=" + std::to_string(statement.p50Micros) +
+                               " p99Us=" + std::to_string(statement.p99Micros) +
+                               " errors=" + std::to_string(statement.errors) + " " +
+                               statement.fingerprint,
+                           "INFO");
+    }
+}
+
+int ServiceRunner::runServeLoop() {
+    const LambdaContext processContext("serve", serviceName);
+
+    try {
+        const auto handler = createSharedHandler(processContext);
+        if (!handler) {
+            return 1;
+        }
+
+        std::ios::sync_with_stdio(false);
+        processContext.log("Serving NDJSON frames on stdin", "INFO");
+
+        NdjsonServer server(*handler);
+        const auto served = server.run(std::cin, std::cout);
+
+        processContext.log("Input closed after " + std::to_string(served) + " request(s)", "INFO");
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << BaseController::formatServiceError(e.what()) << std::endl;
+        return 1;
+    }
+}
+
+int ServiceRunner::runHttpServer(const int argc, char* argv[]) {
+    const LambdaContext processContext("http", serviceName);
+
+    const char* hostValue = optionValue(argc, argv, hostFlag);
+    const std::string host = hostValue != nullptr ? hostValue : defaultHttpHost;
+    int port = -1;
+    if (const char* portValue = optionValue(argc, argv, httpFlag); portValue != nullptr) {
+        try {
+            port = std::stoi(portValue);
+        } catch (const std::exception&) {
+            port = -1;
+        }
+    }
+    if (port <= 0 || port > 65535) {
+        std::cerr << BaseController::formatError("Usage: " + serviceName +
+                                                     " --http <port> [--host <address>]"
+                                                     " [--workers <n>] [--pool <n>]"
+                                                     " [--prefork <n>] [--io-uring]"
+                                                     " [--handoff <path>]",
+                                                 400)
+                  << std::endl;
+        return 1;
+    }
+
+    const char* preforkValue = optionValue(argc, argv, preforkFlag);
+    if (preforkValue != nullptr && optionValue(argc, argv, handoffFlag) != nullptr) {
+        std::cerr << BaseController::formatError("--handoff cannot be combined with --prefork",
+                                                 400)
+                  << std::endl;
+        return 1;
+    }
+    if (preforkValue == nullptr) {
+        return serveHttp(host, static_cast<uint16_t>(port), false, argc, argv);
+    }
+
+    try {
+        // Every worker process binds the port itself and opens its own database connection
+        const size_t processes = WorkerPool::resolveWorkerCount(std::stoul(preforkValue));
+        PreforkSupervisor supervisor(
+            processes,
+            [this, &host, port, argc, argv](size_t) {
+                return serveHttp(host, static_cast<uint16_t>(port), true, argc, argv);
+            },
+            processContext);
+        return supervisor.run();
+    } catch (const std::exception& e) {
+        std::cerr << BaseController::formatServiceError(e.what()) << std::endl;
+        return 1;
+    }
+}
+
+int ServiceRunner::serveHttp(const std::string& host, const uint16_t port, const bool reusePort,
+                             const int argc, char* argv[]) {
+    const LambdaContext processContext("http", serviceName);
+
+    try {
+        const auto executor = createExecutor(processContext, argc, argv);
+        if (!executor) {
+            return 1;
+        }
+
+        // The executor (connections, warmed caches) is ready before the listener is taken over
+        const char* handoffPath = optionValue(argc, argv, handoffFlag);
+        const int listener = acquireListener(
+            handoffPath, [&] { return StreamServer::listenTcp(host, port, reusePort); },
+            processContext);
+        // Nothing in front of the service passes a deadline, so SERVICE_TIMEOUT is used as is
+        HttpServer server(listener, *executor, serviceName, rdws::Config().getRequestTimeout(),
+                          selectBackend(argc, argv));
+        const auto handoff = offerListener(handoffPath, listener, server, processContext);
+
+        processContext.log("Listening on " + host + ":" + std::to_string(port), "INFO");
+        runUntilSignalled(server, *executor);
+
+        logDatabaseStats(processContext);
+        processContext.log("HTTP server stopped", "INFO");
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << BaseController::formatServiceError(e.what()) << std::endl;
+        return 1;
+    }
+}
+
+int ServiceRunner::runSocketServer(const int argc, char* argv[]) {
+    const LambdaContext processContext("rpc", serviceName);
+
+    const char* path = optionValue(argc, argv, socketFlag);
+    if (path == nullptr || *path == '\0') {
+        std::cerr << BaseController::formatError("Usage: " + serviceName + " --socket <path>", 400)
+                  << std::endl;
+        return 1;
+    }
+
+    try {
+        const auto executor = createExecutor(processContext, argc, argv);
+        if (!executor) {
+            return 1;
+        }
+
+        const char* handoffPath = optionValue(argc, argv, handoffFlag);
+        const int listener = acquireListener(
+            handoffPath, [path] { return StreamServer::listenUnix(path); }, processContext);
+        RpcServer server(listener, *executor, selectBackend(argc, argv));
+        const auto handoff = offerListener(handoffPath, listener, server, processContext);
+
+        processContext.log(std::string("Listening on unix:") + path, "INFO");
+        runUntilSignalled(server, *executor);
+        // After a handoff the socket file is served by the successor
+        if (!handoff || !handoff->wasHandedOff()) {
+            ::unlink(path);
+        }
+
+        logDatabaseStats(processContext);
+        processContext.log("RPC server stopped", "INFO");
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << BaseController::formatServiceError(e.what()) << std::endl;
+        return 1;
+    }
+}
+
+} // namespace rdws::server
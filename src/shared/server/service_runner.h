@@ -0,0 +1,106 @@
+#pragma once
+
+#include "../common/database/idatabase.h"
+#include "../common/database/postgresql_connection_pool.h"
+#include "../common/database/routing_database.h"
+#include "request_executor.h"
+#include "request_handler.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace rdws::server {
+
+/**
+ * ServiceRunner - Entry point shared by the service executables
+ *
+ * Modes:
+ *   <service> '<event json>' '<context json>'   one request per process (default)
+ *   <service> --serve                           persistent NDJSON worker on stdin/stdout
+ *   <service> --http <port> [--host <address>]  embedded HTTP/1.1 server (epoll, keep-alive)
+ *             [--prefork <n>]                   ... in n worker processes sharing the port
+ *   <service> --socket <path>                   length-prefixed RPC on a Unix domain socket
+ *
+ * The network modes accept --workers <n> to run handlers on a thread pool, each worker
+ * with its own database connection (0 = one per hardware thread, default 1 = inline),
+ * or with --pool <n> leasing connections from one pool of up to n (0 = one per worker),
+ * and --io-uring to drive their sockets with io_uring instead of epoll. With DB_REPLICA_HOSTS
+ * set they read from those replicas and write to DB_HOST. Services that register
+ * an async executor factory also accept --async <n>: coroutine handlers on one loop thread
+ * sharing n non-blocking connections (0 = default of 16). Whichever executor runs, GET /health
+ * reports the database circuit breakers of the process (503 while one is not closed).
+ *
+ * --http and --socket also take --handoff <path> for restarts without refused connections:
+ * a new process started with the same path warms up, takes the listening socket over from
+ * the running one, which then drains its in-flight requests and exits.
+ */
+class ServiceRunner {
+  public:
+    using HandlerFactory =
+        std::function<std::unique_ptr<RequestHandler>(std::shared_ptr<rdws::database::IDatabase>)>;
+    // Builds the --async executor over the given number of database connections
+    using AsyncExecutorFactory = std::function<std::unique_ptr<RequestExecutor>(size_t)>;
+
+  private:
+    std::string serviceName;
+    HandlerFactory handlerFactory;
+    AsyncExecutorFactory asyncExecutorFactory;
+    // Set by --pool; shared by the handlers of every worker
+    std::shared_ptr<rdws::database::PostgreSQLConnectionPool> connectionPool;
+    // Set when DB_REPLICA_HOSTS lists replicas; reads of every worker are spread over them
+    std::shared_ptr<rdws::database::ReplicaSet> replicaSet;
+
+  public:
+    ServiceRunner(std::string name, HandlerFactory factory);
+
+    /**
+     * Enable --async for this service (the coroutine handlers live outside the shared library)
+     */
+    void setAsyncExecutorFactory(AsyncExecutorFactory factory);
+
+    /**
+     * Run the service with the process arguments
+     * @return Process exit code
+     */
+    int run(int argc, char* argv[]);
+
+  private:
+    /**
+     * Connect to the database and build the handler reused by the long-lived modes
+     * @return nullptr when the database is unavailable (already reported)
+     */
+    std::unique_ptr<RequestHandler>
+    createSharedHandler(const rdws::types::LambdaContext& processContext) const;
+
+    /**
+     * Build the executor of the network modes from the --async or --workers option,
+     * answering GET /health ahead of it
+     * @return nullptr when a database connection is unavailable (already reported)
+     */
+    std::unique_ptr<RequestExecutor>
+    createExecutor(const rdws::types::LambdaContext& processContext, int argc, char* argv[]);
+
+    std::unique_ptr<RequestExecutor>
+    createHandlerExecutor(const rdws::types::LambdaContext& processContext, int argc,
+                          char* argv[]);
+
+    /**
+     * Open a connection pool per replica of DB_REPLICA_HOSTS; unreachable ones are left out
+     */
+    void openReplicas(const rdws::types::LambdaContext& processContext, size_t poolSize);
+
+    /**
+     * Log the prepared statement cache, connection pool and replica counters of the process,
+     * and the statements that took the most database time
+     */
+    void logDatabaseStats(const rdws::types::LambdaContext& processContext) const;
+
+    int runSingleRequest(int argc, char* argv[]);
+    int runServeLoop();
+    int runHttpServer(int argc, char* argv[]);
+    int serveHttp(const std::string& host, uint16_t port, bool reusePort, int argc, char* argv[]);
+    int runSocketServer(int argc, char* argv[]);
+};
+
+} // namespace rdws::server
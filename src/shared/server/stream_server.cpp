@@ -0,0 +1,506 @@
+#include "stream_server.h"
+
+#include "uring_loop.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+namespace rdws::server {
+
+namespace {
+
+constexpr int maxEvents = 256;
+constexpr size_t readChunkSize = 64 * 1024;
+
+std::runtime_error systemError(const std::string& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+std::string describePeer(const sockaddr_storage& address) {
+    char text[INET6_ADDRSTRLEN] = {};
+    if (address.ss_family == AF_INET) {
+        const auto* ipv4 = reinterpret_cast<const sockaddr_in*>(&address);
+        inet_ntop(AF_INET, &ipv4->sin_addr, text, sizeof(text));
+    } else if (address.ss_family == AF_INET6) {
+        const auto* ipv6 = reinterpret_cast<const sockaddr_in6*>(&address);
+        inet_ntop(AF_INET6, &ipv6->sin6_addr, text, sizeof(text));
+    } else {
+        return "local";
+    }
+    return text;
+}
+
+} // namespace
+
+StreamServer::StreamServer(const int listeningSocket, const IoBackend backend)
+    : listenFd(listeningSocket) {
+    if (backend == IoBackend::IoUring) {
+        // Both are read through the ring, where non-blocking files complete with EAGAIN
+        // instead of waiting in the kernel
+        wakeFd = eventfd(0, EFD_CLOEXEC);
+        if (wakeFd < 0) {
+            throw systemError("eventfd failed");
+        }
+        if (const int flags = fcntl(listenFd, F_GETFL);
+            flags < 0 || fcntl(listenFd, F_SETFL, flags & ~O_NONBLOCK) < 0) {
+            throw systemError("fcntl failed");
+        }
+        uring = std::make_unique<UringLoop>(*this);
+        return;
+    }
+
+    // A listener handed over by an io_uring process arrives in blocking mode
+    if (const int flags = fcntl(listenFd, F_GETFL);
+        flags < 0 || fcntl(listenFd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        throw systemError("fcntl failed");
+    }
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        throw systemError("epoll_create1 failed");
+    }
+
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd < 0) {
+        throw systemError("eventfd failed");
+    }
+
+    for (const int fd : {listenFd, wakeFd}) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            throw systemError("epoll_ctl failed");
+        }
+    }
+}
+
+StreamServer::~StreamServer() {
+    for (const auto& [fd, connection] : connections) {
+        ::close(fd);
+    }
+    connections.clear();
+
+    for (const int fd : {listenFd, wakeFd, epollFd}) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+bool StreamServer::ioUringAvailable() {
+    return UringLoop::available();
+}
+
+void StreamServer::run() {
+    running = true;
+    loopThread = std::this_thread::get_id();
+    if (uring) {
+        uring->run();
+        return;
+    }
+
+    epoll_event events[maxEvents];
+    auto lastSweep = std::chrono::steady_clock::now();
+
+    while (running) {
+        const int count = epoll_wait(epollFd, events, maxEvents, 1000);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw systemError("epoll_wait failed");
+        }
+
+        for (int i = 0; i < count; ++i) {
+            const int fd = events[i].data.fd;
+            const uint32_t flags = events[i].events;
+
+            if (fd == wakeFd) {
+                uint64_t value = 0;
+                [[maybe_unused]] const auto drained = ::read(wakeFd, &value, sizeof(value));
+                handleWake();
+                continue;
+            }
+            if (fd == listenFd) {
+                acceptConnections();
+                continue;
+            }
+
+            const auto it = connections.find(fd);
+            if (it == connections.end()) {
+                continue;
+            }
+            Connection& connection = *it->second;
+
+            if ((flags & (EPOLLERR | EPOLLHUP)) && !(flags & EPOLLIN)) {
+                closeConnection(fd);
+                continue;
+            }
+            if (flags & EPOLLIN) {
+                readConnection(connection);
+                if (connections.find(fd) == connections.end()) {
+                    continue;
+                }
+            }
+            if (flags & EPOLLOUT) {
+                flushConnection(connection);
+            }
+        }
+
+        runPostedTasks();
+
+        if (const auto now = std::chrono::steady_clock::now();
+            now - lastSweep >= std::chrono::seconds(1)) {
+            lastSweep = now;
+            closeIdleConnections();
+        }
+        if (draining && connections.empty()) {
+            running = false;
+        }
+    }
+}
+
+void StreamServer::stop() {
+    stopRequested.store(true);
+    const uint64_t one = 1;
+    [[maybe_unused]] const auto written = ::write(wakeFd, &one, sizeof(one));
+}
+
+void StreamServer::drain() {
+    drainRequested.store(true);
+    const uint64_t one = 1;
+    [[maybe_unused]] const auto written = ::write(wakeFd, &one, sizeof(one));
+}
+
+void StreamServer::handleWake() {
+    if (stopRequested.load()) {
+        running = false;
+    } else if (drainRequested.load() && !draining) {
+        beginDrain();
+    }
+}
+
+void StreamServer::beginDrain() {
+    draining = true;
+    if (uring) {
+        uring->stopAccepting();
+    } else {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, listenFd, nullptr);
+    }
+
+    // Busy connections are closed by flushConnection once isDone() holds
+    std::vector<int> idle;
+    for (const auto& [fd, connection] : connections) {
+        if (isDone(*connection)) {
+            idle.push_back(fd);
+        }
+    }
+    for (const int fd : idle) {
+        closeConnection(fd);
+    }
+}
+
+void StreamServer::post(std::function<void()> task) {
+    if (std::this_thread::get_id() == loopThread) {
+        deferred.push_back(std::move(task));
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(postedMutex);
+        posted.push_back(std::move(task));
+    }
+    const uint64_t one = 1;
+    [[maybe_unused]] const auto written = ::write(wakeFd, &one, sizeof(one));
+}
+
+void StreamServer::runPostedTasks() {
+    std::vector<std::function<void()>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(postedMutex);
+        tasks.swap(posted);
+    }
+    for (auto& task : tasks) {
+        task();
+    }
+
+    // Tasks may defer further work (e.g. the next pipelined request of a connection)
+    while (!deferred.empty()) {
+        tasks.clear();
+        tasks.swap(deferred);
+        for (auto& task : tasks) {
+            task();
+        }
+    }
+}
+
+StreamServer::Connection* StreamServer::findConnection(const int fd, const uint64_t id) {
+    const auto it = connections.find(fd);
+    if (it == connections.end() || it->second->id != id) {
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+int StreamServer::listenTcp(const std::string& host, const uint16_t port, const bool reusePort,
+                            const int backlog) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+
+    addrinfo* addresses = nullptr;
+    const std::string service = std::to_string(port);
+    if (const int rc = getaddrinfo(host.empty() ? nullptr : host.c_str(), service.c_str(), &hints,
+                                   &addresses);
+        rc != 0) {
+        throw std::runtime_error("Cannot resolve listen address " + host + ": " +
+                                 gai_strerror(rc));
+    }
+
+    int fd = -1;
+    std::string lastError = "no usable address";
+    for (const addrinfo* address = addresses; address != nullptr; address = address->ai_next) {
+        fd = socket(address->ai_family, address->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                    address->ai_protocol);
+        if (fd < 0) {
+            lastError = std::strerror(errno);
+            continue;
+        }
+
+        const int enable = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+        if (reusePort && setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0) {
+            lastError = std::string("SO_REUSEPORT: ") + std::strerror(errno);
+            ::close(fd);
+            fd = -1;
+            continue;
+        }
+
+        if (bind(fd, address->ai_addr, address->ai_addrlen) == 0 && listen(fd, backlog) == 0) {
+            break;
+        }
+        lastError = std::strerror(errno);
+        ::close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(addresses);
+
+    if (fd < 0) {
+        throw std::runtime_error("Cannot listen on " + host + ":" + service + ": " + lastError);
+    }
+    return fd;
+}
+
+int StreamServer::listenUnix(const std::string& path, const int backlog) {
+    sockaddr_un address{};
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Invalid Unix socket path: " + path);
+    }
+    address.sun_family = AF_UNIX;
+    path.copy(address.sun_path, path.size());
+
+    // A previous process may have left its socket file behind
+    struct stat existing {};
+    if (::lstat(path.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode)) {
+        ::unlink(path.c_str());
+    }
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw systemError("socket failed");
+    }
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(fd, backlog) < 0) {
+        const auto error = systemError("Cannot listen on " + path);
+        ::close(fd);
+        throw error;
+    }
+    return fd;
+}
+
+void StreamServer::acceptConnections() {
+    while (true) {
+        sockaddr_storage address{};
+        socklen_t length = sizeof(address);
+        const int fd = accept4(listenFd, reinterpret_cast<sockaddr*>(&address), &length,
+                               SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            // EAGAIN: backlog drained; EMFILE and friends: retry on the next readiness event
+            return;
+        }
+        addConnection(fd, address);
+    }
+}
+
+void StreamServer::addConnection(const int fd, const sockaddr_storage& address) {
+    if (address.ss_family == AF_INET || address.ss_family == AF_INET6) {
+        const int enable = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    }
+
+    auto connection = std::make_unique<Connection>();
+    connection->fd = fd;
+    connection->id = nextConnectionId++;
+    connection->peer = describePeer(address);
+    connection->lastActivity = std::chrono::steady_clock::now();
+
+    if (uring) {
+        uring->startReceiving(*connections.emplace(fd, std::move(connection)).first->second);
+        return;
+    }
+
+    connection->registeredEvents = EPOLLIN;
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+        ::close(fd);
+        return;
+    }
+    connections.emplace(fd, std::move(connection));
+}
+
+void StreamServer::readConnection(Connection& connection) {
+    const int fd = connection.fd;
+    char buffer[readChunkSize];
+    bool peerClosed = false;
+
+    while (true) {
+        const ssize_t received = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            if (!connection.closeAfterWrite && !connection.peerClosed) {
+                connection.input.append(buffer, static_cast<size_t>(received));
+            }
+            continue;
+        }
+        if (received == 0) {
+            peerClosed = true;
+            break;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        closeConnection(fd);
+        return;
+    }
+
+    consumeInput(connection, peerClosed);
+}
+
+void StreamServer::consumeInput(Connection& connection, const bool peerClosed) {
+    connection.lastActivity = std::chrono::steady_clock::now();
+    if (!connection.closeAfterWrite && !connection.input.empty()) {
+        onData(connection);
+    }
+    if (peerClosed) {
+        // Answer what was already received, then close
+        connection.peerClosed = true;
+    }
+    flushConnection(connection);
+}
+
+bool StreamServer::isDone(const Connection& connection) const {
+    return connection.output.empty() && connection.pendingResponses == 0 &&
+           (!uring || !uring->sending(connection)) &&
+           (connection.closeAfterWrite || connection.peerClosed || draining);
+}
+
+void StreamServer::flushConnection(Connection& connection) {
+    if (uring) {
+        uring->flush(connection);
+        return;
+    }
+
+    const int fd = connection.fd;
+    size_t sent = 0;
+
+    while (sent < connection.output.size()) {
+        const ssize_t written = ::send(fd, connection.output.data() + sent,
+                                       connection.output.size() - sent, MSG_NOSIGNAL);
+        if (written > 0) {
+            sent += static_cast<size_t>(written);
+            continue;
+        }
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        closeConnection(fd);
+        return;
+    }
+    connection.output.erase(0, sent);
+
+    if (isDone(connection)) {
+        closeConnection(fd);
+        return;
+    }
+    updateInterest(connection);
+}
+
+void StreamServer::closeConnection(const int fd) {
+    if (!uring) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    } else if (const auto it = connections.find(fd); it != connections.end()) {
+        uring->release(*it->second);
+    }
+    ::close(fd);
+    connections.erase(fd);
+}
+
+void StreamServer::updateInterest(Connection& connection) const {
+    uint32_t events = connection.closeAfterWrite || connection.peerClosed
+                          ? 0u
+                          : static_cast<uint32_t>(EPOLLIN);
+    if (!connection.output.empty()) {
+        events |= EPOLLOUT;
+    }
+    if (events == connection.registeredEvents) {
+        return;
+    }
+
+    epoll_event event{};
+    event.events = events;
+    event.data.fd = connection.fd;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+    connection.registeredEvents = events;
+}
+
+void StreamServer::closeIdleConnections() {
+    const auto deadline = std::chrono::steady_clock::now() - idleTimeout;
+
+    std::vector<int> idle;
+    for (const auto& [fd, connection] : connections) {
+        if (connection->lastActivity < deadline && connection->output.empty() &&
+            connection->pendingResponses == 0 && (!uring || !uring->sending(*connection))) {
+            idle.push_back(fd);
+        }
+    }
+    for (const int fd : idle) {
+        closeConnection(fd);
+    }
+}
+
+} // namespace rdws::server
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct sockaddr_storage;
+
+namespace rdws::server {
+
+/**
+ * How a StreamServer waits for socket I/O
+ *   Epoll    readiness notifications, non-blocking recv/send
+ *   IoUring  batched accept/recv/send submissions into registered buffers
+ *            (needs a build with RDWS_ENABLE_IO_URING and kernel support)
+ */
+enum class IoBackend { Epoll, IoUring };
+
+/**
+ * StreamServer - Single-threaded event loop over a listening stream socket
+ *
+ * Owns accepted connections and their buffers; protocol subclasses only
+ * consume bytes from Connection::input and append replies to Connection::output.
+ * Replies produced on other threads are handed back to the loop with post().
+ */
+class StreamServer {
+  public:
+    struct Connection {
+        int fd = -1;
+        uint64_t id = 0;  // unique for the server lifetime, unlike fd
+        std::string peer;
+        std::string input;
+        std::string output;
+        size_t pendingResponses = 0;  // requests handed to an executor and not answered yet
+        bool closeAfterWrite = false;
+        bool peerClosed = false;
+        uint32_t registeredEvents = 0;
+        std::chrono::steady_clock::time_point lastActivity;
+    };
+
+  private:
+    class UringLoop;
+
+    int listenFd;
+    int epollFd = -1;
+    int wakeFd = -1;
+    bool running = false;
+    bool draining = false;
+    std::atomic<bool> stopRequested{false};
+    std::atomic<bool> drainRequested{false};
+    std::thread::id loopThread;
+    uint64_t nextConnectionId = 1;
+    std::chrono::seconds idleTimeout{60};
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+    std::unique_ptr<UringLoop> uring;  // set when running on the io_uring backend
+
+    std::mutex postedMutex;
+    std::vector<std::function<void()>> posted;    // from other threads, guarded by postedMutex
+    std::vector<std::function<void()>> deferred;  // from the loop thread itself
+
+  public:
+    /**
+     * @param listeningSocket Bound and listening socket; ownership is transferred
+     * @param backend I/O backend driving the loop
+     * @throws std::runtime_error when the backend cannot be set up
+     */
+    explicit StreamServer(int listeningSocket, IoBackend backend = IoBackend::Epoll);
+    virtual ~StreamServer();
+
+    StreamServer(const StreamServer&) = delete;
+    StreamServer& operator=(const StreamServer&) = delete;
+
+    /**
+     * Serve connections until stop() is called
+     */
+    void run();
+
+    /**
+     * Ask the loop to exit; safe to call from a signal handler
+     */
+    void stop();
+
+    /**
+     * Stop accepting, answer the requests already received, then exit the loop
+     * Idle connections are closed right away, busy ones after their last response.
+     * Safe to call from any thread.
+     */
+    void drain();
+
+    /**
+     * Run a task on the loop thread
+     * Thread-safe; tasks posted from the loop thread run after the current event is handled.
+     */
+    void post(std::function<void()> task);
+
+    void setIdleTimeout(std::chrono::seconds timeout) {
+        idleTimeout = timeout;
+    }
+
+    [[nodiscard]] size_t getConnectionCount() const {
+        return connections.size();
+    }
+
+    /**
+     * Whether IoBackend::IoUring is compiled in and supported by the running kernel
+     */
+    static bool ioUringAvailable();
+
+    /**
+     * Create a non-blocking TCP listening socket
+     * @param reusePort Set SO_REUSEPORT so several processes can bind the same port
+     * @throws std::runtime_error on failure
+     */
+    static int listenTcp(const std::string& host, uint16_t port, bool reusePort = false,
+                         int backlog = 1024);
+
+    /**
+     * Create a non-blocking Unix domain listening socket, replacing a stale socket file
+     * @throws std::runtime_error on failure
+     */
+    static int listenUnix(const std::string& path, int backlog = 1024);
+
+  protected:
+    /**
+     * Consume buffered input of a connection
+     * Implementations erase what they used from input and append replies to output.
+     */
+    virtual void onData(Connection& connection) = 0;
+
+    /**
+     * Find a live connection; nullptr when it was closed in the meantime
+     */
+    Connection* findConnection(int fd, uint64_t id);
+
+    /**
+     * Write pending output; closes the connection once it is done with
+     */
+    void flushConnection(Connection& connection);
+
+    [[nodiscard]] bool isDraining() const {
+        return draining;
+    }
+
+  private:
+    void acceptConnections();
+    void addConnection(int fd, const sockaddr_storage& address);
+    void readConnection(Connection& connection);
+    void consumeInput(Connection& connection, bool peerClosed);
+    [[nodiscard]] bool isDone(const Connection& connection) const;
+    void handleWake();
+    void beginDrain();
+    void runPostedTasks();
+    void closeConnection(int fd);
+    void updateInterest(Connection& connection) const;
+    void closeIdleConnections();
+};
+
+} // namespace rdws::server
@@ -0,0 +1,380 @@
+#include "uring_loop.h"
+
+#include <stdexcept>
+#include <string>
+
+#ifdef RDWS_HAVE_IO_URING
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace rdws::server {
+
+namespace {
+
+constexpr unsigned ringEntries = 1024;
+constexpr unsigned maxCompletions = 256;
+constexpr size_t slotSize = 16 * 1024;
+constexpr size_t slotCount = 512;
+
+// user_data carries the operation in the low bits and the connection id above them
+enum class Operation : uint64_t { Accept = 1, Wake = 2, Receive = 3, Send = 4, Cancel = 5 };
+constexpr unsigned operationBits = 3;
+constexpr uint64_t operationMask = (uint64_t{1} << operationBits) - 1;
+
+uint64_t encode(const Operation operation, const uint64_t connectionId) {
+    return connectionId << operationBits | static_cast<uint64_t>(operation);
+}
+
+std::runtime_error uringError(const std::string& what, const int result) {
+    return std::runtime_error(what + ": " + std::strerror(-result));
+}
+
+} // namespace
+
+StreamServer::UringLoop::UringLoop(StreamServer& owner) : server(owner) {
+    if (const int result = io_uring_queue_init(ringEntries, &ring, 0); result < 0) {
+        throw uringError("io_uring_queue_init failed", result);
+    }
+
+    // Pinning counts against RLIMIT_MEMLOCK; without it every buffer comes from the heap
+    arena = std::make_unique<char[]>(slotCount * slotSize);
+    std::vector<iovec> buffers(slotCount);
+    for (size_t i = 0; i < slotCount; ++i) {
+        buffers[i].iov_base = arena.get() + i * slotSize;
+        buffers[i].iov_len = slotSize;
+    }
+    if (io_uring_register_buffers(&ring, buffers.data(), slotCount) < 0) {
+        arena.reset();
+        return;
+    }
+    for (size_t i = slotCount; i-- > 0;) {
+        freeSlots.push_back(static_cast<int>(i));
+    }
+}
+
+StreamServer::UringLoop::~UringLoop() {
+    io_uring_queue_exit(&ring);
+}
+
+bool StreamServer::UringLoop::available() {
+    io_uring probe{};
+    if (io_uring_queue_init(2, &probe, 0) < 0) {
+        return false;
+    }
+    io_uring_queue_exit(&probe);
+    return true;
+}
+
+void StreamServer::UringLoop::run() {
+    armAccept();
+    armWake();
+    auto lastSweep = std::chrono::steady_clock::now();
+
+    io_uring_cqe* batch[maxCompletions];
+    std::vector<std::pair<uint64_t, int>> completed;
+    completed.reserve(maxCompletions);
+
+    while (server.running) {
+        // One io_uring_enter submits everything queued by the previous batch and waits
+        __kernel_timespec timeout{};
+        timeout.tv_sec = 1;
+        io_uring_cqe* first = nullptr;
+        const int result = io_uring_submit_and_wait_timeout(&ring, &first, 1, &timeout, nullptr);
+        if (result < 0 && result != -ETIME && result != -EINTR) {
+            throw uringError("io_uring_submit_and_wait_timeout failed", result);
+        }
+
+        // Copy the completions out first: handling them queues new submissions
+        completed.clear();
+        const unsigned count = io_uring_peek_batch_cqe(&ring, batch, maxCompletions);
+        for (unsigned i = 0; i < count; ++i) {
+            completed.emplace_back(io_uring_cqe_get_data64(batch[i]), batch[i]->res);
+        }
+        io_uring_cq_advance(&ring, count);
+
+        for (const auto& [userData, completionResult] : completed) {
+            complete(userData, completionResult);
+        }
+
+        server.runPostedTasks();
+
+        if (const auto now = std::chrono::steady_clock::now();
+            now - lastSweep >= std::chrono::seconds(1)) {
+            lastSweep = now;
+            server.closeIdleConnections();
+        }
+        if (server.draining && server.connections.empty()) {
+            server.running = false;
+        }
+    }
+}
+
+void StreamServer::UringLoop::stopAccepting() {
+    io_uring_sqe* submission = nextSubmission();
+    io_uring_prep_cancel64(submission, encode(Operation::Accept, 0), 0);
+    io_uring_sqe_set_data64(submission, encode(Operation::Cancel, 0));
+}
+
+void StreamServer::UringLoop::startReceiving(Connection& connection) {
+    State& state = states[connection.id];
+    state.fd = connection.fd;
+    acquire(state.receive);
+    armReceive(connection.id, state);
+}
+
+void StreamServer::UringLoop::flush(Connection& connection) {
+    const auto it = states.find(connection.id);
+    if (it == states.end() || it->second.sending) {
+        return;
+    }
+    State& state = it->second;
+
+    if (state.sent == state.output.size()) {
+        if (connection.output.empty()) {
+            if (server.isDone(connection)) {
+                server.closeConnection(connection.fd);
+            }
+            return;
+        }
+        // Send the whole output from its own storage: swapping hands the connection the
+        // drained buffer (and its capacity) for replies queued while this send is in flight
+        state.output.clear();
+        state.output.swap(connection.output);
+        state.sent = 0;
+    }
+
+    // IORING_OP_SEND rather than WRITE_FIXED: only send() takes MSG_NOSIGNAL
+    io_uring_sqe* submission = nextSubmission();
+    io_uring_prep_send(submission, state.fd, state.output.data() + state.sent,
+                       state.output.size() - state.sent, MSG_NOSIGNAL);
+    io_uring_sqe_set_data64(submission, encode(Operation::Send, connection.id));
+    state.sending = true;
+}
+
+bool StreamServer::UringLoop::sending(const Connection& connection) const {
+    const auto it = states.find(connection.id);
+    return it != states.end() && it->second.sent < it->second.output.size();
+}
+
+void StreamServer::UringLoop::release(Connection& connection) {
+    const auto it = states.find(connection.id);
+    if (it == states.end()) {
+        return;
+    }
+
+    // Completes a pending receive, so its buffer comes back
+    ::shutdown(it->second.fd, SHUT_RDWR);
+    it->second.released = true;
+    if (!it->second.receiving && !it->second.sending) {
+        retire(connection.id);
+    }
+}
+
+io_uring_sqe* StreamServer::UringLoop::nextSubmission() {
+    io_uring_sqe* submission = io_uring_get_sqe(&ring);
+    if (submission == nullptr) {
+        io_uring_submit(&ring);
+        submission = io_uring_get_sqe(&ring);
+    }
+    if (submission == nullptr) {
+        throw std::runtime_error("io_uring submission queue is full");
+    }
+    return submission;
+}
+
+void StreamServer::UringLoop::armAccept() {
+    acceptAddressLength = sizeof(acceptAddress);
+    io_uring_sqe* submission = nextSubmission();
+    io_uring_prep_accept(submission, server.listenFd, reinterpret_cast<sockaddr*>(&acceptAddress),
+                         &acceptAddressLength, SOCK_CLOEXEC);
+    io_uring_sqe_set_data64(submission, encode(Operation::Accept, 0));
+}
+
+void StreamServer::UringLoop::armWake() {
+    io_uring_sqe* submission = nextSubmission();
+    io_uring_prep_read(submission, server.wakeFd, &wakeValue, sizeof(wakeValue), 0);
+    io_uring_sqe_set_data64(submission, encode(Operation::Wake, 0));
+}
+
+void StreamServer::UringLoop::armReceive(const uint64_t connectionId, State& state) {
+    io_uring_sqe* submission = nextSubmission();
+    if (state.receive.slot >= 0) {
+        io_uring_prep_read_fixed(submission, state.fd, state.receive.data, slotSize, 0,
+                                 state.receive.slot);
+    } else {
+        io_uring_prep_recv(submission, state.fd, state.receive.data, slotSize, 0);
+    }
+    io_uring_sqe_set_data64(submission, encode(Operation::Receive, connectionId));
+    state.receiving = true;
+}
+
+void StreamServer::UringLoop::complete(const uint64_t userData, const int result) {
+    const uint64_t connectionId = userData >> operationBits;
+
+    switch (static_cast<Operation>(userData & operationMask)) {
+    case Operation::Accept:
+        onAccepted(result);
+        break;
+    case Operation::Wake:
+        server.handleWake();
+        if (server.running) {
+            armWake();
+        }
+        break;
+    case Operation::Receive:
+        onReceived(connectionId, result);
+        break;
+    case Operation::Send:
+        onSent(connectionId, result);
+        break;
+    case Operation::Cancel:
+        break;
+    }
+}
+
+void StreamServer::UringLoop::onAccepted(const int result) {
+    // Accepted before the cancellation took effect: still served, then closed by the drain
+    if (result >= 0) {
+        server.addConnection(result, acceptAddress);
+    }
+    // Errors (EMFILE and friends) are retried with the next accept
+    if (!server.draining) {
+        armAccept();
+    }
+}
+
+void StreamServer::UringLoop::onReceived(const uint64_t connectionId, const int result) {
+    const auto it = states.find(connectionId);
+    if (it == states.end()) {
+        return;
+    }
+    State& state = it->second;
+    state.receiving = false;
+    if (state.released) {
+        if (!state.sending) {
+            retire(connectionId);
+        }
+        return;
+    }
+
+    const int fd = state.fd;
+    Connection* connection = server.findConnection(fd, connectionId);
+    if (connection == nullptr) {
+        return;
+    }
+    if (result == -EINTR || result == -EAGAIN) {
+        armReceive(connectionId, state);
+        return;
+    }
+    if (result < 0) {
+        server.closeConnection(fd);
+        return;
+    }
+
+    if (result > 0 && !connection->closeAfterWrite && !connection->peerClosed) {
+        connection->input.append(state.receive.data, static_cast<size_t>(result));
+    }
+    server.consumeInput(*connection, result == 0);
+
+    // The connection may have been closed while its input was handled
+    connection = server.findConnection(fd, connectionId);
+    if (connection != nullptr && !connection->closeAfterWrite && !connection->peerClosed) {
+        armReceive(connectionId, states.at(connectionId));
+    }
+}
+
+void StreamServer::UringLoop::onSent(const uint64_t connectionId, const int result) {
+    const auto it = states.find(connectionId);
+    if (it == states.end()) {
+        return;
+    }
+    State& state = it->second;
+    state.sending = false;
+    if (state.released) {
+        if (!state.receiving) {
+            retire(connectionId);
+        }
+        return;
+    }
+
+    Connection* connection = server.findConnection(state.fd, connectionId);
+    if (connection == nullptr) {
+        return;
+    }
+    if (result < 0 && result != -EINTR && result != -EAGAIN) {
+        server.closeConnection(state.fd);
+        return;
+    }
+
+    // A short send leaves the rest to the next submission; a long transfer is activity too
+    if (result > 0) {
+        state.sent += static_cast<size_t>(result);
+        connection->lastActivity = std::chrono::steady_clock::now();
+    }
+    flush(*connection);
+}
+
+void StreamServer::UringLoop::acquire(Buffer& buffer) {
+    if (buffer.data != nullptr) {
+        return;
+    }
+    if (!freeSlots.empty()) {
+        buffer.slot = freeSlots.back();
+        freeSlots.pop_back();
+        buffer.data = arena.get() + static_cast<size_t>(buffer.slot) * slotSize;
+        return;
+    }
+    buffer.heap = std::make_unique<char[]>(slotSize);
+    buffer.data = buffer.heap.get();
+}
+
+void StreamServer::UringLoop::retire(const uint64_t connectionId) {
+    const auto it = states.find(connectionId);
+    if (it == states.end()) {
+        return;
+    }
+    if (it->second.receive.slot >= 0) {
+        freeSlots.push_back(it->second.receive.slot);
+    }
+    states.erase(it);
+}
+
+} // namespace rdws::server
+
+#else
+
+namespace rdws::server {
+
+StreamServer::UringLoop::UringLoop(StreamServer&) {
+    throw std::runtime_error(
+        "io_uring backend is not compiled in (configure with -DRDWS_ENABLE_IO_URING=ON)");
+}
+
+StreamServer::UringLoop::~UringLoop() = default;
+
+bool StreamServer::UringLoop::available() {
+    return false;
+}
+
+void StreamServer::UringLoop::run() {}
+
+void StreamServer::UringLoop::stopAccepting() {}
+
+void StreamServer::UringLoop::startReceiving(Connection&) {}
+
+void StreamServer::UringLoop::flush(Connection&) {}
+
+bool StreamServer::UringLoop::sending(const Connection&) const {
+    return false;
+}
+
+void StreamServer::UringLoop::release(Connection&) {}
+
+} // namespace rdws::server
+
+#endif
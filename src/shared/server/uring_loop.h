@@ -0,0 +1,108 @@
+#pragma once
+
+#include "stream_server.h"
+
+#ifdef RDWS_HAVE_IO_URING
+#include <liburing.h>
+#include <sys/socket.h>
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace rdws::server {
+
+/**
+ * StreamServer::UringLoop - io_uring backend of StreamServer
+ *
+ * Keeps one accept, one eventfd read and per connection one receive and one send
+ * in flight. Everything queued while handling a batch of completions is submitted
+ * with a single io_uring_enter call. Receives land in registered buffers; when those
+ * run out (or cannot be pinned) plain heap buffers are used instead. A send hands the
+ * kernel all pending output of the connection at once, without copying it.
+ */
+class StreamServer::UringLoop {
+  public:
+    explicit UringLoop(StreamServer& owner);
+    ~UringLoop();
+
+    UringLoop(const UringLoop&) = delete;
+    UringLoop& operator=(const UringLoop&) = delete;
+
+    static bool available();
+
+    void run();
+
+    /**
+     * Cancel the pending accept; used when the server starts draining
+     */
+    void stopAccepting();
+
+    /**
+     * Start reading from a freshly accepted connection
+     */
+    void startReceiving(Connection& connection);
+
+    /**
+     * Queue pending output; closes the connection once it is done with
+     */
+    void flush(Connection& connection);
+
+    /**
+     * Whether output taken from the connection has not fully reached the kernel yet
+     */
+    [[nodiscard]] bool sending(const Connection& connection) const;
+
+    /**
+     * Forget a connection that is being closed; its buffers are reused once
+     * in-flight operations have completed
+     */
+    void release(Connection& connection);
+
+#ifdef RDWS_HAVE_IO_URING
+  private:
+    struct Buffer {
+        char* data = nullptr;
+        int slot = -1;  // index of the registered buffer, -1 for a heap buffer
+        std::unique_ptr<char[]> heap;
+    };
+
+    struct State {
+        int fd = -1;
+        Buffer receive;
+        // Output taken from the connection for the send in flight; replies produced
+        // meanwhile are appended to the connection's (swapped-in) output instead
+        std::string output;
+        size_t sent = 0;
+        bool receiving = false;
+        bool sending = false;
+        bool released = false;
+    };
+
+    StreamServer& server;
+    io_uring ring{};
+    std::unique_ptr<char[]> arena;
+    std::vector<int> freeSlots;
+    std::unordered_map<uint64_t, State> states;  // keyed by connection id
+    sockaddr_storage acceptAddress{};
+    socklen_t acceptAddressLength = 0;
+    uint64_t wakeValue = 0;
+
+    io_uring_sqe* nextSubmission();
+    void armAccept();
+    void armWake();
+    void armReceive(uint64_t connectionId, State& state);
+    void complete(uint64_t userData, int result);
+    void onAccepted(int result);
+    void onReceived(uint64_t connectionId, int result);
+    void onSent(uint64_t connectionId, int result);
+    void acquire(Buffer& buffer);
+    void retire(uint64_t connectionId);
+#endif
+};
+
+} // namespace rdws::server
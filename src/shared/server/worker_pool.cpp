@@ -0,0 +1,79 @@
+#include "worker_pool.h"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace rdws::server {
+
+WorkerPool::WorkerPool(const size_t workerCount, const HandlerFactory& factory) {
+    // Create every handler before starting threads so a failed connection aborts cleanly
+    std::vector<std::unique_ptr<RequestHandler>> handlers;
+    handlers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        auto handler = factory();
+        if (!handler) {
+            throw std::runtime_error("Failed to create handler for worker " + std::to_string(i));
+        }
+        handlers.push_back(std::move(handler));
+    }
+
+    workers.reserve(workerCount);
+    for (auto& handler : handlers) {
+        workers.emplace_back(&WorkerPool::workerLoop, this, std::move(handler));
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    shutdown();
+}
+
+void WorkerPool::submit(RequestJob job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) {
+            throw std::runtime_error("Worker pool is shutting down");
+        }
+        queue.push_back(std::move(job));
+    }
+    jobAvailable.notify_one();
+}
+
+void WorkerPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+size_t WorkerPool::resolveWorkerCount(const size_t requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 0 ? hardwareThreads : 1;
+}
+
+void WorkerPool::workerLoop(const std::unique_ptr<RequestHandler> handler) {
+    while (true) {
+        std::unique_lock<std::mutex> lock(mutex);
+        jobAvailable.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty()) {
+            return;
+        }
+        RequestJob job = std::move(queue.front());
+        queue.pop_front();
+        lock.unlock();
+
+        job.complete(invokeHandler(*handler, job.event, job.context));
+    }
+}
+
+} // namespace rdws::server
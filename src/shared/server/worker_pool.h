@@ -0,0 +1,69 @@
+#pragma once
+
+#include "request_executor.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rdws::server {
+
+/**
+ * WorkerPool - Fixed set of threads serving requests from one shared queue
+ *
+ * Every worker owns its own RequestHandler (and through it its own IDatabase
+ * connection and services), so no database handle is ever used by two threads.
+ * Idle workers take the next job from the queue as soon as it is submitted.
+ */
+class WorkerPool : public RequestExecutor {
+  public:
+    /**
+     * Builds the handler of one worker; returning nullptr aborts pool construction
+     */
+    using HandlerFactory = std::function<std::unique_ptr<RequestHandler>()>;
+
+  private:
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    std::deque<RequestJob> queue;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+
+  public:
+    /**
+     * @param workerCount Number of threads (and handlers) to start
+     * @param factory Called once per worker on the constructing thread
+     * @throws std::runtime_error when a handler cannot be created
+     */
+    WorkerPool(size_t workerCount, const HandlerFactory& factory);
+    ~WorkerPool() override;
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void submit(RequestJob job) override;
+
+    /**
+     * Let the workers finish the queued jobs, then join them
+     */
+    void shutdown() override;
+
+    [[nodiscard]] size_t getWorkerCount() const {
+        return workers.size();
+    }
+
+    /**
+     * Worker count for a requested value; 0 means one per hardware thread
+     */
+    static size_t resolveWorkerCount(size_t requested);
+
+  private:
+    void workerLoop(std::unique_ptr<RequestHandler> handler);
+};
+
+} // namespace rdws::server
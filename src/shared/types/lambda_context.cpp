@@ -25,16 +25,29 @@ LambdaContext::LambdaContext(std::string  requestId,
       memoryLimitMB_(memoryLimitMB) {
 }
 
-LambdaContext::LambdaContext(const std::string& jsonString) 
-    : startTime_(std::chrono::steady_clock::now()) {
-    
+// Helper function to parse the JSON representation of a context
+rapidjson::Document parseContextJson(const std::string& jsonString) {
     rapidjson::Document doc;
     doc.Parse(jsonString.c_str());
-    
-    if (doc.HasParseError()) {
+
+    if (doc.HasParseError() || !doc.IsObject()) {
         throw std::runtime_error("Invalid JSON in LambdaContext constructor");
     }
-    
+
+    return doc;
+}
+
+LambdaContext::LambdaContext(const std::string& jsonString)
+    : LambdaContext(parseContextJson(jsonString)) {
+}
+
+LambdaContext::LambdaContext(const rapidjson::Value& doc)
+    : startTime_(std::chrono::steady_clock::now()) {
+
+    if (!doc.IsObject()) {
+        throw std::runtime_error("Invalid JSON in LambdaContext constructor");
+    }
+
     // Set defaults
     requestId_ = "unknown";
     functionName_ = "unknown";
@@ -81,9 +94,11 @@ std::chrono::milliseconds LambdaContext::getElapsedTimeMs() const {
 void LambdaContext::log(const std::string& message, const std::string& level) const {
     const auto now = std::chrono::system_clock::now();
     const auto time_t = std::chrono::system_clock::to_time_t(now);
+    std::tm utc{};
+    gmtime_r(&time_t, &utc);  // std::gmtime shares a static buffer across worker threads
     
     std::ostringstream oss;
-    oss << "[" << std::put_time(std::gmtime(&time_t), "%Y-%m-%dT%H:%M:%SZ") << "] "
+    oss << "[" << std::put_time(&utc, "%Y-%m-%dT%H:%M:%SZ") << "] "
         << "[" << level << "] "
         << "[" << requestId_ << "] "
         << "[" << functionName_ << "] "
@@ -96,6 +111,10 @@ LambdaContext LambdaContext::fromJson(const std::string& jsonString) {
     return LambdaContext(jsonString);
 }
 
+LambdaContext LambdaContext::fromJsonValue(const rapidjson::Value& json) {
+    return LambdaContext(json);
+}
+
 std::string LambdaContext::toJson() const {
     rapidjson::Document doc;
     doc.SetObject();
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <chrono>
+#include <rapidjson/document.h>
 
 
 namespace rdws::types {
@@ -40,6 +41,12 @@ public:
      */
     explicit LambdaContext(const std::string& jsonString);
 
+    /**
+     * Constructor from an already parsed JSON object
+     * @param json JSON object representing the context
+     */
+    explicit LambdaContext(const rapidjson::Value& json);
+
     /**
      * Create LambdaContext from JSON string
      * @param jsonString JSON representation of context
@@ -47,6 +54,13 @@ public:
      */
     static LambdaContext fromJson(const std::string& jsonString);
 
+    /**
+     * Create LambdaContext from an already parsed JSON object
+     * @param json JSON object representing the context
+     * @return LambdaContext instance
+     */
+    static LambdaContext fromJsonValue(const rapidjson::Value& json);
+
     /**
      * Convert to JSON string
      * @return JSON representation of this context
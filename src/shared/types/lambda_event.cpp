@@ -4,6 +4,7 @@
 #include <sstream>
 #include <random>
 #include <regex>
+#include <stdexcept>
 #include <utility>
 #include <rapidjson/document.h>
 #include <rapidjson/writer.h>
@@ -65,15 +66,27 @@ LambdaEvent::LambdaEvent(const std::string& method, const std::string& path, con
     }
 }
 
-LambdaEvent::LambdaEvent(const std::string& jsonString) {
-    // Parse JSON string to reconstruct event
+// Helper function to parse the JSON representation of an event
+rapidjson::Document parseEventJson(const std::string& jsonString) {
     rapidjson::Document doc;
     doc.Parse(jsonString.c_str());
-    
-    if (doc.HasParseError()) {
+
+    if (doc.HasParseError() || !doc.IsObject()) {
         throw std::runtime_error("Invalid JSON in LambdaEvent constructor");
     }
-    
+
+    return doc;
+}
+
+LambdaEvent::LambdaEvent(const std::string& jsonString)
+    : LambdaEvent(parseEventJson(jsonString)) {
+}
+
+LambdaEvent::LambdaEvent(const rapidjson::Value& doc) {
+    if (!doc.IsObject()) {
+        throw std::runtime_error("Invalid JSON in LambdaEvent constructor");
+    }
+
     // Extract HTTP method and path
     if (doc.HasMember("httpMethod") && doc["httpMethod"].IsString()) {
         httpRequest_.method = doc["httpMethod"].GetString();
@@ -193,6 +206,10 @@ LambdaEvent LambdaEvent::fromJson(const std::string& jsonString) {
     return LambdaEvent(jsonString);
 }
 
+LambdaEvent LambdaEvent::fromJsonValue(const rapidjson::Value& json) {
+    return LambdaEvent(json);
+}
+
 std::string LambdaEvent::getHeader(const std::string& name) const {
     const auto it = httpRequest_.headers.find(name);
     return (it != httpRequest_.headers.end()) ? it->second : "";
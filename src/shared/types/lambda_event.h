@@ -68,6 +68,12 @@ public:
      */
     explicit LambdaEvent(const std::string& jsonString);
 
+    /**
+     * Constructor from an already parsed JSON object
+     * @param json JSON object representing the event
+     */
+    explicit LambdaEvent(const rapidjson::Value& json);
+
     /**
      * Constructor from command line arguments (backward compatibility)
      * @param argc Argument count
@@ -130,6 +136,13 @@ public:
      * @return LambdaEvent instance
      */
     static LambdaEvent fromJson(const std::string& jsonString);
+
+    /**
+     * Create LambdaEvent from an already parsed JSON object
+     * @param json JSON object representing the event
+     * @return LambdaEvent instance
+     */
+    static LambdaEvent fromJsonValue(const rapidjson::Value& json);
     
     /**
      * Convert to JSON string
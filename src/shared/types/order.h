@@ -1,6 +1,8 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <vector>
 #include <rapidjson/document.h>
 
 
@@ -33,4 +35,41 @@ public:
     bool operator!=(const Order& other) const;
 };
 
+// An order row read in place for listings written straight to JSON; the text points into
+// the database result and is only valid as long as that row
+struct OrderView {
+    int id = 0;
+    int userId = 0;
+    std::string_view product;
+    double amount = 0;
+    std::string_view status;
+    std::string_view createdAt;
+
+    // Same object as Order::toJson, written without building it first
+    template <typename Writer> void writeJson(Writer& writer) const {
+        writer.StartObject();
+        writer.Key("id");
+        writer.Int(id);
+        writer.Key("userId");
+        writer.Int(userId);
+        writer.Key("product");
+        writer.String(product.data(), static_cast<rapidjson::SizeType>(product.size()));
+        writer.Key("amount");
+        writer.Double(amount);
+        writer.Key("status");
+        writer.String(status.data(), static_cast<rapidjson::SizeType>(status.size()));
+        if (!createdAt.empty()) {
+            writer.Key("createdAt");
+            writer.String(createdAt.data(), static_cast<rapidjson::SizeType>(createdAt.size()));
+        }
+        writer.EndObject();
+    }
+};
+
+// One page of orders and the number of orders in total
+struct OrderPage {
+    std::vector<Order> orders;
+    size_t total = 0;
+};
+
 } // namespace rdws::types
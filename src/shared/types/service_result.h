@@ -11,6 +11,7 @@
 namespace rdws::types {
 class User;
 class Order;
+struct OrderPage;
 } // namespace rdws::types
 
 namespace rdws::types {
@@ -84,6 +85,7 @@ using UsersResult = ServiceResult<std::vector<rdws::types::User>>;
 // Specialized result types for Orders
 using OrderResult = ServiceResult<rdws::types::Order>;
 using OrdersResult = ServiceResult<std::vector<rdws::types::Order>>;
+using OrderPageResult = ServiceResult<rdws::types::OrderPage>;
 
 // General result types
 using CountResult = ServiceResult<size_t>;
@@ -4,6 +4,7 @@
 #include <json/json.h>
 #include <rapidjson/document.h>
 #include <string>
+#include <string_view>
 #include <utility>
 
 
@@ -48,5 +49,28 @@ struct User {
     }
 };
 
+// A user row read in place for listings written straight to JSON; the text points into the
+// database result and is only valid as long as that row
+struct UserView {
+    int id = 0;
+    std::string_view name;
+    std::string_view email;
+    std::string_view created_at;
+
+    // Same object as User::toJsonValue, written without building it first
+    template <typename Writer> void writeJson(Writer& writer) const {
+        writer.StartObject();
+        writer.Key("id");
+        writer.Int(id);
+        writer.Key("name");
+        writer.String(name.data(), static_cast<::rapidjson::SizeType>(name.size()));
+        writer.Key("email");
+        writer.String(email.data(), static_cast<::rapidjson::SizeType>(email.size()));
+        writer.Key("created_at");
+        writer.String(created_at.data(), static_cast<::rapidjson::SizeType>(created_at.size()));
+        writer.EndObject();
+    }
+};
+
 } // namespace rdws::types
 
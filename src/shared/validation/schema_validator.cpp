@@ -1,4 +1,5 @@
 #include "schema_validator.h"
+#include "../common/utils/startup_profile.h"
 #include "schemas.h"
 #include <filesystem>
 #include <fstream>
@@ -161,6 +162,14 @@ std::string SchemaValidator::getErrorsAsJson(const std::vector<ValidationError>&
     return Json::writeString(builder, result);
 }
 
+const SchemaValidator& LazySchemaValidator::get() const {
+    std::call_once(built, [this] {
+        const rdws::utils::StartupProfile::Scope scope("schema");
+        validator.emplace(factory());
+    });
+    return *validator;
+}
+
 // Factory functions for common validators
 namespace UserValidators {
 SchemaValidator createUserValidator() {
@@ -2,6 +2,8 @@
 
 #include <json/json.h>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <utility>
 #include <valijson/schema.hpp>
@@ -67,6 +69,31 @@ class SchemaValidator {
     }
 };
 
+/**
+ * LazySchemaValidator - SchemaValidator parsed on first use
+ * Keeps schema parsing off the startup path of routes that never validate (GETs, deletes).
+ */
+class LazySchemaValidator {
+  private:
+    SchemaValidator (*factory)();
+    mutable std::once_flag built;
+    mutable std::optional<SchemaValidator> validator;
+
+  public:
+    explicit LazySchemaValidator(SchemaValidator (*validatorFactory)())
+        : factory(validatorFactory) {}
+
+    [[nodiscard]] const SchemaValidator& get() const;
+
+    [[nodiscard]] std::vector<ValidationError> validate(const Json::Value& json) const {
+        return get().validate(json);
+    }
+
+    [[nodiscard]] std::vector<ValidationError> validate(const std::string& jsonString) const {
+        return get().validate(jsonString);
+    }
+};
+
 // Factory functions for common validators
 namespace UserValidators {
     SchemaValidator createUserValidator();
@@ -15,6 +15,9 @@ export interface Config {
   buildPath: string;
   environment: string;
   timeout: number;
+  transport: 'exec' | 'socket';
+  socketDir: string;
+  socketPath?: string;
 }
 
 // Service response from microservices
@@ -38,10 +41,21 @@ export interface ErrorResponse {
 }
 
 // Health check interfaces
+export interface HealthDatabase {
+  target: string;
+  circuit: string;
+  consecutiveFailures: number;
+  rejected: number;
+  retryInMs: number;
+  lastError: string;
+}
+
 export interface HealthService {
   status: 'healthy' | 'unhealthy';
   responseTime?: number;
   error?: string;
+  // Circuit breakers reported by the service's own /health
+  databases?: HealthDatabase[];
 }
 
 export interface HealthResponse {
@@ -52,6 +66,7 @@ export interface HealthResponse {
     environment: string;
     buildPath: string;
     timeout: number;
+    transport: 'exec' | 'socket';
   };
   services: Record<string, HealthService>;
 }
@@ -0,0 +1,94 @@
+#include "../../src/shared/async/task.h"
+
+#include <coroutine>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+using rdws::async::Detached;
+using rdws::async::Task;
+
+namespace {
+
+// Stands in for a database query: suspends until the test resumes it with a value
+struct ManualEvent {
+    std::coroutine_handle<> waiter;
+    int value = 0;
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        return false;
+    }
+    void await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        waiter = awaiting;
+    }
+    [[nodiscard]] int await_resume() const noexcept {
+        return value;
+    }
+
+    void complete(const int result) {
+        value = result;
+        std::exchange(waiter, {}).resume();
+    }
+};
+
+Task<int> immediate(const int value) {
+    co_return value;
+}
+
+Task<int> waitFor(ManualEvent& event) {
+    co_return co_await event * 2;
+}
+
+Task<int> failing() {
+    throw std::runtime_error("query failed");
+    co_return 0;
+}
+
+Task<std::string> describe(ManualEvent& event) {
+    const int first = co_await immediate(1);
+    const int second = co_await waitFor(event);
+    co_return std::to_string(first) + "+" + std::to_string(second);
+}
+
+Detached store(Task<std::string> task, std::string& out) {
+    out = co_await std::move(task);
+}
+
+Detached storeError(Task<int> task, std::string& out) {
+    try {
+        co_await std::move(task);
+        out = "no error";
+    } catch (const std::runtime_error& e) {
+        out = e.what();
+    }
+}
+
+} // namespace
+
+TEST(AsyncTaskTest, ResumesAwaiterWhenSuspendedChildCompletes) {
+    ManualEvent event;
+    std::string result;
+
+    store(describe(event), result);
+    EXPECT_TRUE(result.empty());
+    ASSERT_TRUE(event.waiter);
+
+    event.complete(21);
+    EXPECT_EQ(result, "1+42");
+}
+
+TEST(AsyncTaskTest, PropagatesExceptionsToAwaiter) {
+    std::string result;
+
+    storeError(failing(), result);
+    EXPECT_EQ(result, "query failed");
+}
+
+TEST(AsyncTaskTest, DestroysTaskThatWasNeverAwaited) {
+    ManualEvent event;
+    {
+        auto task = waitFor(event);
+    }
+    EXPECT_FALSE(event.waiter);
+}
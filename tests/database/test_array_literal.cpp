@@ -0,0 +1,23 @@
+#include "../../src/shared/common/database/array_literal.h"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using rdws::database::toArrayLiteral;
+
+TEST(ArrayLiteralTest, EncodesIntegers) {
+    EXPECT_EQ("{}", toArrayLiteral(std::vector<int>{}));
+    EXPECT_EQ("{1,-2,30}", toArrayLiteral(std::vector<int>{1, -2, 30}));
+}
+
+TEST(ArrayLiteralTest, QuotesEveryStringElement) {
+    EXPECT_EQ("{}", toArrayLiteral(std::vector<std::string>{}));
+    EXPECT_EQ(R"({"Ana","","NULL","a,b","{x}"})",
+              toArrayLiteral(std::vector<std::string>{"Ana", "", "NULL", "a,b", "{x}"}));
+}
+
+TEST(ArrayLiteralTest, EscapesQuotesAndBackslashes) {
+    EXPECT_EQ(R"({"O\"Neil","C:\\tmp"})",
+              toArrayLiteral(std::vector<std::string>{"O\"Neil", "C:\\tmp"}));
+}
@@ -0,0 +1,82 @@
+#include "../../src/shared/common/database/connection_breaker.h"
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+using rdws::database::ConnectionBreaker;
+using std::chrono::milliseconds;
+
+namespace {
+
+ConnectionBreaker::Options fastOptions() {
+    ConnectionBreaker::Options options;
+    options.baseDelay = milliseconds(20);
+    options.maxDelay = milliseconds(80);
+    return options;
+}
+
+} // namespace
+
+TEST(ConnectionBreakerTest, FailureOpensCircuitAndFailsFast) {
+    ConnectionBreaker breaker("db:5432/app", fastOptions());
+    ASSERT_TRUE(breaker.allowAttempt());
+    breaker.recordFailure("connection refused");
+
+    EXPECT_FALSE(breaker.allowAttempt());
+    EXPECT_FALSE(breaker.allowAttempt());
+
+    const auto status = breaker.status();
+    EXPECT_EQ(ConnectionBreaker::State::Open, status.state);
+    EXPECT_EQ(1u, status.consecutiveFailures);
+    EXPECT_EQ(2u, status.rejected);
+    EXPECT_EQ("connection refused", status.lastError);
+    EXPECT_LE(status.retryIn, milliseconds(20));
+}
+
+TEST(ConnectionBreakerTest, HalfOpenLetsOneProbeThrough) {
+    ConnectionBreaker breaker("db:5432/app", fastOptions());
+    ASSERT_TRUE(breaker.allowAttempt());
+    breaker.recordFailure("timeout");
+
+    std::this_thread::sleep_for(milliseconds(25));
+    EXPECT_TRUE(breaker.allowAttempt());
+    EXPECT_EQ(ConnectionBreaker::State::HalfOpen, breaker.status().state);
+    EXPECT_FALSE(breaker.allowAttempt());
+
+    breaker.recordSuccess();
+    EXPECT_EQ(ConnectionBreaker::State::Closed, breaker.status().state);
+    EXPECT_EQ(0u, breaker.status().consecutiveFailures);
+    EXPECT_TRUE(breaker.allowAttempt());
+}
+
+TEST(ConnectionBreakerTest, BackoffDoublesUpToMaxDelay) {
+    ConnectionBreaker breaker("db:5432/app", fastOptions());
+    for (int failure = 0; failure < 5; ++failure) {
+        breaker.allowAttempt();
+        breaker.recordFailure("down");
+    }
+
+    // 20, 40, 80, 80, 80 ms: the last delay is drawn from the upper half of the cap
+    const auto retryIn = breaker.status().retryIn;
+    EXPECT_GE(retryIn, milliseconds(35));
+    EXPECT_LE(retryIn, milliseconds(80));
+}
+
+TEST(ConnectionBreakerTest, SharedPerServerAndDatabase) {
+    rdws::Config config;
+    config.set("DB_HOST", "breaker-test");
+    config.set("DB_PORT", "5432");
+    config.set("DB_NAME", "app");
+    const auto first = ConnectionBreaker::forDatabase(config);
+    EXPECT_EQ(first, ConnectionBreaker::forDatabase(config));
+
+    config.set("DB_PORT", "5433");
+    EXPECT_NE(first, ConnectionBreaker::forDatabase(config));
+
+    bool listed = false;
+    for (const auto& status : ConnectionBreaker::processStatus()) {
+        listed = listed || status.target == "breaker-test:5432/app";
+    }
+    EXPECT_TRUE(listed);
+}
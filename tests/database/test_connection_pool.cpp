@@ -0,0 +1,304 @@
+#include "../../src/shared/common/database/postgresql_connection_pool.h"
+#include "../../src/shared/common/database/deadline.h"
+
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <thread>
+
+using rdws::database::DeadlineExceeded;
+using rdws::database::DeadlineScope;
+using rdws::database::IDatabase;
+using rdws::database::IResultSet;
+using rdws::database::PooledDatabase;
+using rdws::database::PostgreSQLConnectionPool;
+
+namespace {
+
+struct ConnectionLog {
+    std::atomic<int> opened{0};
+    std::atomic<int> rolledBack{0};
+    std::atomic<int> closed{0};
+    std::atomic<int> prepared{0};  // Statements prepared, summed over connections
+    std::atomic<int> pinged{0};
+};
+
+// Stands in for a PostgreSQLDatabase connection; only tracks what the pool does with it
+class FakeConnection : public IDatabase {
+  private:
+    ConnectionLog& log;
+    bool connected = true;
+    bool inTransaction = false;
+
+  public:
+    explicit FakeConnection(ConnectionLog& connectionLog) : log(connectionLog) {
+        ++log.opened;
+    }
+    ~FakeConnection() override {
+        ++log.closed;
+    }
+
+    std::unique_ptr<IResultSet> execQuery(const std::string&,
+                                          const std::vector<std::string>&) override {
+        throw std::runtime_error("not used");
+    }
+    bool execCommand(const std::string&, const std::vector<std::string>&) override {
+        return connected;
+    }
+    bool execBatch(const std::vector<std::string>&,
+                   const std::vector<std::vector<std::string>>&) override {
+        return connected;
+    }
+    void beginTransaction() override {
+        inTransaction = true;
+    }
+    void commitTransaction() override {
+        inTransaction = false;
+    }
+    void rollbackTransaction() override {
+        inTransaction = false;
+        ++log.rolledBack;
+    }
+    bool isConnected() override {
+        return connected;
+    }
+    bool ping() override {
+        ++log.pinged;
+        return connected;
+    }
+    void connect() override {
+        connected = true;
+    }
+    void disconnect() override {
+        connected = false;
+    }
+    std::string getLastError() override {
+        return "";
+    }
+    void prepareStatements(const std::vector<std::string>& statements) override {
+        log.prepared += static_cast<int>(statements.size());
+    }
+};
+
+std::shared_ptr<PostgreSQLConnectionPool> makePool(ConnectionLog& log,
+                                                   PostgreSQLConnectionPool::Options options) {
+    return std::make_shared<PostgreSQLConnectionPool>(
+        options, [&log] { return std::make_unique<FakeConnection>(log); });
+}
+
+PostgreSQLConnectionPool::Options sized(const size_t minSize, const size_t maxSize) {
+    PostgreSQLConnectionPool::Options options;
+    options.minSize = minSize;
+    options.maxSize = maxSize;
+    return options;
+}
+
+} // namespace
+
+TEST(ConnectionPoolTest, OpensMinimumUpFrontAndReusesReturnedConnections) {
+    ConnectionLog log;
+    const auto pool = makePool(log, sized(2, 4));
+    EXPECT_EQ(2, log.opened);
+
+    for (int i = 0; i < 10; ++i) {
+        const auto lease = pool->acquire();
+        EXPECT_TRUE(lease->execCommand("UPDATE t SET a = 1", {}));
+    }
+
+    const auto stats = pool->stats();
+    EXPECT_EQ(2, log.opened);
+    EXPECT_EQ(2u, stats.size);
+    EXPECT_EQ(0u, stats.inUse);
+    EXPECT_EQ(10u, stats.acquisitions);
+    EXPECT_EQ(0u, stats.waits);
+}
+
+TEST(ConnectionPoolTest, GrowsToMaximumThenTimesOut) {
+    ConnectionLog log;
+    auto options = sized(0, 2);
+    options.leaseTimeout = std::chrono::milliseconds(30);
+    const auto pool = makePool(log, options);
+
+    const auto first = pool->acquire();
+    const auto second = pool->acquire();
+    EXPECT_EQ(2, log.opened);
+    EXPECT_EQ(2u, pool->stats().inUse);
+
+    EXPECT_THROW(pool->acquire(), std::runtime_error);
+    const auto stats = pool->stats();
+    EXPECT_EQ(1u, stats.waits);
+    EXPECT_EQ(1u, stats.timeouts);
+    EXPECT_GE(stats.maxWaitMicros, 30000u);
+}
+
+TEST(ConnectionPoolTest, WaitEndsAtRequestDeadline) {
+    ConnectionLog log;
+    const auto pool = makePool(log, sized(1, 1));
+    const auto held = pool->acquire();
+
+    const DeadlineScope scope(std::chrono::milliseconds(30));
+    const auto before = std::chrono::steady_clock::now();
+    EXPECT_THROW(pool->acquire(), DeadlineExceeded);
+    EXPECT_LT(std::chrono::steady_clock::now() - before, std::chrono::seconds(1));
+    EXPECT_TRUE(scope.wasExceeded());
+    EXPECT_EQ(1u, pool->stats().timeouts);
+}
+
+TEST(ConnectionPoolTest, TryAcquireDoesNotWaitForExhaustedPool) {
+    ConnectionLog log;
+    const auto pool = makePool(log, sized(1, 1));
+
+    {
+        const auto held = pool->acquire();
+        EXPECT_EQ(nullptr, pool->tryAcquire());
+    }
+    EXPECT_NE(nullptr, pool->tryAcquire());
+
+    const auto stats = pool->stats();
+    EXPECT_EQ(1u, stats.busy);
+    EXPECT_EQ(0u, stats.waits);
+    EXPECT_EQ(0u, stats.timeouts);
+}
+
+TEST(ConnectionPoolTest, ConnectsInBackgroundAndRunsMaintenanceTask) {
+    ConnectionLog log;
+    auto options = sized(2, 4);
+    options.connectInBackground = true;
+    const auto pool = makePool(log, options);
+
+    std::atomic<int> runs{0};
+    pool->setMaintenanceTask([&runs] { ++runs; }, std::chrono::milliseconds(100));
+    std::this_thread::sleep_for(std::chrono::milliseconds(350));
+    EXPECT_EQ(2, log.opened);
+    EXPECT_GE(runs, 2);
+
+    // Once removed, the task is no longer run
+    pool->setMaintenanceTask({}, std::chrono::milliseconds(100));
+    const int removedAt = runs;
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    EXPECT_EQ(removedAt, runs);
+}
+
+TEST(ConnectionPoolTest, WaitingCallerGetsTheReturnedConnection) {
+    ConnectionLog log;
+    const auto pool = makePool(log, sized(1, 1));
+
+    auto held = pool->acquire();
+    std::thread releaser([&held] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        held.reset();
+    });
+
+    const auto lease = pool->acquire();
+    releaser.join();
+    EXPECT_TRUE(lease->isConnected());
+    EXPECT_EQ(1, log.opened);
+    EXPECT_EQ(1u, pool->stats().waits);
+}
+
+TEST(ConnectionPoolTest, ReleaseRollsBackOpenTransactionAndDropsBrokenConnection) {
+    ConnectionLog log;
+    const auto pool = makePool(log, sized(1, 1));
+
+    {
+        const auto lease = pool->acquire();
+        lease->beginTransaction();
+    }
+    EXPECT_EQ(1, log.rolledBack);
+    EXPECT_EQ(0, log.closed);
+
+    {
+        const auto lease = pool->acquire();
+        lease->disconnect();
+    }
+    EXPECT_EQ(1, log.closed);
+    EXPECT_EQ(0u, pool->stats().size);
+
+    // The freed slot is filled again on the next acquire
+    EXPECT_TRUE(pool->acquire()->isConnected());
+    EXPECT_EQ(2, log.opened);
+}
+
+TEST(ConnectionPoolTest, EvictsIdleConnectionsDownToMinimum) {
+    ConnectionLog log;
+    auto options = sized(1, 3);
+    options.idleTimeout = std::chrono::milliseconds(10);
+    const auto pool = makePool(log, options);
+
+    {
+        const auto first = pool->acquire();
+        const auto second = pool->acquire();
+        const auto third = pool->acquire();
+    }
+    EXPECT_EQ(3u, pool->stats().size);
+
+    for (int i = 0; i < 100 && pool->stats().size > 1; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(1u, pool->stats().size);
+    EXPECT_EQ(2, log.closed);
+}
+
+TEST(ConnectionPoolTest, PingsIdleConnectionsDueForHealthCheck) {
+    ConnectionLog log;
+    auto options = sized(1, 1);
+    options.healthCheckInterval = std::chrono::milliseconds(10);
+    const auto pool = makePool(log, options);
+
+    for (int i = 0; i < 100 && log.pinged == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_GE(log.pinged, 1);
+    EXPECT_EQ(1, log.opened);
+    EXPECT_EQ(0u, pool->stats().discarded);
+}
+
+TEST(ConnectionPoolTest, PooledDatabaseHoldsOneLeasePerTransaction) {
+    ConnectionLog log;
+    const auto pool = makePool(log, sized(0, 2));
+    PooledDatabase db(pool);
+
+    EXPECT_TRUE(db.execCommand("UPDATE t SET a = 1"));
+    EXPECT_EQ(0u, pool->stats().inUse);
+
+    db.beginTransaction();
+    EXPECT_EQ(1u, pool->stats().inUse);
+    EXPECT_TRUE(db.execCommand("UPDATE t SET a = 2"));
+    EXPECT_EQ(1u, pool->stats().inUse);
+    db.commitTransaction();
+
+    EXPECT_EQ(0u, pool->stats().inUse);
+    EXPECT_EQ(1, log.opened);
+    EXPECT_EQ(0, log.rolledBack);
+}
+
+TEST(ConnectionPoolTest, PreparesStatementsOnIdleAndLaterConnections) {
+    ConnectionLog log;
+    const auto pool = makePool(log, sized(1, 2));
+    PooledDatabase db(pool);
+
+    db.prepareStatements({"SELECT 1 FROM t WHERE id = $1", "DELETE FROM t WHERE id = $1"});
+    EXPECT_EQ(2, log.prepared);
+
+    const auto first = pool->acquire();
+    const auto second = pool->acquire();
+    EXPECT_EQ(2, log.opened);
+    EXPECT_EQ(4, log.prepared);
+}
+
+TEST(ConnectionPoolTest, AsyncStatementsShareOneLeaseUntilRead) {
+    ConnectionLog log;
+    const auto pool = makePool(log, sized(0, 2));
+    PooledDatabase db(pool);
+
+    auto first = db.execCommandAsync("UPDATE t SET a = 1");
+    auto second = db.execCommandAsync("UPDATE t SET a = 2");
+    EXPECT_EQ(1u, pool->stats().inUse);
+
+    EXPECT_TRUE(first.get());
+    EXPECT_EQ(1u, pool->stats().inUse);
+    EXPECT_TRUE(second.get());
+    EXPECT_EQ(0u, pool->stats().inUse);
+    EXPECT_EQ(1, log.opened);
+}
@@ -0,0 +1,122 @@
+#include "../../src/shared/common/database/deadline.h"
+
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+
+using rdws::database::DeadlineScope;
+using rdws::database::QueryWatchdog;
+using std::chrono::milliseconds;
+
+TEST(DeadlineTest, InnermostScopeApplies) {
+    EXPECT_FALSE(DeadlineScope::current().has_value());
+    {
+        const DeadlineScope outer(milliseconds(10000));
+        const auto outerDeadline = DeadlineScope::current();
+        ASSERT_TRUE(outerDeadline.has_value());
+        {
+            const DeadlineScope inner(milliseconds(100));
+            EXPECT_LT(*DeadlineScope::current(), *outerDeadline);
+            DeadlineScope::markExceeded();
+            EXPECT_TRUE(inner.wasExceeded());
+        }
+        EXPECT_EQ(outerDeadline, DeadlineScope::current());
+        EXPECT_FALSE(outer.wasExceeded());
+    }
+    EXPECT_FALSE(DeadlineScope::current().has_value());
+}
+
+TEST(DeadlineTest, ScopesArePerThread) {
+    const DeadlineScope scope(milliseconds(1000));
+    bool seen = true;
+    std::thread([&seen] { seen = DeadlineScope::current().has_value(); }).join();
+    EXPECT_FALSE(seen);
+}
+
+TEST(DeadlineTest, WatchdogCancelsAtDeadline) {
+    std::atomic<int> cancels{0};
+    const QueryWatchdog::Guard guard(std::chrono::steady_clock::now() + milliseconds(20),
+                                     [&cancels] { ++cancels; });
+    EXPECT_FALSE(guard.fired());
+
+    std::this_thread::sleep_for(milliseconds(100));
+    EXPECT_TRUE(guard.fired());
+    EXPECT_EQ(1, cancels.load());
+}
+
+TEST(DeadlineTest, FinishedStatementIsNotCanceled) {
+    std::atomic<int> cancels{0};
+    {
+        const QueryWatchdog::Guard guard(std::chrono::steady_clock::now() + milliseconds(30),
+                                         [&cancels] { ++cancels; });
+    }
+    // A later, sooner deadline must not wake the watchdog for the finished one
+    const QueryWatchdog::Guard other(std::chrono::steady_clock::now() + milliseconds(10), [] {});
+    std::this_thread::sleep_for(milliseconds(80));
+    EXPECT_TRUE(other.fired());
+    EXPECT_EQ(0, cancels.load());
+}
+
+TEST(DeadlineTest, SlowCancelHoldsUpOnlyItsOwnGuard) {
+    std::atomic<bool> cancelStarted{false};
+    std::atomic<bool> cancelFinished{false};
+    auto slow = std::make_unique<QueryWatchdog::Guard>(
+        std::chrono::steady_clock::now() + milliseconds(10), [&] {
+            cancelStarted = true;
+            std::this_thread::sleep_for(milliseconds(300));
+            cancelFinished = true;
+        });
+    while (!cancelStarted) {
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+
+    // Other statements start and finish while the cancel is still running
+    const auto start = std::chrono::steady_clock::now();
+    {
+        const QueryWatchdog::Guard other(std::chrono::steady_clock::now() + milliseconds(5000),
+                                         [] {});
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, milliseconds(100));
+    EXPECT_FALSE(cancelFinished.load());
+
+    slow.reset();
+    EXPECT_TRUE(cancelFinished.load());
+}
+
+TEST(DeadlineTest, ReleaseReturnsAtOnceDuringCancel) {
+    std::atomic<bool> cancelStarted{false};
+    std::atomic<bool> cancelFinished{false};
+    std::atomic<bool> settledAfterCancel{false};
+    auto guard = std::make_unique<QueryWatchdog::Guard>(
+        std::chrono::steady_clock::now() + milliseconds(10), [&] {
+            cancelStarted = true;
+            std::this_thread::sleep_for(milliseconds(200));
+            cancelFinished = true;
+        });
+    while (!cancelStarted) {
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(guard->release([&] { settledAfterCancel = cancelFinished.load(); }));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, milliseconds(100));
+
+    // Destroying the guard still waits for the cancel and its callback
+    guard.reset();
+    EXPECT_TRUE(settledAfterCancel.load());
+}
+
+TEST(DeadlineTest, ReleasedGuardIsNotCanceled) {
+    std::atomic<bool> canceled{false};
+    std::atomic<bool> settled{false};
+    {
+        QueryWatchdog::Guard guard(std::chrono::steady_clock::now() + milliseconds(20),
+                                   [&] { canceled = true; });
+        EXPECT_TRUE(guard.release([&] { settled = true; }));
+    }
+    std::this_thread::sleep_for(milliseconds(60));
+    EXPECT_FALSE(canceled.load());
+    EXPECT_FALSE(settled.load());
+}
@@ -0,0 +1,285 @@
+#include "../../src/shared/common/database/routing_database.h"
+#include "../mocks/mock_user_result_set.h"
+
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using rdws::database::IDatabase;
+using rdws::database::IResultSet;
+using rdws::database::PostgreSQLConnectionPool;
+using rdws::database::ReplicaSet;
+using rdws::database::RoutingDatabase;
+using rdws::testing::MockUserResultSet;
+
+namespace {
+
+using Rows = std::vector<std::map<std::string, std::string>>;
+
+// One database server: which statements reached it, and how far behind the primary it is
+struct Server {
+    std::atomic<int> lagMillis{0};
+    std::atomic<bool> up{true};
+    std::mutex mutex;
+    std::vector<std::string> statements;
+
+    void record(const std::string& sql) {
+        std::lock_guard<std::mutex> lock(mutex);
+        statements.push_back(sql);
+    }
+    size_t count() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return statements.size();
+    }
+};
+
+class FakeConnection : public IDatabase {
+  private:
+    Server& server;
+    bool connected = true;
+
+  public:
+    explicit FakeConnection(Server& target) : server(target) {
+        if (!server.up) {
+            throw std::runtime_error("connection refused");
+        }
+    }
+
+    std::unique_ptr<IResultSet> execQuery(const std::string& query,
+                                          const std::vector<std::string>&) override {
+        if (!server.up) {
+            connected = false;
+            throw std::runtime_error("server closed the connection");
+        }
+        if (query.find("pg_last_wal_replay_lsn") != std::string::npos) {
+            return std::make_unique<MockUserResultSet>(
+                Rows{{{"lag_ms", std::to_string(server.lagMillis.load())}}});
+        }
+        server.record(query);
+        return std::make_unique<MockUserResultSet>(Rows{{{"id", "1"}}});
+    }
+    bool execCommand(const std::string& command, const std::vector<std::string>&) override {
+        server.record(command);
+        return true;
+    }
+    bool execBatch(const std::vector<std::string>& commands,
+                   const std::vector<std::vector<std::string>>&) override {
+        for (const auto& command : commands) {
+            server.record(command);
+        }
+        return true;
+    }
+    void beginTransaction() override {}
+    void commitTransaction() override {}
+    void rollbackTransaction() override {}
+    bool isConnected() override {
+        return connected;
+    }
+    void connect() override {
+        connected = true;
+    }
+    void disconnect() override {
+        connected = false;
+    }
+    std::string getLastError() override {
+        return "";
+    }
+};
+
+std::shared_ptr<PostgreSQLConnectionPool> makePool(Server& server) {
+    PostgreSQLConnectionPool::Options options;
+    options.maxSize = 2;
+    options.connectInBackground = true;
+    return std::make_shared<PostgreSQLConnectionPool>(
+        options, [&server] { return std::make_unique<FakeConnection>(server); });
+}
+
+class RoutingDatabaseTest : public ::testing::Test {
+  protected:
+    Server primaryServer;
+    Server firstReplica;
+    Server secondReplica;
+    std::shared_ptr<ReplicaSet> replicas;
+
+    RoutingDatabase makeDatabase(ReplicaSet::Policy policy = ReplicaSet::Policy::RoundRobin) {
+        ReplicaSet::Options options;
+        options.policy = policy;
+        options.maxLag = std::chrono::milliseconds(1000);
+        options.lagCheckInterval = std::chrono::hours(1);  // Checked by the tests instead
+        replicas = std::make_shared<ReplicaSet>(
+            std::vector<ReplicaSet::Replica>{{"replica-1", makePool(firstReplica)},
+                                             {"replica-2", makePool(secondReplica)}},
+            options);
+        return RoutingDatabase(std::make_shared<FakeConnection>(primaryServer), replicas);
+    }
+};
+
+} // namespace
+
+TEST(RoutingQueryTest, OnlyPlainSelectsAreReadOnly) {
+    EXPECT_TRUE(RoutingDatabase::isReadOnlyQuery("SELECT * FROM orders"));
+    EXPECT_TRUE(RoutingDatabase::isReadOnlyQuery("  select id from orders where product = 'x'"));
+    EXPECT_TRUE(RoutingDatabase::isReadOnlyQuery("SELECT id FROM orders ORDER BY format"));
+    EXPECT_FALSE(RoutingDatabase::isReadOnlyQuery("SELECT id FROM orders FOR UPDATE"));
+    EXPECT_FALSE(RoutingDatabase::isReadOnlyQuery("select id from orders for  no key update"));
+    EXPECT_FALSE(RoutingDatabase::isReadOnlyQuery("SELECT id FROM orders FOR SHARE"));
+    EXPECT_FALSE(RoutingDatabase::isReadOnlyQuery("INSERT INTO orders VALUES (1) RETURNING id"));
+    EXPECT_FALSE(RoutingDatabase::isReadOnlyQuery("SELECTED"));
+}
+
+TEST_F(RoutingDatabaseTest, ReadsGoToReplicasRoundRobinAndWritesToPrimary) {
+    auto db = makeDatabase();
+
+    for (int i = 0; i < 4; ++i) {
+        db.execQuery("SELECT * FROM orders");
+    }
+    EXPECT_EQ(2u, firstReplica.count());
+    EXPECT_EQ(2u, secondReplica.count());
+
+    db.execQuery("SELECT * FROM orders WHERE id = $1 FOR UPDATE", {"1"});
+    EXPECT_TRUE(db.execCommand("UPDATE orders SET status = 'paid'"));
+    EXPECT_EQ(2u, primaryServer.count());
+    EXPECT_EQ(4u, firstReplica.count() + secondReplica.count());
+}
+
+TEST_F(RoutingDatabaseTest, ReadsInTransactionOrAfterWriteStayOnPrimary) {
+    auto db = makeDatabase();
+
+    db.beginTransaction();
+    db.execQuery("SELECT * FROM orders");
+    db.rollbackTransaction();
+    EXPECT_EQ(1u, primaryServer.count());
+
+    // A request must see its own write even before the replicas have it
+    EXPECT_TRUE(db.execCommand("INSERT INTO orders (product) VALUES ('x')"));
+    db.execQuery("SELECT * FROM orders");
+    EXPECT_EQ(3u, primaryServer.count());
+    EXPECT_EQ(0u, firstReplica.count() + secondReplica.count());
+}
+
+TEST_F(RoutingDatabaseTest, WritesThroughQueriesPinLaterReadsToPrimary) {
+    auto db = makeDatabase();
+
+    db.execQuery("INSERT INTO orders (product) VALUES ('x') RETURNING id");
+    db.execQuery("SELECT * FROM orders");
+    EXPECT_EQ(2u, primaryServer.count());
+
+    auto db2 = makeDatabase();
+    db2.execQuery("WITH moved AS (DELETE FROM orders RETURNING *) SELECT COUNT(*) FROM moved");
+    db2.execQuery("SELECT * FROM orders");
+    EXPECT_EQ(4u, primaryServer.count());
+    EXPECT_EQ(0u, firstReplica.count() + secondReplica.count());
+}
+
+TEST_F(RoutingDatabaseTest, ReadOnlyTransactionDoesNotPinLaterReadsToPrimary) {
+    auto db = makeDatabase();
+
+    db.beginReadOnlyTransaction();
+    db.execQuery("SELECT COUNT(*) FROM orders");
+    db.execQuery("SELECT * FROM orders");
+    db.commitTransaction();
+    EXPECT_EQ(2u, primaryServer.count());
+
+    db.execQuery("SELECT * FROM orders");
+    EXPECT_EQ(2u, primaryServer.count());
+    EXPECT_EQ(1u, firstReplica.count() + secondReplica.count());
+}
+
+TEST_F(RoutingDatabaseTest, SkipsReplicaBehindMaxLag) {
+    firstReplica.lagMillis = 5000;
+    auto db = makeDatabase(ReplicaSet::Policy::LeastLoaded);
+
+    for (int i = 0; i < 3; ++i) {
+        db.execQuery("SELECT * FROM orders");
+    }
+    EXPECT_EQ(0u, firstReplica.count());
+    EXPECT_EQ(3u, secondReplica.count());
+
+    secondReplica.lagMillis = 5000;
+    replicas->checkLag();
+    db.execQuery("SELECT * FROM orders");
+    EXPECT_EQ(1u, primaryServer.count());
+
+    firstReplica.lagMillis = 10;
+    replicas->checkLag();
+    db.execQuery("SELECT * FROM orders");
+    EXPECT_EQ(1u, firstReplica.count());
+}
+
+TEST_F(RoutingDatabaseTest, ExhaustedReplicaSendsReadToPrimaryWithoutWaiting) {
+    auto db = makeDatabase(ReplicaSet::Policy::LeastLoaded);
+    secondReplica.lagMillis = 5000;
+    replicas->checkLag();
+
+    // Both connections of the only usable replica are leased elsewhere
+    const auto first = replicas->acquire();
+    const auto second = replicas->acquire();
+    ASSERT_TRUE(first.connection && second.connection);
+
+    const auto startedAt = std::chrono::steady_clock::now();
+    db.execQuery("SELECT * FROM orders");
+    EXPECT_LT(std::chrono::steady_clock::now() - startedAt, std::chrono::milliseconds(100));
+    EXPECT_EQ(1u, primaryServer.count());
+    EXPECT_EQ(0u, firstReplica.count());
+}
+
+TEST_F(RoutingDatabaseTest, ReplicaDownAtStartupIsUsedOnceItAnswers) {
+    firstReplica.up = false;
+    auto db = makeDatabase();
+
+    db.execQuery("SELECT * FROM orders");
+    db.execQuery("SELECT * FROM orders");
+    EXPECT_EQ(2u, secondReplica.count());
+
+    firstReplica.up = true;
+    replicas->checkLag();
+    db.execQuery("SELECT * FROM orders");
+    db.execQuery("SELECT * FROM orders");
+    EXPECT_EQ(1u, firstReplica.count());
+}
+
+TEST(ReplicaSetTest, PoolMaintenanceThreadChecksLag) {
+    Server replica;
+    replica.lagMillis = 5000;
+    ReplicaSet::Options options;
+    options.lagCheckInterval = std::chrono::milliseconds(100);
+    ReplicaSet replicas({{"replica-1", makePool(replica)}}, options);
+    EXPECT_FALSE(replicas.acquire().connection);
+
+    replica.lagMillis = 0;
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    EXPECT_TRUE(replicas.acquire().connection);
+}
+
+TEST_F(RoutingDatabaseTest, FailedReplicaReadIsRetriedOnPrimary) {
+    auto db = makeDatabase();
+    firstReplica.up = false;
+    secondReplica.up = false;
+
+    const auto result = db.execQuery("SELECT * FROM orders");
+    ASSERT_TRUE(result->next());
+    EXPECT_EQ(1u, primaryServer.count());
+}
+
+TEST_F(RoutingDatabaseTest, AsyncReadsShareOneReplicaUntilRead) {
+    auto db = makeDatabase();
+
+    {
+        auto count = db.execQueryAsync("SELECT COUNT(*) FROM orders");
+        auto page = db.execQueryAsync("SELECT * FROM orders LIMIT 20");
+        ASSERT_TRUE(count.get()->next());
+        ASSERT_TRUE(page.get()->next());
+    }
+    EXPECT_EQ(2u, firstReplica.count());
+    EXPECT_EQ(0u, secondReplica.count());
+
+    auto next = db.execQueryAsync("SELECT * FROM orders");
+    ASSERT_TRUE(next.get()->next());
+    EXPECT_EQ(1u, secondReplica.count());
+}
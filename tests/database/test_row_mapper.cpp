@@ -0,0 +1,109 @@
+#include "../../src/shared/common/database/row_mapper.h"
+#include "../mocks/mock_order_result_set.h"
+
+#include <gtest/gtest.h>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using rdws::database::RowMapper;
+using rdws::testing::MockOrderResultSet;
+
+namespace {
+
+using Rows = std::vector<std::map<std::string, std::string>>;
+
+struct Shipment {
+    int id = 0;
+    std::string carrier;
+    double weight = 0;
+    bool delivered = false;
+    std::optional<std::string> note;
+};
+
+// Counts row fetches to show a row costs one call, however many fields it has
+class CountingResultSet : public MockOrderResultSet {
+  public:
+    using MockOrderResultSet::MockOrderResultSet;
+    int rowFetches = 0;
+
+    void getRowText(const size_t* columns, const size_t count,
+                    std::optional<std::string_view>* fields) override {
+        ++rowFetches;
+        MockOrderResultSet::getRowText(columns, count, fields);
+    }
+};
+
+} // namespace
+
+namespace rdws::database {
+
+template <> struct RowDescriptor<Shipment> {
+    static constexpr auto fields =
+        std::make_tuple(column<WireType::Integer>("id", &Shipment::id),
+                        column<WireType::Text>("carrier", &Shipment::carrier),
+                        column<WireType::Float>("weight", &Shipment::weight),
+                        column<WireType::Boolean>("delivered", &Shipment::delivered),
+                        column<WireType::Text>("note", &Shipment::note));
+};
+
+} // namespace rdws::database
+
+TEST(RowMapperTest, ColumnListFollowsDescriptor) {
+    EXPECT_EQ("id, carrier, weight, delivered, note", RowMapper<Shipment>::columnList());
+}
+
+TEST(RowMapperTest, DecodesEveryWireType) {
+    CountingResultSet result(Rows{{{"id", "12"},
+                                   {"carrier", "Post"},
+                                   {"weight", "2.75"},
+                                   {"delivered", "t"},
+                                   {"note", "Fragile"}},
+                                  {{"id", "13"},
+                                   {"carrier", "Courier"},
+                                   {"weight", "0.5"},
+                                   {"delivered", "f"},
+                                   {"note", "Leave at door"}}});
+    RowMapper<Shipment> mapper;
+
+    ASSERT_TRUE(result.next());
+    const auto first = mapper.read(result);
+    EXPECT_EQ(12, first.id);
+    EXPECT_EQ("Post", first.carrier);
+    EXPECT_DOUBLE_EQ(2.75, first.weight);
+    EXPECT_TRUE(first.delivered);
+    EXPECT_EQ(std::optional<std::string>("Fragile"), first.note);
+
+    ASSERT_TRUE(result.next());
+    const auto second = mapper.read(result);
+    EXPECT_EQ(13, second.id);
+    EXPECT_FALSE(second.delivered);
+    EXPECT_EQ(2, result.rowFetches);
+}
+
+TEST(RowMapperTest, NullFillsOptionalAndRejectsOthers) {
+    MockOrderResultSet result(Rows{
+        {{"id", "1"}, {"carrier", "Post"}, {"weight", "1"}, {"delivered", "t"}, {"note", ""}},
+        {{"id", "2"}, {"carrier", "Post"}, {"weight", "1"}, {"delivered", "t"}},
+        {{"id", "3"}, {"weight", "1"}, {"delivered", "t"}, {"note", ""}}});
+    RowMapper<Shipment> mapper;
+
+    ASSERT_TRUE(result.next());
+    EXPECT_EQ(std::optional<std::string>(""), mapper.read(result).note);
+    ASSERT_TRUE(result.next());
+    EXPECT_EQ(std::nullopt, mapper.read(result).note);
+    ASSERT_TRUE(result.next());
+    EXPECT_THROW(mapper.read(result), std::runtime_error);
+}
+
+TEST(RowMapperTest, MalformedNumberThrows) {
+    MockOrderResultSet result(Rows{
+        {{"id", "12a"}, {"carrier", "Post"}, {"weight", "1"}, {"delivered", "t"}, {"note", ""}}});
+    RowMapper<Shipment> mapper;
+
+    ASSERT_TRUE(result.next());
+    EXPECT_THROW(mapper.read(result), std::runtime_error);
+}
@@ -0,0 +1,99 @@
+#include "../../src/shared/common/database/statement_stats.h"
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using rdws::database::fingerprintStatement;
+using rdws::database::LatencyHistogram;
+using rdws::database::StatementMetrics;
+using rdws::database::StatementRecorder;
+using std::chrono::microseconds;
+
+TEST(StatementStatsTest, FingerprintReplacesLiteralsAndCollapsesWhitespace) {
+    EXPECT_EQ("SELECT * FROM orders WHERE id = ? AND status = ?",
+              fingerprintStatement("SELECT *\n  FROM orders WHERE id = 42 AND status = 'it''s'"));
+    EXPECT_EQ("SELECT amount FROM orders WHERE amount > ? LIMIT ?",
+              fingerprintStatement("SELECT amount FROM orders WHERE amount > 12.50 LIMIT 20 "));
+}
+
+TEST(StatementStatsTest, FingerprintKeepsPlaceholdersAndIdentifiers) {
+    EXPECT_EQ(R"(SELECT "col1", t2.x FROM t2 WHERE id = $1)",
+              fingerprintStatement(R"(SELECT "col1", t2.x FROM t2 WHERE id = $1)"));
+}
+
+TEST(StatementStatsTest, HistogramBucketsStayWithinOneEighth) {
+    for (const uint64_t micros : {0ULL, 7ULL, 8ULL, 100ULL, 1234ULL, 999999ULL, 123456789ULL}) {
+        const auto index = LatencyHistogram::bucketIndex(micros);
+        const auto upper = LatencyHistogram::bucketUpperBound(index);
+        EXPECT_GE(upper, micros);
+        EXPECT_LE(upper - micros, micros / 8) << micros;
+    }
+}
+
+TEST(StatementStatsTest, HistogramPercentiles) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(0u, histogram.percentileMicros(0.5));
+
+    for (int i = 1; i <= 100; ++i) {
+        histogram.record(microseconds(i * 100));
+    }
+    EXPECT_EQ(100u, histogram.getCount());
+    EXPECT_EQ(10000u, histogram.getMaxMicros());
+    EXPECT_NEAR(5000, histogram.percentileMicros(0.50), 5000 / 8);
+    EXPECT_NEAR(9900, histogram.percentileMicros(0.99), 9900 / 8);
+    EXPECT_EQ(10000u, histogram.percentileMicros(1.0));
+}
+
+TEST(StatementStatsTest, RecordsFromManyThreads) {
+    LatencyHistogram histogram;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&histogram] {
+            for (int i = 0; i < 1000; ++i) {
+                histogram.record(microseconds(i));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(4000u, histogram.getCount());
+    EXPECT_EQ(999u, histogram.getMaxMicros());
+}
+
+TEST(StatementStatsTest, StatementsDifferingInLiteralsShareOneEntry) {
+    auto& first = StatementMetrics::forStatement("SELECT name FROM users WHERE id = 1");
+    auto& second = StatementMetrics::forStatement("SELECT name  FROM users WHERE id = 2");
+    EXPECT_EQ(&first, &second);
+    EXPECT_EQ("SELECT name FROM users WHERE id = ?", first.fingerprint);
+
+    first.latency.record(microseconds(250));
+    bool found = false;
+    for (const auto& summary : StatementMetrics::snapshot()) {
+        if (summary.fingerprint == first.fingerprint) {
+            found = true;
+            EXPECT_EQ(1u, summary.calls);
+            EXPECT_EQ(250u, summary.maxMicros);
+        }
+    }
+    EXPECT_TRUE(found);
+}
+
+TEST(StatementStatsTest, RecorderAddsToTheSharedEntry) {
+    StatementRecorder recorder(1, std::chrono::milliseconds(0));
+    const std::string sql = "SELECT email FROM users WHERE name = $1";
+    recorder.record(sql, 1, microseconds(100), false, 2, 40);
+    recorder.record(sql, 1, microseconds(300), true, 0, 0);
+    // Past the capacity the entry is looked up again, still the same one
+    recorder.record("SELECT  email FROM users WHERE name = $1", 1, microseconds(200), false, 1,
+                    20);
+
+    const auto& stats = StatementMetrics::forStatement(sql);
+    EXPECT_EQ(3u, stats.latency.getCount());
+    EXPECT_EQ(1u, stats.errors.load());
+    EXPECT_EQ(3u, stats.rows.load());
+    EXPECT_EQ(60u, stats.bytes.load());
+}
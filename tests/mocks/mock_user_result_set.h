@@ -3,6 +3,7 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <string_view>
 
 namespace rdws {
 namespace testing {
@@ -40,6 +41,13 @@ public:
     bool getBool(const std::string& columnName) override {
         return rows_[currentRow_][columnName] == "true";
     }
+    // Views into the stored rows, which outlive them as PostgreSQL results do
+    std::string_view getStringView(const std::string& columnName) override {
+        return rows_[currentRow_][columnName];
+    }
+    std::string_view getStringViewAt(size_t column) override {
+        return getStringView(getColumnNames().at(column));
+    }
     bool isNull(const std::string& columnName) override {
         return rows_[currentRow_].find(columnName) == rows_[currentRow_].end();
     }
@@ -0,0 +1,58 @@
+#include "../../src/services/orders/order_routes.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+using rdws::services::orders::OrderRoute;
+using rdws::services::orders::routeOrderRequest;
+using rdws::types::LambdaContext;
+using rdws::types::LambdaEvent;
+
+namespace {
+
+OrderRoute route(LambdaEvent& event) {
+    const LambdaContext context{"req", "orders_service"};
+    return routeOrderRequest(event, context);
+}
+
+OrderRoute route(const std::string& method, const std::string& path,
+                 const std::string& body = "") {
+    LambdaEvent event(method, path, body);
+    return route(event);
+}
+
+} // namespace
+
+TEST(OrderRoutesTest, ResolvesEveryRoute) {
+    EXPECT_EQ(OrderRoute::Action::List, route("GET", "/orders").action);
+    EXPECT_EQ(OrderRoute::Action::Count, route("GET", "/orders/count").action);
+    EXPECT_EQ(OrderRoute::Action::Create, route("POST", "/orders", "{}").action);
+
+    const auto byUser = route("GET", "/users/3/orders");
+    EXPECT_EQ(OrderRoute::Action::ByUser, byUser.action);
+    EXPECT_EQ(3, byUser.id);
+    EXPECT_EQ(OrderRoute::Action::Get, route("GET", "/orders/9").action);
+    EXPECT_EQ(OrderRoute::Action::Update, route("PUT", "/orders/9", "{}").action);
+    EXPECT_EQ(OrderRoute::Action::Delete, route("DELETE", "/orders/9").action);
+}
+
+TEST(OrderRoutesTest, ReadsPageBounds) {
+    LambdaEvent event("GET", "/orders");
+    event.setQueryParameter("limit", "20");
+    event.setQueryParameter("offset", "40");
+    const auto page = route(event);
+    EXPECT_EQ(OrderRoute::Action::Page, page.action);
+    EXPECT_EQ(20, page.limit);
+    EXPECT_EQ(40, page.offset);
+
+    LambdaEvent invalid("GET", "/orders");
+    invalid.setQueryParameter("limit", "many");
+    EXPECT_EQ(400, route(invalid).rejection.statusCode);
+}
+
+TEST(OrderRoutesTest, RejectsBadRequests) {
+    EXPECT_EQ(400, route("GET", "/orders/abc").rejection.statusCode);
+    EXPECT_EQ(400, route("GET", "/users/abc/orders").rejection.statusCode);
+    EXPECT_EQ(400, route("PUT", "/orders/9").rejection.statusCode);
+    EXPECT_EQ(405, route("PATCH", "/orders/9", "{}").rejection.statusCode);
+}
@@ -67,6 +67,42 @@ TEST_F(OrderServiceUnitTest, GetAllOrders_ControllerFormatsJsonCorrectly) {
     EXPECT_TRUE(json.find("success") != std::string::npos) << "JSON should indicate success";
 }
 
+// Test that the streamed listing writes the same orders as the DOM built from getAllOrders
+TEST_F(OrderServiceUnitTest, ForEachOrder_ListingMatchesOrdersResponse) {
+    using ::testing::Return;
+
+    std::vector<std::map<std::string, std::string>> mockRows = {{{"id", "1"},
+                                                                 {"user_id", "1"},
+                                                                 {"product", "Laptop \"Pro\""},
+                                                                 {"amount", "2500.5"},
+                                                                 {"status", "completed"},
+                                                                 {"created_at", "2023-01-01"}},
+                                                                {{"id", "2"},
+                                                                 {"user_id", "2"},
+                                                                 {"product", "Mouse"},
+                                                                 {"amount", "150"},
+                                                                 {"status", "pending"},
+                                                                 {"created_at", ""}}};
+
+    EXPECT_CALL(*mockDb, execQuery(testing::HasSubstr("SELECT"), testing::IsEmpty()))
+        .WillOnce(Return(std::make_unique<rdws::testing::MockOrderResultSet>(mockRows)))
+        .WillOnce(Return(std::make_unique<rdws::testing::MockOrderResultSet>(mockRows)));
+
+    rdws::utils::JsonListWriter orders;
+    const auto result = orderService->forEachOrder(
+        [&orders](const rdws::types::OrderView& order) { orders.add(order); });
+    ASSERT_TRUE(result.isSuccess());
+    EXPECT_EQ(2u, result.getData());
+
+    rapidjson::Document listing;
+    listing.Parse(orderController->formatOrdersListing(result, orders).c_str());
+    rapidjson::Document expected;
+    expected.Parse(orderController->formatOrdersResponse(orderService->getAllOrders()).c_str());
+    ASSERT_FALSE(listing.HasParseError());
+    EXPECT_TRUE(listing["orders"] == expected["orders"]);
+    EXPECT_EQ(2, listing["total"].GetInt());
+}
+
 // Test getOrderById with valid ID
 TEST_F(OrderServiceUnitTest, GetOrderById_ValidId_ReturnsOrder) {
     using ::testing::Return;
@@ -118,6 +154,49 @@ TEST_F(OrderServiceUnitTest, GetOrderCount_ReturnsCorrectCount) {
     EXPECT_EQ(5, result.getData()) << "Should return correct count";
 }
 
+// Test getOrdersByUserId for a user without orders, whether or not the user exists
+TEST_F(OrderServiceUnitTest, GetOrdersByUserId_NoOrders_ReturnsEmptyList) {
+    using ::testing::Return;
+
+    std::vector<std::map<std::string, std::string>> noRows;
+
+    EXPECT_CALL(*mockDb, execQuery(testing::HasSubstr("FROM orders"), testing::ElementsAre("7")))
+        .WillOnce(Return(std::make_unique<rdws::testing::MockOrderResultSet>(noRows)));
+
+    auto result = orderService->getOrdersByUserId(7);
+
+    EXPECT_TRUE(result.isSuccess()) << "Service should return success";
+    EXPECT_EQ(200, result.getStatusCode());
+    EXPECT_TRUE(result.getData().empty()) << "Should return no orders";
+}
+
+// Test getOrdersPage returns the page and the overall total
+TEST_F(OrderServiceUnitTest, GetOrdersPage_ReturnsPageAndTotal) {
+    using ::testing::Return;
+
+    std::vector<std::map<std::string, std::string>> countRows = {{{"total", "42"}}};
+    std::vector<std::map<std::string, std::string>> pageRows = {{{"id", "3"},
+                                                                 {"user_id", "1"},
+                                                                 {"product", "Laptop"},
+                                                                 {"amount", "2500.00"},
+                                                                 {"status", "completed"},
+                                                                 {"created_at", "2023-01-03"}}};
+
+    EXPECT_CALL(*mockDb, execQuery(testing::HasSubstr("COUNT"), testing::IsEmpty()))
+        .WillOnce(Return(std::make_unique<rdws::testing::MockOrderResultSet>(countRows)));
+    EXPECT_CALL(*mockDb, execQuery(testing::HasSubstr("LIMIT"), testing::ElementsAre("1", "2")))
+        .WillOnce(Return(std::make_unique<rdws::testing::MockOrderResultSet>(pageRows)));
+
+    auto result = orderService->getOrdersPage(1, 2);
+
+    ASSERT_TRUE(result.isSuccess()) << "Service should return success";
+    EXPECT_EQ(42, result.getData().total);
+    ASSERT_EQ(1, result.getData().orders.size());
+    EXPECT_EQ(3, result.getData().orders[0].id);
+
+    EXPECT_EQ(400, orderService->getOrdersPage(0, 0).getStatusCode());
+}
+
 // Test createOrder with valid JSON
 TEST_F(OrderServiceUnitTest, CreateOrder_ValidData_CreatesOrder) {
     using ::testing::_;
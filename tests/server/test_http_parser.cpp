@@ -0,0 +1,107 @@
+#include "../../src/shared/server/http_parser.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+using rdws::server::HttpParser;
+using rdws::server::HttpParseStatus;
+using rdws::server::HttpRequest;
+
+TEST(HttpParserTest, ParsesRequestWithBody) {
+    const std::string raw = "POST /users?limit=5 HTTP/1.1\r\n"
+                            "Host: localhost\r\n"
+                            "Content-Type: application/json\r\n"
+                            "Content-Length: 13\r\n"
+                            "\r\n"
+                            R"({"name":"a"}x)";
+
+    HttpRequest request;
+    const auto result = HttpParser::parse(raw, request);
+
+    ASSERT_EQ(result.status, HttpParseStatus::Complete);
+    EXPECT_EQ(result.consumed, raw.size());
+    EXPECT_EQ(request.method, "POST");
+    EXPECT_EQ(request.target, "/users?limit=5");
+    EXPECT_EQ(request.getHeader("content-type"), "application/json");
+    EXPECT_EQ(request.body, R"({"name":"a"}x)");
+    EXPECT_TRUE(request.keepAlive);
+}
+
+TEST(HttpParserTest, WaitsForCompleteHeadersAndBody) {
+    HttpRequest request;
+    EXPECT_EQ(HttpParser::parse("GET /users HTTP/1.1\r\nHost: x\r\n", request).status,
+              HttpParseStatus::Incomplete);
+    EXPECT_EQ(HttpParser::parse("POST /users HTTP/1.1\r\nContent-Length: 10\r\n\r\n{}", request)
+                  .status,
+              HttpParseStatus::Incomplete);
+}
+
+TEST(HttpParserTest, ConsumesOnlyFirstPipelinedRequest) {
+    const std::string first = "GET /users/1 HTTP/1.1\r\n\r\n";
+    const std::string raw = first + "GET /users/2 HTTP/1.1\r\n\r\n";
+
+    HttpRequest request;
+    const auto result = HttpParser::parse(raw, request);
+
+    ASSERT_EQ(result.status, HttpParseStatus::Complete);
+    EXPECT_EQ(result.consumed, first.size());
+    EXPECT_EQ(request.target, "/users/1");
+}
+
+TEST(HttpParserTest, HonoursConnectionHeader) {
+    HttpRequest request;
+    HttpParser::parse("GET / HTTP/1.1\r\nConnection: close\r\n\r\n", request);
+    EXPECT_FALSE(request.keepAlive);
+
+    HttpParser::parse("GET / HTTP/1.0\r\n\r\n", request);
+    EXPECT_FALSE(request.keepAlive);
+
+    HttpParser::parse("GET / HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n", request);
+    EXPECT_TRUE(request.keepAlive);
+}
+
+TEST(HttpParserTest, RejectsMalformedRequests) {
+    HttpRequest request;
+
+    auto result = HttpParser::parse("GARBAGE\r\n\r\n", request);
+    EXPECT_EQ(result.status, HttpParseStatus::Error);
+    EXPECT_EQ(result.errorStatus, 400);
+
+    result = HttpParser::parse("POST / HTTP/1.1\r\nContent-Length: abc\r\n\r\n", request);
+    EXPECT_EQ(result.errorStatus, 400);
+
+    result = HttpParser::parse("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n", request);
+    EXPECT_EQ(result.errorStatus, 501);
+
+    result = HttpParser::parse("POST / HTTP/1.1\r\nContent-Length: 99999999999\r\n\r\n", request);
+    EXPECT_EQ(result.errorStatus, 413);
+
+    result = HttpParser::parse(std::string(HttpParser::maxHeaderBytes + 1, 'a'), request);
+    EXPECT_EQ(result.errorStatus, 431);
+}
+
+TEST(HttpParserTest, FormatsResponseWithContentLength) {
+    const auto response = HttpParser::formatResponse(404, R"({"error":"x"})", true);
+
+    EXPECT_EQ(response.rfind("HTTP/1.1 404 Not Found\r\n", 0), 0u);
+    EXPECT_NE(response.find("Content-Length: 13\r\n"), std::string::npos);
+    EXPECT_NE(response.find("Connection: keep-alive\r\n\r\n"), std::string::npos);
+}
+
+TEST(HttpParserTest, BuildsLambdaEventFromRequest) {
+    HttpRequest request;
+    HttpParser::parse("GET /users/42?verbose=1 HTTP/1.1\r\n"
+                      "User-Agent: curl/8\r\n"
+                      "X-Request-Id: req-9\r\n"
+                      "\r\n",
+                      request);
+
+    const auto event = rdws::server::toLambdaEvent(request, "10.0.0.1");
+
+    EXPECT_EQ(event.getHttpMethod(), "GET");
+    EXPECT_EQ(event.getPath(), "/users/42");
+    EXPECT_EQ(event.getQueryParameter("verbose"), "1");
+    EXPECT_EQ(event.getHeader("user-agent"), "curl/8");
+    EXPECT_EQ(event.getRequestContext().sourceIp, "10.0.0.1");
+    EXPECT_EQ(event.getRequestContext().requestId, "req-9");
+}
@@ -0,0 +1,142 @@
+#include "../../src/shared/server/listener_handoff.h"
+#include "../../src/shared/server/stream_server.h"
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using rdws::server::ListenerHandoff;
+using rdws::server::StreamServer;
+
+namespace {
+
+// Echoes every chunk back from another thread after a delay, like a slow handler
+class DelayedEchoServer : public StreamServer {
+  public:
+    using StreamServer::StreamServer;
+
+  protected:
+    void onData(Connection& connection) override {
+        const int fd = connection.fd;
+        const uint64_t id = connection.id;
+        std::string data = std::move(connection.input);
+        connection.input.clear();
+        ++connection.pendingResponses;
+
+        std::thread([this, fd, id, data = std::move(data)] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            post([this, fd, id, data] {
+                if (Connection* target = findConnection(fd, id)) {
+                    --target->pendingResponses;
+                    target->output += data;
+                    flushConnection(*target);
+                }
+            });
+        }).detach();
+    }
+};
+
+std::string offerPath(const std::string& name) {
+    return "/tmp/rdws_handoff_" + name + "_" + std::to_string(::getpid()) + ".sock";
+}
+
+uint16_t boundPort(const int fd) {
+    sockaddr_in address{};
+    socklen_t length = sizeof(address);
+    getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length);
+    return ntohs(address.sin_port);
+}
+
+int connectTo(const uint16_t port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Everything the peer sends until it closes the connection
+std::string readUntilClosed(const int fd) {
+    std::string data;
+    char chunk[256];
+    ssize_t received = 0;
+    while ((received = ::recv(fd, chunk, sizeof(chunk), 0)) > 0) {
+        data.append(chunk, static_cast<size_t>(received));
+    }
+    return data;
+}
+
+} // namespace
+
+TEST(ListenerHandoffTest, TakeOverWithoutPredecessorReturnsNoListener) {
+    EXPECT_EQ(-1, ListenerHandoff::takeOver(offerPath("absent")));
+}
+
+TEST(ListenerHandoffTest, SuccessorReceivesTheSameListeningSocket) {
+    const std::string path = offerPath("transfer");
+    const int listener = StreamServer::listenTcp("127.0.0.1", 0);
+    std::atomic<bool> notified{false};
+
+    {
+        ListenerHandoff handoff(path, listener, [&notified] { notified = true; });
+
+        const int received = ListenerHandoff::takeOver(path);
+        ASSERT_GE(received, 0);
+        EXPECT_NE(listener, received);
+        EXPECT_EQ(boundPort(listener), boundPort(received));
+
+        // A connection made now is queued on the shared socket and accepted by the successor
+        const int client = connectTo(boundPort(received));
+        ASSERT_GE(client, 0);
+        const int accepted = ::accept(received, nullptr, nullptr);
+        EXPECT_GE(accepted, 0);
+
+        for (int i = 0; i < 100 && !notified; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        EXPECT_TRUE(notified);
+        EXPECT_TRUE(handoff.wasHandedOff());
+
+        ::close(accepted);
+        ::close(client);
+        ::close(received);
+    }
+    ::close(listener);
+}
+
+TEST(ListenerHandoffTest, DrainAnswersBusyConnectionsAndClosesIdleOnes) {
+    const int listener = StreamServer::listenTcp("127.0.0.1", 0);
+    const uint16_t port = boundPort(listener);
+    DelayedEchoServer server(listener);
+
+    const int idle = connectTo(port);
+    const int busy = connectTo(port);
+    ASSERT_GE(idle, 0);
+    ASSERT_GE(busy, 0);
+
+    std::thread loop([&server] { server.run(); });
+    // Let the loop accept both connections before the request arrives
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(5, ::send(busy, "hello", 5, MSG_NOSIGNAL));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    server.drain();
+    EXPECT_EQ("", readUntilClosed(idle));
+    EXPECT_EQ("hello", readUntilClosed(busy));
+    loop.join();
+
+    EXPECT_EQ(0u, server.getConnectionCount());
+    ::close(idle);
+    ::close(busy);
+}
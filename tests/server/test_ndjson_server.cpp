@@ -0,0 +1,81 @@
+#include "../../src/shared/server/ndjson_server.h"
+
+#include <gtest/gtest.h>
+#include <rapidjson/document.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Echoes the routed method and path so tests can check what reached the handler
+class EchoHandler : public rdws::server::RequestHandler {
+  public:
+    std::vector<std::string> requestIds;
+
+    rdws::server::HandlerResponse handle(rdws::types::LambdaEvent& event,
+                                         const rdws::types::LambdaContext& context) override {
+        requestIds.push_back(context.getRequestId());
+        return {R"({"method":")" + event.getHttpMethod() + R"(","path":")" + event.getPath() +
+                    "\"}",
+                0};
+    }
+};
+
+rapidjson::Document parse(const std::string& json) {
+    rapidjson::Document doc;
+    doc.Parse(json.c_str());
+    return doc;
+}
+
+} // namespace
+
+TEST(NdjsonServerTest, WritesOneResponseLinePerFrame) {
+    EchoHandler handler;
+    rdws::server::NdjsonServer server(handler);
+
+    std::istringstream in(
+        R"({"event":{"httpMethod":"GET","path":"/users"},"context":{"requestId":"r1"}})"
+        "\n"
+        R"({"event":{"httpMethod":"DELETE","path":"/users/7"},"context":{"requestId":"r2"}})"
+        "\n");
+    std::ostringstream out;
+
+    EXPECT_EQ(2u, server.run(in, out));
+
+    std::istringstream lines(out.str());
+    std::string first;
+    std::string second;
+    ASSERT_TRUE(std::getline(lines, first));
+    ASSERT_TRUE(std::getline(lines, second));
+
+    EXPECT_STREQ("/users", parse(first)["path"].GetString());
+    EXPECT_STREQ("DELETE", parse(second)["method"].GetString());
+    EXPECT_EQ((std::vector<std::string>{"r1", "r2"}), handler.requestIds);
+}
+
+TEST(NdjsonServerTest, SkipsBlankLines) {
+    EchoHandler handler;
+    rdws::server::NdjsonServer server(handler);
+
+    std::istringstream in("\n\r\n" R"({"event":{"path":"/orders"},"context":{}})" "\n\n");
+    std::ostringstream out;
+
+    EXPECT_EQ(1u, server.run(in, out));
+    EXPECT_EQ(1u, handler.requestIds.size());
+}
+
+TEST(NdjsonServerTest, MalformedFrameProducesErrorResponse) {
+    EchoHandler handler;
+    rdws::server::NdjsonServer server(handler);
+
+    const auto parseError = parse(server.handleFrame("{not json"));
+    EXPECT_FALSE(parseError["success"].GetBool());
+    EXPECT_EQ(400, parseError["statusCode"].GetInt());
+
+    const auto missingContext = parse(server.handleFrame(R"({"event":{"path":"/users"}})"));
+    EXPECT_FALSE(missingContext["success"].GetBool());
+    EXPECT_EQ(500, missingContext["statusCode"].GetInt());
+
+    EXPECT_TRUE(handler.requestIds.empty());
+}
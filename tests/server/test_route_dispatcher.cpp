@@ -0,0 +1,101 @@
+#include "../../src/shared/server/route_dispatcher.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <rapidjson/document.h>
+#include <string>
+#include <utility>
+
+using rdws::server::HandlerResponse;
+using rdws::server::MetricsRegistry;
+using rdws::server::RouteDispatcher;
+
+namespace {
+
+// Replies with its own name so tests can see which service was selected
+class NamedHandler : public rdws::server::RequestHandler {
+  public:
+    std::string name;
+    int statusCode;
+
+    explicit NamedHandler(std::string handlerName, const int status = 200)
+        : name(std::move(handlerName)), statusCode(status) {}
+
+    HandlerResponse handle(rdws::types::LambdaEvent&, const rdws::types::LambdaContext&) override {
+        return {name, statusCode >= 400 ? 1 : 0, statusCode};
+    }
+};
+
+class RouteDispatcherTest : public ::testing::Test {
+  protected:
+    std::shared_ptr<MetricsRegistry> metrics = std::make_shared<MetricsRegistry>();
+    RouteDispatcher dispatcher{metrics};
+    rdws::types::LambdaContext context{"req", "rdws_server"};
+
+    void SetUp() override {
+        auto users = std::make_shared<NamedHandler>("users");
+        auto orders = std::make_shared<NamedHandler>("orders", 404);
+        dispatcher.addRoute("/users/{userId}/orders", orders);
+        dispatcher.addRoute("/users", users);
+        dispatcher.addRoute("/users/{id}", users);
+        dispatcher.addRoute("/orders/{id}", orders);
+    }
+
+    HandlerResponse dispatch(const std::string& method, const std::string& path) {
+        rdws::types::LambdaEvent event(method, path);
+        return dispatcher.handle(event, context);
+    }
+};
+
+} // namespace
+
+TEST_F(RouteDispatcherTest, SelectsFirstMatchingPattern) {
+    EXPECT_EQ("users", dispatch("GET", "/users").body);
+    EXPECT_EQ("users", dispatch("GET", "/users/").body);
+    EXPECT_EQ("users", dispatch("GET", "/users/42").body);
+    EXPECT_EQ("orders", dispatch("GET", "/users/42/orders").body);
+    EXPECT_EQ("orders", dispatch("DELETE", "/orders/7?force=1").body);
+}
+
+TEST_F(RouteDispatcherTest, UnknownRouteIsNotFound) {
+    const auto response = dispatch("GET", "/products/1");
+
+    EXPECT_EQ(404, response.statusCode);
+    EXPECT_EQ(1, response.exitCode);
+}
+
+TEST_F(RouteDispatcherTest, RecordsMetricsPerPattern) {
+    dispatch("GET", "/users/1");
+    dispatch("GET", "/users/2");
+    dispatch("GET", "/orders/3");
+
+    const auto stats = metrics->snapshot();
+    ASSERT_EQ(2u, stats.size());
+    EXPECT_EQ(2u, stats.at("/users/{id}").requests);
+    EXPECT_EQ(0u, stats.at("/users/{id}").clientErrors);
+    EXPECT_EQ(1u, stats.at("/orders/{id}").clientErrors);
+}
+
+TEST_F(RouteDispatcherTest, ServesMetricsEndpoint) {
+    dispatch("GET", "/users");
+
+    const auto response = dispatch("GET", "/metrics");
+    rapidjson::Document doc;
+    doc.Parse(response.body.c_str());
+
+    ASSERT_FALSE(doc.HasParseError());
+    EXPECT_EQ(200, response.statusCode);
+    EXPECT_EQ(1u, doc["data"]["totalRequests"].GetUint64());
+    EXPECT_TRUE(doc["data"]["statements"].IsArray());
+}
+
+TEST_F(RouteDispatcherTest, ServesHealthEndpoint) {
+    const auto response = dispatch("GET", "/health");
+    rapidjson::Document doc;
+    doc.Parse(response.body.c_str());
+
+    ASSERT_FALSE(doc.HasParseError());
+    EXPECT_EQ(200, response.statusCode);
+    EXPECT_STREQ("ok", doc["data"]["status"].GetString());
+    EXPECT_TRUE(doc["data"]["databases"].IsArray());
+}
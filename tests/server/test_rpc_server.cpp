@@ -0,0 +1,180 @@
+#include "../../src/shared/server/rpc_server.h"
+#include "../../src/shared/server/worker_pool.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+using rdws::server::InlineExecutor;
+using rdws::server::IoBackend;
+using rdws::server::RpcFrameHeader;
+using rdws::server::RpcServer;
+using rdws::server::WorkerPool;
+
+namespace {
+
+// Answers with the request path and a status taken from the method
+class PathHandler : public rdws::server::RequestHandler {
+  public:
+    rdws::server::HandlerResponse handle(rdws::types::LambdaEvent& event,
+                                         const rdws::types::LambdaContext&) override {
+        return {R"({"path":")" + event.getPath() + "\"}", 0, event.isPost() ? 201 : 200};
+    }
+};
+
+std::string requestFrame(const uint32_t requestId, const std::string& method,
+                         const std::string& path) {
+    std::string frame;
+    RpcServer::appendFrame(frame, requestId, 0,
+                           R"({"event":{"httpMethod":")" + method + R"(","path":")" + path +
+                               R"("},"context":{"requestId":"t"}})");
+    return frame;
+}
+
+std::string readExactly(const int fd, const size_t length) {
+    std::string data(length, '\0');
+    size_t received = 0;
+    while (received < length) {
+        const ssize_t n = ::recv(fd, data.data() + received, length - received, 0);
+        if (n <= 0) {
+            break;
+        }
+        received += static_cast<size_t>(n);
+    }
+    data.resize(received);
+    return data;
+}
+
+std::string socketPath(const std::string& name) {
+    return "/tmp/rdws_rpc_" + name + "_" + std::to_string(::getpid()) + ".sock";
+}
+
+int connectTo(const std::string& path) {
+    const int client = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    path.copy(address.sun_path, path.size());
+    if (::connect(client, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(client);
+        return -1;
+    }
+    return client;
+}
+
+// Sends two pipelined frames and checks both responses, in whatever order they complete
+void exchangeTwoFrames(RpcServer& server, const std::string& path) {
+    const int client = connectTo(path);
+    ASSERT_GE(client, 0);
+
+    // The listening socket queues the connection and the kernel buffers the frames
+    const std::string frames =
+        requestFrame(7, "GET", "/users") + requestFrame(9, "POST", "/orders");
+    ASSERT_EQ(static_cast<ssize_t>(frames.size()),
+              ::send(client, frames.data(), frames.size(), MSG_NOSIGNAL));
+
+    std::thread loop([&server] { server.run(); });
+
+    for (int i = 0; i < 2; ++i) {
+        const auto header = RpcFrameHeader::decode(readExactly(client, RpcFrameHeader::size));
+        const auto body = readExactly(client, header.payloadLength);
+        if (header.requestId == 7) {
+            EXPECT_EQ(200u, header.status);
+            EXPECT_EQ(R"({"path":"/users"})", body);
+        } else {
+            EXPECT_EQ(9u, header.requestId);
+            EXPECT_EQ(201u, header.status);
+            EXPECT_EQ(R"({"path":"/orders"})", body);
+        }
+    }
+
+    ::close(client);
+    server.stop();
+    loop.join();
+}
+
+} // namespace
+
+TEST(RpcServerTest, HeaderRoundTrip) {
+    std::string bytes;
+    RpcFrameHeader{42, 0xDEADBEEF, 504}.encodeTo(bytes);
+
+    ASSERT_EQ(RpcFrameHeader::size, bytes.size());
+    EXPECT_EQ('\0', bytes[0]);
+    EXPECT_EQ(42, bytes[3]);
+
+    const auto header = RpcFrameHeader::decode(bytes);
+    EXPECT_EQ(42u, header.payloadLength);
+    EXPECT_EQ(0xDEADBEEFu, header.requestId);
+    EXPECT_EQ(504u, header.status);
+}
+
+TEST(RpcServerTest, AnswersPipelinedRequestsOverUnixSocket) {
+    const std::string path = socketPath("inline");
+    InlineExecutor executor(std::make_unique<PathHandler>());
+    RpcServer server(rdws::server::StreamServer::listenUnix(path), executor);
+
+    exchangeTwoFrames(server, path);
+    ::unlink(path.c_str());
+}
+
+TEST(RpcServerTest, AnswersRequestsFromWorkerPool) {
+    const std::string path = socketPath("pool");
+    WorkerPool pool(3, [] { return std::make_unique<PathHandler>(); });
+    RpcServer server(rdws::server::StreamServer::listenUnix(path), pool);
+
+    exchangeTwoFrames(server, path);
+    pool.shutdown();
+    ::unlink(path.c_str());
+}
+
+TEST(RpcServerTest, AnswersRequestsOnIoUringBackend) {
+    const std::string path = socketPath("uring");
+    InlineExecutor executor(std::make_unique<PathHandler>());
+
+    if (!rdws::server::StreamServer::ioUringAvailable()) {
+        EXPECT_THROW(RpcServer(rdws::server::StreamServer::listenUnix(path), executor,
+                               IoBackend::IoUring),
+                     std::runtime_error);
+        ::unlink(path.c_str());
+        return;
+    }
+
+    RpcServer server(rdws::server::StreamServer::listenUnix(path), executor, IoBackend::IoUring);
+    exchangeTwoFrames(server, path);
+    ::unlink(path.c_str());
+}
+
+TEST(RpcServerTest, MalformedPayloadReturnsBadRequest) {
+    const std::string path = socketPath("bad");
+    InlineExecutor executor(std::make_unique<PathHandler>());
+    RpcServer server(rdws::server::StreamServer::listenUnix(path), executor);
+
+    const int client = connectTo(path);
+    ASSERT_GE(client, 0);
+    std::string frames;
+    RpcServer::appendFrame(frames, 1, 0, "{not json");
+    RpcServer::appendFrame(frames, 2, 0, R"({"event":{"path":"/users"}})");
+    ASSERT_EQ(static_cast<ssize_t>(frames.size()),
+              ::send(client, frames.data(), frames.size(), MSG_NOSIGNAL));
+
+    std::thread loop([&server] { server.run(); });
+
+    const auto parseError = RpcFrameHeader::decode(readExactly(client, RpcFrameHeader::size));
+    readExactly(client, parseError.payloadLength);
+    EXPECT_EQ(1u, parseError.requestId);
+    EXPECT_EQ(400u, parseError.status);
+
+    const auto missingContext = RpcFrameHeader::decode(readExactly(client, RpcFrameHeader::size));
+    EXPECT_EQ(2u, missingContext.requestId);
+    EXPECT_EQ(500u, missingContext.status);
+
+    ::close(client);
+    server.stop();
+    loop.join();
+    ::unlink(path.c_str());
+}
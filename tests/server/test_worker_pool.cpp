@@ -0,0 +1,151 @@
+#include "../../src/shared/server/health_check.h"
+#include "../../src/shared/server/worker_pool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <gtest/gtest.h>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using rdws::server::HandlerResponse;
+using rdws::server::HealthCheckExecutor;
+using rdws::server::RequestJob;
+using rdws::server::WorkerPool;
+
+namespace {
+
+// Counts handled requests; /throw simulates a failing service
+class RecordingHandler : public rdws::server::RequestHandler {
+  public:
+    std::atomic<int>& handled;
+
+    explicit RecordingHandler(std::atomic<int>& counter) : handled(counter) {}
+
+    HandlerResponse handle(rdws::types::LambdaEvent& event,
+                           const rdws::types::LambdaContext&) override {
+        if (event.getPath() == "/throw") {
+            throw std::runtime_error("boom");
+        }
+        ++handled;
+        return {R"({"ok":true})", 0, 200};
+    }
+};
+
+struct Completions {
+    std::mutex mutex;
+    std::condition_variable done;
+    std::multiset<std::string> bodies;
+    std::set<std::thread::id> threads;
+    int statusSum = 0;
+    size_t count = 0;
+
+    std::function<void(HandlerResponse)> callback() {
+        return [this](HandlerResponse response) {
+            std::lock_guard<std::mutex> lock(mutex);
+            bodies.insert(response.body);
+            threads.insert(std::this_thread::get_id());
+            statusSum += response.statusCode;
+            ++count;
+            done.notify_all();
+        };
+    }
+
+    void waitFor(const size_t expected) {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return count >= expected; });
+    }
+};
+
+RequestJob job(const std::string& path, Completions& completions) {
+    return RequestJob{rdws::types::LambdaEvent("GET", path),
+                      rdws::types::LambdaContext("req", "test"), completions.callback()};
+}
+
+} // namespace
+
+TEST(WorkerPoolTest, CreatesOneHandlerPerWorker) {
+    std::atomic<int> handled{0};
+    int created = 0;
+    WorkerPool pool(4, [&] {
+        ++created;
+        return std::make_unique<RecordingHandler>(handled);
+    });
+
+    EXPECT_EQ(4, created);
+    EXPECT_EQ(4u, pool.getWorkerCount());
+}
+
+TEST(WorkerPoolTest, RunsEveryJobOffTheSubmittingThread) {
+    std::atomic<int> handled{0};
+    Completions completions;
+    {
+        WorkerPool pool(3, [&] { return std::make_unique<RecordingHandler>(handled); });
+        for (int i = 0; i < 200; ++i) {
+            pool.submit(job("/users", completions));
+        }
+        completions.waitFor(200);
+    }
+
+    EXPECT_EQ(200, handled.load());
+    EXPECT_EQ(200u, completions.count);
+    EXPECT_EQ(0u, completions.threads.count(std::this_thread::get_id()));
+    EXPECT_LE(completions.threads.size(), 3u);
+}
+
+TEST(WorkerPoolTest, HandlerExceptionBecomesServiceError) {
+    std::atomic<int> handled{0};
+    Completions completions;
+    WorkerPool pool(1, [&] { return std::make_unique<RecordingHandler>(handled); });
+
+    pool.submit(job("/throw", completions));
+    completions.waitFor(1);
+
+    EXPECT_EQ(500, completions.statusSum);
+    EXPECT_NE(std::string::npos, completions.bodies.begin()->find("boom"));
+}
+
+TEST(WorkerPoolTest, FailedHandlerCreationThrows) {
+    EXPECT_THROW(WorkerPool(2, [] { return std::unique_ptr<rdws::server::RequestHandler>(); }),
+                 std::runtime_error);
+}
+
+TEST(WorkerPoolTest, ShutdownDrainsQueuedJobs) {
+    std::atomic<int> handled{0};
+    Completions completions;
+    WorkerPool pool(2, [&] { return std::make_unique<RecordingHandler>(handled); });
+
+    for (int i = 0; i < 50; ++i) {
+        pool.submit(job("/users", completions));
+    }
+    pool.shutdown();
+
+    EXPECT_EQ(50, handled.load());
+    EXPECT_THROW(pool.submit(job("/users", completions)), std::runtime_error);
+}
+
+TEST(WorkerPoolTest, ResolvesZeroToHardwareThreads) {
+    EXPECT_EQ(5u, WorkerPool::resolveWorkerCount(5));
+    EXPECT_GE(WorkerPool::resolveWorkerCount(0), 1u);
+}
+
+TEST(WorkerPoolTest, HealthCheckIsAnsweredAheadOfTheHandlers) {
+    std::atomic<int> handled{0};
+    Completions completions;
+    HealthCheckExecutor executor(std::make_unique<WorkerPool>(
+        1, [&] { return std::make_unique<RecordingHandler>(handled); }));
+
+    executor.submit(job("/health", completions));
+    EXPECT_EQ(1u, completions.count);
+    EXPECT_EQ(1u, completions.threads.count(std::this_thread::get_id()));
+    EXPECT_NE(std::string::npos, completions.bodies.begin()->find("databases"));
+
+    executor.submit(job("/users", completions));
+    executor.shutdown();
+    EXPECT_EQ(1, handled.load());
+    EXPECT_EQ(2u, completions.count);
+}
@@ -0,0 +1,50 @@
+#include "../../src/services/users/user_routes.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+using rdws::types::LambdaContext;
+using rdws::types::LambdaEvent;
+using rdws::users::routeUserRequest;
+using rdws::users::UserRoute;
+
+namespace {
+
+UserRoute route(const std::string& method, const std::string& path,
+                const std::string& body = "") {
+    LambdaEvent event(method, path, body);
+    const LambdaContext context{"req", "users_service"};
+    return routeUserRequest(event, context);
+}
+
+} // namespace
+
+TEST(UserRoutesTest, ResolvesEveryRoute) {
+    EXPECT_EQ(UserRoute::Action::List, route("GET", "/users").action);
+    EXPECT_EQ(UserRoute::Action::Count, route("GET", "/users/count").action);
+    EXPECT_EQ(UserRoute::Action::Create, route("POST", "/users", "{}").action);
+
+    const auto get = route("GET", "/users/7");
+    EXPECT_EQ(UserRoute::Action::Get, get.action);
+    EXPECT_EQ(7, get.userId);
+    EXPECT_EQ(UserRoute::Action::Update, route("PUT", "/users/7", "{}").action);
+    EXPECT_EQ(UserRoute::Action::Delete, route("DELETE", "/users/7").action);
+}
+
+TEST(UserRoutesTest, RejectsBadIdsAndMissingBodies) {
+    const auto get = route("GET", "/users/abc");
+    EXPECT_EQ(UserRoute::Action::Rejected, get.action);
+    EXPECT_EQ(400, get.rejection.statusCode);
+    EXPECT_NE(std::string::npos, get.rejection.body.find("/users/abc"));
+
+    EXPECT_EQ(400, route("DELETE", "/users/abc").rejection.statusCode);
+    EXPECT_EQ(400, route("POST", "/users").rejection.statusCode);
+    EXPECT_EQ(400, route("PUT", "/users/7").rejection.statusCode);
+}
+
+TEST(UserRoutesTest, RejectsUnsupportedMethods) {
+    const auto patch = route("PATCH", "/users/7", "{}");
+    EXPECT_EQ(UserRoute::Action::Rejected, patch.action);
+    EXPECT_EQ(405, patch.rejection.statusCode);
+    EXPECT_EQ(405, route("DELETE", "/users").rejection.statusCode);
+}
@@ -113,6 +113,38 @@ TEST_F(UserServiceUnitTest, GetAllUsers_ControllerFormatsJsonCorrectly) {
     EXPECT_FALSE(extractJsonValue(json, "timestamp").empty()) << "Should include timestamp";
 }
 
+// Test that the streamed listing writes the same users as the DOM built from getAllUsers
+TEST_F(UserServiceUnitTest, ForEachUser_ListingMatchesUsersResponse) {
+    using ::testing::_;
+    using ::testing::Return;
+
+    std::vector<std::map<std::string, std::string>> mockRows = {{{"id", "1"},
+                                                                 {"name", "John \"Jr\" Doe"},
+                                                                 {"email", "john@example.com"},
+                                                                 {"created_at", "2023-01-01"}},
+                                                                {{"id", "2"},
+                                                                 {"name", "Jane Smith"},
+                                                                 {"email", "jane@example.com"},
+                                                                 {"created_at", "2023-01-02"}}};
+
+    EXPECT_CALL(*mockDb, execQuery("SELECT id, name, email, created_at FROM users ORDER BY id", _))
+        .WillOnce(Return(std::make_unique<rdws::testing::MockUserResultSet>(mockRows)))
+        .WillOnce(Return(std::make_unique<rdws::testing::MockUserResultSet>(mockRows)));
+
+    rdws::utils::JsonListWriter users;
+    const auto result = userService->forEachUser(
+        [&users](const rdws::types::UserView& user) { users.add(user); });
+    ASSERT_TRUE(result.isSuccess());
+
+    rapidjson::Document listing;
+    listing.Parse(userController->formatUsersListing(result, users).c_str());
+    rapidjson::Document expected;
+    expected.Parse(userController->formatUsersResponse(userService->getAllUsers()).c_str());
+    ASSERT_FALSE(listing.HasParseError());
+    EXPECT_TRUE(listing["users"] == expected["users"]);
+    EXPECT_EQ(2, listing["total"].GetInt());
+}
+
 // Test getUserById with valid ID
 TEST_F(UserServiceUnitTest, GetUserById_ValidId_ReturnsUser) {
     using ::testing::_;